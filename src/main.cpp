@@ -1,3 +1,4 @@
+#include <string_view>
 #include "common/project_macros.hpp"
 #include "tg/data/hashing/superfasthash_detail.hpp"
 #include "tg/data/hashing/fnv1a_detail.hpp"
@@ -5,10 +6,18 @@
 #include "tg/facade/facade_common.hpp"
 #include "tg/facade/subgraph.hpp"
 #include "tg/core/test_case/test_case_main.hpp"
+#include "tg/data/test_case/flat_hash_benchmark.hpp"
+#include "tg/data/test_case/flat_hash_check.hpp"
 
 int main(int argc, char** argv)
 {
     // facade_demo();
+    if (argc > 1 && std::string_view{argv[1]} == "--bench-flat-hash")
+    {
+        flat_hash_benchmark();
+        return 0;
+    }
     test_case_main();
+    flat_hash_check();
     return 0;
 }
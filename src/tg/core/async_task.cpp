@@ -0,0 +1,149 @@
+#include <condition_variable>
+#include "tg/core/async_task.hpp"
+
+namespace tg::core
+{
+
+AsyncCompletion::AsyncCompletion()
+    : m_function{nullptr}
+    , m_context{nullptr}
+    , m_index{0u}
+{
+}
+
+AsyncCompletion::AsyncCompletion(Function function, void* context, std::size_t index)
+    : m_function{function}
+    , m_context{context}
+    , m_index{index}
+{
+}
+
+AsyncCompletion::AsyncCompletion(AsyncCompletion&& other) noexcept
+    : m_function{other.m_function}
+    , m_context{other.m_context}
+    , m_index{other.m_index}
+{
+    other.m_function = nullptr;
+}
+
+AsyncCompletion& AsyncCompletion::operator=(AsyncCompletion&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_function)
+        {
+            this->invoke(std::make_exception_ptr(
+                std::runtime_error("AsyncCompletion: operation was abandoned.")));
+        }
+        m_function = other.m_function;
+        m_context = other.m_context;
+        m_index = other.m_index;
+        other.m_function = nullptr;
+    }
+    return *this;
+}
+
+AsyncCompletion::~AsyncCompletion()
+{
+    if (m_function)
+    {
+        this->invoke(std::make_exception_ptr(
+            std::runtime_error("AsyncCompletion: operation was abandoned.")));
+    }
+}
+
+void AsyncCompletion::complete()
+{
+    if (!m_function)
+    {
+        throw std::logic_error("AsyncCompletion::complete(): already completed.");
+    }
+    this->invoke(nullptr);
+}
+
+void AsyncCompletion::fail(std::exception_ptr error)
+{
+    if (!m_function)
+    {
+        throw std::logic_error("AsyncCompletion::fail(): already completed.");
+    }
+    if (!error)
+    {
+        error = std::make_exception_ptr(std::runtime_error("AsyncCompletion: operation failed."));
+    }
+    this->invoke(error);
+}
+
+AsyncCompletion::operator bool() const
+{
+    return m_function != nullptr;
+}
+
+void AsyncCompletion::invoke(std::exception_ptr error)
+{
+    Function function = m_function;
+    m_function = nullptr;
+    function(m_context, m_index, error);
+}
+
+AsyncTask::AsyncTask()
+    : Task{TaskKind::Async}
+{
+}
+
+AsyncTask::~AsyncTask()
+{
+}
+
+void AsyncTask::on_execute()
+{
+    struct Waiter
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        std::exception_ptr error;
+
+        static void signal(void* context, std::size_t /* index */, std::exception_ptr error)
+        {
+            auto* waiter = static_cast<Waiter*>(context);
+            std::unique_lock<std::mutex> lock(waiter->mutex);
+            waiter->error = error;
+            waiter->done = true;
+            waiter->cv.notify_all();
+        }
+    };
+    Waiter waiter;
+    std::exception_ptr sync_error;
+    {
+        /**
+         * @note If the task neither completes nor moves out the handle,
+         * the handle is abandoned at the end of this scope.
+         */
+        AsyncCompletion completion{&Waiter::signal, &waiter, 0u};
+        try
+        {
+            this->on_execute_async(completion);
+        }
+        catch (...)
+        {
+            sync_error = std::current_exception();
+            if (completion)
+            {
+                completion.fail(sync_error);
+            }
+        }
+    }
+    std::unique_lock<std::mutex> lock(waiter.mutex);
+    waiter.cv.wait(lock, [&waiter]() { return waiter.done; });
+    if (sync_error)
+    {
+        std::rethrow_exception(sync_error);
+    }
+    if (waiter.error)
+    {
+        std::rethrow_exception(waiter.error);
+    }
+}
+
+} // namespace tg::core
@@ -0,0 +1,97 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+#include "tg/core/task.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief One-shot handle through which an AsyncTask reports completion.
+ *
+ * @details
+ * The handle is move-only, and can be completed from any thread, for
+ * example from an I/O callback. Completion re-enters the scheduler as a
+ * ready event: the Executor then publishes the task's outputs and schedules
+ * its successors on a worker thread.
+ *
+ * A handle destroyed without being completed fails the task, so that an
+ * abandoned operation cannot stall the graph.
+ */
+class AsyncCompletion
+{
+public:
+    using Function = void (*)(void* context, std::size_t index, std::exception_ptr error);
+
+public:
+    AsyncCompletion();
+    AsyncCompletion(Function function, void* context, std::size_t index);
+    AsyncCompletion(AsyncCompletion&& other) noexcept;
+    AsyncCompletion& operator=(AsyncCompletion&& other) noexcept;
+    ~AsyncCompletion();
+
+    /**
+     * @brief Reports success. All outputs must have been assigned.
+     */
+    void complete();
+
+    /**
+     * @brief Reports failure.
+     */
+    void fail(std::exception_ptr error);
+
+    /**
+     * @brief Whether this handle can still be completed.
+     */
+    explicit operator bool() const;
+
+private:
+    AsyncCompletion(const AsyncCompletion&) = delete;
+    AsyncCompletion& operator=(const AsyncCompletion&) = delete;
+
+    void invoke(std::exception_ptr error);
+
+private:
+    Function m_function;
+    void* m_context;
+    std::size_t m_index;
+};
+
+/**
+ * @brief Base class for tasks that wait on external events, such as file
+ * reads, decoding or hardware queues, without blocking a worker thread.
+ *
+ * @details
+ * The Executor calls on_execute_async() on a worker thread, after the
+ * inputs have been populated. The task starts its operation and returns
+ * immediately, and the worker picks up other ready tasks in the meantime.
+ * When the operation finishes, the task assigns its outputs and calls
+ * AsyncCompletion::complete().
+ *
+ * @note This is a continuation interface rather than C++20 coroutines,
+ * because the project is restricted to C++17. A coroutine awaiter can be
+ * layered on top of AsyncCompletion without changing the Executor.
+ */
+class AsyncTask : public Task
+{
+public:
+    ~AsyncTask();
+
+    /**
+     * @brief Starts the operation.
+     * @param completion The task either completes it before returning, or
+     * moves it out to complete it later. If the function throws while the
+     * handle is still in place, the task fails with that exception.
+     */
+    virtual void on_execute_async(AsyncCompletion& completion) = 0;
+
+    /**
+     * @brief Blocking adapter, for callers that run a task directly.
+     * @details Starts the operation and waits for its completion.
+     */
+    void on_execute() final;
+
+protected:
+    AsyncTask();
+};
+
+} // namespace tg::core
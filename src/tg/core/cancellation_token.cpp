@@ -0,0 +1,57 @@
+#include "tg/core/cancellation_token.hpp"
+
+namespace tg::core
+{
+
+CancellationToken::CancellationToken()
+    : m_state{static_cast<int>(State::Active)}
+    , m_has_deadline{false}
+    , m_deadline{}
+{
+}
+
+CancellationToken::CancellationToken(Clock::time_point deadline)
+    : m_state{static_cast<int>(State::Active)}
+    , m_has_deadline{true}
+    , m_deadline{deadline}
+{
+}
+
+CancellationToken::~CancellationToken()
+{
+}
+
+void CancellationToken::cancel()
+{
+    int expected = static_cast<int>(State::Active);
+    m_state.compare_exchange_strong(expected, static_cast<int>(State::Cancelled));
+}
+
+bool CancellationToken::is_cancelled() const
+{
+    return this->state() != State::Active;
+}
+
+CancellationToken::State CancellationToken::state() const
+{
+    int state = m_state.load(std::memory_order_acquire);
+    if (state == static_cast<int>(State::Active) && m_has_deadline && Clock::now() >= m_deadline)
+    {
+        int expected = static_cast<int>(State::Active);
+        m_state.compare_exchange_strong(expected, static_cast<int>(State::DeadlineExceeded));
+        state = m_state.load(std::memory_order_acquire);
+    }
+    return static_cast<State>(state);
+}
+
+bool CancellationToken::has_deadline() const
+{
+    return m_has_deadline;
+}
+
+CancellationToken::Clock::time_point CancellationToken::deadline() const
+{
+    return m_deadline;
+}
+
+} // namespace tg::core
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A cheap, thread-safe flag for cooperative cancellation of a graph
+ * run, with an optional deadline.
+ *
+ * @details
+ * The Executor checks the token before starting each task; once it is
+ * cancelled, no further task is started. Long-running tasks can poll it,
+ * through TaskContext::is_cancelled(), to abort early.
+ *
+ * Polling reads an atomic flag, plus the steady clock if a deadline is set.
+ */
+class CancellationToken
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State : int
+    {
+        Active = 0,
+        Cancelled = 1,
+        DeadlineExceeded = 2
+    };
+
+public:
+    CancellationToken();
+    explicit CancellationToken(Clock::time_point deadline);
+    ~CancellationToken();
+
+    /**
+     * @brief Cancels explicitly. Has no effect if already cancelled.
+     */
+    void cancel();
+
+    bool is_cancelled() const;
+
+    State state() const;
+
+    bool has_deadline() const;
+
+    Clock::time_point deadline() const;
+
+private:
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+    CancellationToken(CancellationToken&&) = delete;
+    CancellationToken& operator=(CancellationToken&&) = delete;
+
+private:
+    mutable std::atomic<int> m_state;
+    const bool m_has_deadline;
+    const Clock::time_point m_deadline;
+};
+
+using CancellationTokenPtr = std::shared_ptr<CancellationToken>;
+
+} // namespace tg::core
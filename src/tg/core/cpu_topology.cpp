@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#if defined(LINUX)
+#include <sched.h>
+#endif
+#include "tg/core/cpu_topology.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+/**
+ * @brief Parses a sysfs CPU list such as "0-3,8-11".
+ */
+std::vector<int> parse_cpu_list(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::size_t pos = 0u;
+    while (pos < text.size())
+    {
+        std::size_t comma = text.find(',', pos);
+        if (comma == std::string::npos)
+        {
+            comma = text.size();
+        }
+        std::string range = text.substr(pos, comma - pos);
+        pos = comma + 1u;
+        if (range.empty() || range[0] < '0' || range[0] > '9')
+        {
+            continue;
+        }
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0u, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1u));
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+} // namespace
+
+CpuTopology CpuTopology::detect()
+{
+#if defined(LINUX)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool has_mask = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    std::vector<NumaNode> nodes;
+    constexpr int max_nodes = 1024;
+    for (int node_id = 0; node_id < max_nodes; ++node_id)
+    {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node_id) + "/cpulist");
+        if (!file)
+        {
+            continue;
+        }
+        std::string text;
+        std::getline(file, text);
+        NumaNode node{node_id, {}};
+        for (int cpu : parse_cpu_list(text))
+        {
+            if (!has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+            {
+                node.cpus.push_back(cpu);
+            }
+        }
+        nodes.emplace_back(std::move(node));
+    }
+    CpuTopology topology{std::move(nodes)};
+    if (topology.cpu_count() > 0u)
+    {
+        return topology;
+    }
+#endif
+    return single_node(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+CpuTopology CpuTopology::single_node(std::size_t cpu_count)
+{
+    NumaNode node{0, {}};
+    for (std::size_t cpu = 0u; cpu < cpu_count; ++cpu)
+    {
+        node.cpus.push_back(static_cast<int>(cpu));
+    }
+    return CpuTopology{std::vector<NumaNode>{std::move(node)}};
+}
+
+CpuTopology::CpuTopology(std::vector<NumaNode> nodes)
+    : m_nodes{}
+{
+    for (auto& node : nodes)
+    {
+        if (!node.cpus.empty())
+        {
+            m_nodes.emplace_back(std::move(node));
+        }
+    }
+}
+
+const std::vector<NumaNode>& CpuTopology::nodes() const
+{
+    return m_nodes;
+}
+
+std::size_t CpuTopology::cpu_count() const
+{
+    std::size_t count = 0u;
+    for (const auto& node : m_nodes)
+    {
+        count += node.cpus.size();
+    }
+    return count;
+}
+
+int CpuTopology::node_of_cpu(int cpu) const
+{
+    for (const auto& node : m_nodes)
+    {
+        if (std::find(node.cpus.begin(), node.cpus.end(), cpu) != node.cpus.end())
+        {
+            return node.id;
+        }
+    }
+    return -1;
+}
+
+} // namespace tg::core
@@ -0,0 +1,58 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A NUMA node and the logical CPUs that belong to it.
+ */
+struct NumaNode
+{
+    int id;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief Describes the logical CPUs available to this process, grouped by
+ * NUMA node.
+ *
+ * @details
+ * On Linux, the topology is read from sysfs and restricted to the CPUs in
+ * the affinity mask of the calling thread. On other platforms, or when
+ * sysfs is unavailable, a single node holding all hardware threads is
+ * reported.
+ */
+class CpuTopology
+{
+public:
+    /**
+     * @brief Detects the topology of the running machine.
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief Creates a topology with a single node of @p cpu_count CPUs.
+     */
+    static CpuTopology single_node(std::size_t cpu_count);
+
+    /**
+     * @brief Creates a topology from an explicit list of nodes.
+     * @details Nodes without CPUs are dropped.
+     */
+    explicit CpuTopology(std::vector<NumaNode> nodes);
+
+    const std::vector<NumaNode>& nodes() const;
+
+    std::size_t cpu_count() const;
+
+    /**
+     * @brief Returns the NUMA node id of a logical CPU, or -1 if unknown.
+     */
+    int node_of_cpu(int cpu) const;
+
+private:
+    std::vector<NumaNode> m_nodes;
+};
+
+} // namespace tg::core
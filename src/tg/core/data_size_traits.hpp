@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+
+namespace tg::core
+{
+
+/**
+ * @brief Estimates the memory footprint of a value of type T.
+ *
+ * @details
+ * The Executor uses this estimate to find the largest input of a task, so
+ * that the task can be scheduled on the worker (or at least the NUMA node)
+ * which produced that input.
+ *
+ * The default estimate is sizeof(T). Types that own a heap buffer, such as
+ * images, should specialize this template to report the buffer size.
+ */
+template <typename T>
+struct DataSizeTraits
+{
+    static std::size_t byte_size(const T& /* value */)
+    {
+        return sizeof(T);
+    }
+};
+
+} // namespace tg::core
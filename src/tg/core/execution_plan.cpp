@@ -0,0 +1,152 @@
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/global_dataset.hpp"
+
+namespace tg::core
+{
+
+int ExecutionPlan::find_slot(const std::string& name) const
+{
+    for (std::size_t k = 0u; k < slots.size(); ++k)
+    {
+        if (slots[k].name == name)
+        {
+            return static_cast<int>(k);
+        }
+    }
+    return -1;
+}
+
+GlobalDataSetPtr ExecutionPlan::make_dataset() const
+{
+    auto dataset = std::make_shared<GlobalDataSet>();
+    for (const auto& slot : slots)
+    {
+        dataset->add(slot.name);
+    }
+    dataset->freeze();
+    return dataset;
+}
+
+ExecutionPlanPtr ExecutionPlan::prune(const std::vector<int>& output_slots) const
+{
+    const int task_count = static_cast<int>(tasks.size());
+    std::vector<char> needed(task_count, 0);
+    std::vector<char> requested(slots.size(), 0);
+    std::vector<int> stack;
+    auto require = [&](int slot)
+    {
+        int producer = slots[slot].producer;
+        if (producer >= 0 && !needed[producer])
+        {
+            needed[producer] = 1;
+            stack.push_back(producer);
+        }
+    };
+    for (int slot : output_slots)
+    {
+        if (slot < 0 || slot >= static_cast<int>(slots.size()))
+        {
+            throw std::out_of_range("ExecutionPlan::prune(): invalid slot index.");
+        }
+        requested[slot] = 1;
+        require(slot);
+    }
+    while (!stack.empty())
+    {
+        int task_id = stack.back();
+        stack.pop_back();
+        for (int slot : tasks[task_id].input_slots)
+        {
+            require(slot);
+        }
+    }
+
+    std::vector<int> new_index(task_count, -1);
+    auto plan = std::make_shared<ExecutionPlan>();
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        if (needed[task_id])
+        {
+            new_index[task_id] = static_cast<int>(plan->tasks.size());
+            const auto& source = tasks[task_id];
+            plan->tasks.push_back(PlanTask{source.task, source.bindings, source.input_slots,
+                source.output_slots, {}, source.predecessor_count, -1, -1, source.graph_index});
+        }
+    }
+    /**
+     * @note All producers of a needed task are needed, so predecessor counts
+     * are unchanged; only successors outside the cone are dropped.
+     */
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        if (!needed[task_id])
+        {
+            continue;
+        }
+        auto& successors = plan->tasks[new_index[task_id]].successors;
+        for (int successor : tasks[task_id].successors)
+        {
+            if (needed[successor])
+            {
+                successors.push_back(new_index[successor]);
+            }
+        }
+    }
+    plan->slots.reserve(slots.size());
+    for (const auto& slot : slots)
+    {
+        int producer = (slot.producer >= 0) ? new_index[slot.producer] : -1;
+        plan->slots.push_back(PlanSlot{slot.name, producer, 0, false, false, slot.type});
+    }
+    for (const auto& plan_task : plan->tasks)
+    {
+        for (int slot : plan_task.input_slots)
+        {
+            plan->slots[slot].consumer_count += 1;
+        }
+    }
+    for (std::size_t k = 0u; k < plan->slots.size(); ++k)
+    {
+        auto& plan_slot = plan->slots[k];
+        plan_slot.retained = (plan_slot.producer < 0 || requested[k]);
+    }
+    for (int task_id : topological_order)
+    {
+        if (needed[task_id])
+        {
+            plan->topological_order.push_back(new_index[task_id]);
+        }
+    }
+    plan->fuse_linear_chains();
+    return plan;
+}
+
+void ExecutionPlan::fuse_linear_chains()
+{
+    const int task_count = static_cast<int>(tasks.size());
+    for (auto& plan_task : tasks)
+    {
+        plan_task.fused_next = -1;
+        plan_task.fused_prev = -1;
+    }
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        auto& plan_task = tasks[task_id];
+        if (plan_task.successors.size() == 1u)
+        {
+            int successor = plan_task.successors.front();
+            if (tasks[successor].predecessor_count == 1)
+            {
+                plan_task.fused_next = successor;
+                tasks[successor].fused_prev = task_id;
+            }
+        }
+    }
+    for (auto& plan_slot : slots)
+    {
+        plan_slot.fused = (!plan_slot.retained && plan_slot.producer >= 0 &&
+            plan_slot.consumer_count == 1 && tasks[plan_slot.producer].fused_next >= 0);
+    }
+}
+
+} // namespace tg::core
@@ -0,0 +1,132 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Connects one TaskData of a task to a slot of the global dataset.
+ */
+struct PlanBinding
+{
+    int local_index;  ///< Index of the TaskData in the task's TaskDataSet.
+    int slot;  ///< Slot index in the global dataset.
+    TaskDataFlags flags;
+
+    /**
+     * @brief The TaskData at local_index, resolved when the plan is built.
+     * @details The TaskDataSet of a task is frozen before compilation, and
+     * the plan holds the task, so the pointer stays valid for the lifetime
+     * of the plan. The Executor moves values through it, without copying
+     * the TaskDataSet or locking it.
+     */
+    TaskData* data;
+};
+
+/**
+ * @brief A task in the compiled plan.
+ */
+struct PlanTask
+{
+    TaskPtr task;
+    std::vector<PlanBinding> bindings;  ///< In TaskDataSet order.
+    std::vector<int> input_slots;
+    std::vector<int> output_slots;
+    std::vector<int> successors;  ///< Distinct tasks consuming any output of this task.
+    int predecessor_count;  ///< Distinct tasks producing any input of this task.
+
+    /**
+     * @brief The successor run inline, right after this task and on the same
+     * thread, or -1.
+     * @details Set when this task has a single successor, and that successor
+     * has no other predecessor. Such links form linear chains that are
+     * scheduled as one unit; see TaskGraph::compile().
+     */
+    int fused_next;
+
+    int fused_prev;  ///< The task that runs this one inline, or -1.
+
+    /**
+     * @brief Index of the task in the TaskGraph, in the order tasks were
+     * added. Tasks removed by compile() leave gaps.
+     */
+    int graph_index;
+};
+
+/**
+ * @brief A data node in the compiled plan.
+ */
+struct PlanSlot
+{
+    std::string name;  ///< Fully-qualified name.
+    int producer;  ///< Producing task, or -1 for a graph input.
+    int consumer_count;
+
+    /**
+     * @brief Whether the value is kept after its last consumer has run.
+     * @details Graph inputs and data without consumers are retained; all
+     * other intermediates are released at the earliest possible moment.
+     * In a pruned plan, only graph inputs and the requested data are
+     * retained: other data without consumers is dropped once produced.
+     */
+    bool retained;
+
+    /**
+     * @brief Whether the value is handed from its producer directly to its
+     * only consumer, the producer's fused successor.
+     * @details A fused value is never stored in the global dataset.
+     */
+    bool fused;
+
+    /**
+     * @brief The type expected by the tasks bound to this slot, or none.
+     */
+    TypeId type;
+};
+
+/**
+ * @brief The immutable, execution-time form of a TaskGraph.
+ *
+ * @details
+ * Tasks and slots are identified by their index. The plan is produced by
+ * TaskGraph::compile() and consumed by the Executor.
+ */
+struct ExecutionPlan
+{
+    std::vector<PlanTask> tasks;
+    std::vector<PlanSlot> slots;
+    std::vector<int> topological_order;
+
+    /**
+     * @brief Returns the slot index of a fully-qualified name, or -1.
+     */
+    int find_slot(const std::string& name) const;
+
+    /**
+     * @brief Creates a frozen GlobalDataSet whose slot indices match this plan.
+     */
+    GlobalDataSetPtr make_dataset() const;
+
+    /**
+     * @brief Returns a plan that only runs the tasks needed to produce the
+     * given slots: their producers, and transitively the producers of the
+     * inputs of those tasks.
+     * @details The pruned plan has the same slots as this plan, so a
+     * dataset made for either plan can be used with both. The requested
+     * slots and the graph inputs are retained; other outputs of the
+     * needed tasks are dropped once no task reads them. Tasks are shared
+     * with this plan.
+     * @throws std::out_of_range if a slot index is invalid.
+     */
+    ExecutionPlanPtr prune(const std::vector<int>& output_slots) const;
+
+    /**
+     * @brief Links linear chains of tasks, and marks the data passed along
+     * them; see PlanTask::fused_next and PlanSlot::fused.
+     * @details Requires successors, predecessor counts, consumer counts and
+     * retained flags to be set.
+     */
+    void fuse_linear_chains();
+};
+
+} // namespace tg::core
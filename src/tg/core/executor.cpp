@@ -0,0 +1,1140 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <thread>
+#include "tg/core/executor.hpp"
+#include "tg/core/async_task.hpp"
+#include "tg/core/cancellation_token.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/global_dataset.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/core/schedule_log.hpp"
+#include "tg/core/spill_store.hpp"
+#include "tg/core/task.hpp"
+#include "tg/core/task_context.hpp"
+#include "tg/core/task_data.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/tenant.hpp"
+#include "tg/core/worker_pool.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+/**
+ * @brief Assigns the inputs of a task from the global dataset, through the
+ * TaskData pointers resolved in the plan.
+ */
+void populate_inputs(const ExecutionPlan& plan, GlobalDataSet& data, const PlanTask& plan_task)
+{
+    std::shared_ptr<void> value;
+    TypeId type;
+    for (const auto& binding : plan_task.bindings)
+    {
+        if (!!(binding.flags & TaskDataFlags::Output) || plan.slots[binding.slot].fused)
+        {
+            continue;
+        }
+        if (!data.try_get(binding.slot, value, type))
+        {
+            throw std::runtime_error("Executor: input " + plan.slots[binding.slot].name +
+                " is not populated.");
+        }
+        binding.data->try_assign(std::move(value), type);
+    }
+}
+
+/**
+ * @brief Assigns a fused value directly to the consuming TaskData of the
+ * fused successor.
+ */
+void hand_over(const ExecutionPlan& plan, int task_id, int slot, std::shared_ptr<void> value,
+    TypeId type)
+{
+    for (const auto& binding : plan.tasks[task_id].bindings)
+    {
+        if (binding.slot == slot)
+        {
+            binding.data->try_assign(std::move(value), type);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Copies the outputs of a task into the global dataset, or to the
+ * fused successor.
+ * @details An output that no task reads and that is not retained, such as
+ * an unrequested output of a pruned plan, is dropped with the task's
+ * dataset instead.
+ * @param on_published Called with the slot and the estimated byte size of
+ * each output stored in the global dataset.
+ */
+template <typename OnPublished>
+void publish_task_outputs(const ExecutionPlan& plan, GlobalDataSet& data, const PlanTask& plan_task,
+    OnPublished&& on_published)
+{
+    std::shared_ptr<void> value;
+    TypeId type;
+    for (const auto& binding : plan_task.bindings)
+    {
+        if (!(binding.flags & TaskDataFlags::Output))
+        {
+            continue;
+        }
+        const TaskData* item = binding.data;
+        if (!item->try_get(value, type))
+        {
+            throw std::runtime_error("Executor: output " + plan.slots[binding.slot].name +
+                " was not produced.");
+        }
+        const auto& plan_slot = plan.slots[binding.slot];
+        if (plan_slot.fused)
+        {
+            hand_over(plan, plan_task.fused_next, binding.slot, std::move(value), type);
+            continue;
+        }
+        if (plan_slot.consumer_count == 0 && !plan_slot.retained)
+        {
+            continue;
+        }
+        std::size_t byte_size = item->byte_size_hint();
+        on_published(binding.slot, byte_size);
+        data.try_assign(binding.slot, std::move(value), type, item->spill_codec(), byte_size);
+    }
+}
+
+RunStatus status_of(const std::exception_ptr& error, bool aborted, const CancellationToken* token)
+{
+    if (error)
+    {
+        return RunStatus::Failed;
+    }
+    if (aborted)
+    {
+        bool deadline = (token->state() == CancellationToken::State::DeadlineExceeded);
+        return deadline ? RunStatus::DeadlineExceeded : RunStatus::Cancelled;
+    }
+    return RunStatus::Completed;
+}
+
+} // namespace
+
+/**
+ * @brief The state of one call to Executor::run().
+ */
+class Executor::Run
+{
+public:
+    Run(Executor& executor, const ExecutionPlan& plan, GlobalDataSet& data,
+        const RunOptions& options)
+        : m_executor{executor}
+        , m_plan{plan}
+        , m_data{data}
+        , m_token{options.token.get()}
+        , m_pending{std::make_unique<std::atomic<int>[]>(plan.tasks.size())}
+        , m_skipped{std::make_unique<std::atomic<bool>[]>(plan.tasks.size())}
+        , m_branch_cancelled{std::make_unique<std::atomic<bool>[]>(plan.tasks.size())}
+        , m_consumers{std::make_unique<std::atomic<int>[]>(plan.slots.size())}
+        , m_producer_worker{std::make_unique<std::atomic<int>[]>(plan.slots.size())}
+        , m_byte_size{std::make_unique<std::atomic<std::size_t>[]>(plan.slots.size())}
+        , m_remaining{static_cast<int>(plan.tasks.size())}
+        , m_executed_count{0u}
+        , m_skipped_count{0u}
+        , m_aborted{false}
+        , m_mutex{}
+        , m_done_cv{}
+        , m_done{plan.tasks.empty()}
+        , m_error{}
+        , m_has_helper{executor.m_pool->current_worker() >= 0}
+        , m_schedule_epoch{0u}
+        , m_run_start{std::chrono::steady_clock::now()}
+        , m_record{options.record_schedule}
+        , m_record_entries{}
+        , m_sequence{0u}
+        , m_replay{options.replay_schedule}
+        , m_replay_timing{options.replay_timing}
+        , m_replay_mutex{}
+        , m_replay_order{}
+        , m_replay_state{}
+        , m_replay_turn{0u}
+        , m_tenant{(options.replay_schedule || executor.m_pool->current_worker() >= 0) ?
+            nullptr : options.tenant}
+        , m_spill_store{options.spill_store}
+        , m_spill_budget{options.spill_budget}
+        , m_spill_mutex{}
+        , m_rank{}
+        , m_readers{}
+        , m_started{}
+    {
+        if (m_spill_store)
+        {
+            this->init_spill();
+        }
+        if (m_record)
+        {
+            m_record_entries.resize(plan.tasks.size());
+        }
+        if (m_replay)
+        {
+            m_replay_order = m_replay->start_order();
+            m_replay_state.assign(plan.tasks.size(), ReplayState::Waiting);
+        }
+        for (std::size_t k = 0u; k < plan.tasks.size(); ++k)
+        {
+            m_pending[k].store(plan.tasks[k].predecessor_count, std::memory_order_relaxed);
+            m_skipped[k].store(false, std::memory_order_relaxed);
+            m_branch_cancelled[k].store(false, std::memory_order_relaxed);
+        }
+        for (std::size_t k = 0u; k < plan.slots.size(); ++k)
+        {
+            m_consumers[k].store(plan.slots[k].consumer_count, std::memory_order_relaxed);
+            m_producer_worker[k].store(-1, std::memory_order_relaxed);
+            m_byte_size[k].store(0u, std::memory_order_relaxed);
+        }
+    }
+
+    void start()
+    {
+        for (std::size_t k = 0u; k < m_plan.tasks.size(); ++k)
+        {
+            if (m_plan.tasks[k].predecessor_count == 0)
+            {
+                this->schedule(static_cast<int>(k));
+            }
+        }
+    }
+
+    RunResult wait()
+    {
+        if (m_executor.m_pool->current_worker() >= 0)
+        {
+            this->help_until_done();
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [this]() { return m_done; });
+        if (m_record)
+        {
+            m_record->reset(m_record_entries.size());
+            for (std::size_t k = 0u; k < m_record_entries.size(); ++k)
+            {
+                m_record->set(static_cast<int>(k), m_record_entries[k]);
+            }
+        }
+        return RunResult{status_of(m_error, m_aborted.load(), m_token), m_executed_count.load(),
+            m_skipped_count.load(), m_error};
+    }
+
+    static void execute_item(void* context, std::size_t index)
+    {
+        auto* run = static_cast<Run*>(context);
+        run->execute_chain(static_cast<int>(index));
+    }
+
+private:
+    /**
+     * @brief Returns the worker that produced the largest input of a task,
+     * or -1 if unknown.
+     */
+    int preferred_worker(int task_id) const
+    {
+        if (!m_executor.m_options.locality_aware)
+        {
+            return -1;
+        }
+        int best_worker = -1;
+        std::size_t best_size = 0u;
+        for (int slot : m_plan.tasks[task_id].input_slots)
+        {
+            int worker = m_producer_worker[slot].load(std::memory_order_relaxed);
+            std::size_t size = m_byte_size[slot].load(std::memory_order_relaxed);
+            if (worker >= 0 && (best_worker < 0 || size > best_size))
+            {
+                best_worker = worker;
+                best_size = size;
+            }
+        }
+        return best_worker;
+    }
+
+    void schedule(int task_id)
+    {
+        if (m_replay)
+        {
+            this->replay_ready(task_id, true);
+            return;
+        }
+        WorkItem item{&Run::execute_item, this, static_cast<std::size_t>(task_id)};
+        if (m_tenant)
+        {
+            m_executor.m_tenants->submit(*m_tenant, item, this->preferred_worker(task_id));
+            return;
+        }
+        this->submit(item, this->preferred_worker(task_id));
+    }
+
+    /**
+     * @brief Submits a work item of this run, and wakes up the helping
+     * waiter, if any.
+     * @param pinned Whether only the preferred worker may run the item.
+     * @note With a helper, submission happens under m_mutex: the item may
+     * complete the run right away, and the waiter must not return before
+     * this function has stopped touching the run.
+     */
+    void submit(const WorkItem& item, int preferred_worker, bool pinned = false)
+    {
+        auto& pool = *m_executor.m_pool;
+        auto push = [&]()
+        {
+            if (pinned)
+            {
+                pool.submit_pinned(item, static_cast<std::size_t>(preferred_worker));
+            }
+            else
+            {
+                pool.submit(item, preferred_worker);
+            }
+        };
+        if (!m_has_helper)
+        {
+            push();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        push();
+        ++m_schedule_epoch;
+        m_done_cv.notify_all();
+    }
+
+    /**
+     * @brief Replay: marks a task as ready, then dispatches tasks in the
+     * recorded start order, for as long as the next one is ready.
+     * @param dispatch False if the task was skipped, in which case it only
+     * gives up its turn.
+     * @details Each task is pinned to its recorded worker. A task recorded
+     * without a worker may run on any worker.
+     */
+    void replay_ready(int task_id, bool dispatch)
+    {
+        std::unique_lock<std::mutex> lock(m_replay_mutex);
+        m_replay_state[task_id] = dispatch ? ReplayState::Ready : ReplayState::Skipped;
+        while (m_replay_turn < m_replay_order.size())
+        {
+            int next = m_replay_order[m_replay_turn];
+            if (m_replay_state[next] == ReplayState::Waiting)
+            {
+                break;
+            }
+            ++m_replay_turn;
+            if (m_replay_state[next] == ReplayState::Ready)
+            {
+                int worker = m_replay->at(next).worker;
+                WorkItem item{&Run::execute_item, this, static_cast<std::size_t>(next)};
+                this->submit(item, worker, worker >= 0);
+            }
+        }
+    }
+
+    /**
+     * @brief Record: notes the worker, global rank and time of a task start.
+     */
+    void record_start(int task_id, bool skipped)
+    {
+        if (!m_record)
+        {
+            return;
+        }
+        auto& entry = m_record_entries[task_id];
+        entry.worker = m_executor.m_pool->current_worker();
+        entry.sequence = m_sequence.fetch_add(1u, std::memory_order_relaxed);
+        entry.flags = skipped ? ScheduledTask::Skipped : ScheduledTask::None;
+        entry.reserved = 0u;
+        entry.start_ns = this->elapsed_ns();
+        entry.duration_ns = 0;
+    }
+
+    void record_end(int task_id)
+    {
+        if (m_record)
+        {
+            auto& entry = m_record_entries[task_id];
+            entry.duration_ns = this->elapsed_ns() - entry.start_ns;
+        }
+    }
+
+    std::int64_t elapsed_ns() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_run_start).count();
+    }
+
+    /**
+     * @brief Used when run() is called from a worker of the same pool, for
+     * example by a plugin task that runs a nested graph. Instead of blocking
+     * a pool thread, the waiting worker executes the work items of this run
+     * until the run is done. No extra thread is created, and since any
+     * queued item of this run can be taken by the waiter, the nested run
+     * cannot deadlock on a saturated pool.
+     * @note m_has_helper is set by the constructor, before start() queues
+     * anything, so that no item is submitted without waking the helper.
+     */
+    void help_until_done()
+    {
+        while (true)
+        {
+            std::uint64_t seen_epoch;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_done)
+                {
+                    return;
+                }
+                seen_epoch = m_schedule_epoch;
+            }
+            if (m_executor.m_pool->try_run_one(this))
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done_cv.wait(lock, [this, seen_epoch]()
+                { return m_done || m_schedule_epoch != seen_epoch; });
+        }
+    }
+
+    /**
+     * @brief Whether the run has been aborted, by a failure or through the
+     * cancellation token.
+     */
+    bool is_aborted()
+    {
+        if (m_aborted.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+        if (m_token && m_token->is_cancelled())
+        {
+            m_aborted.store(true, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    bool should_skip(int task_id)
+    {
+        return m_skipped[task_id].load(std::memory_order_acquire) || this->is_aborted();
+    }
+
+    /**
+     * @brief Executes a task, then the chain of tasks fused after it, on the
+     * calling thread.
+     * @details The completion of the whole chain is counted at once. The
+     * tenant's share is released before, while the run is still alive.
+     */
+    void execute_chain(int task_id)
+    {
+        int completed = 0;
+        while (task_id >= 0)
+        {
+            task_id = this->execute_task(task_id, completed);
+        }
+        if (m_tenant)
+        {
+            m_executor.m_tenants->release(*m_tenant);
+        }
+        this->retire(completed);
+    }
+
+    /**
+     * @brief Executes one task.
+     * @return The fused successor that is ready to run inline, or -1.
+     */
+    int execute_task(int task_id, int& completed)
+    {
+        const auto& plan_task = m_plan.tasks[task_id];
+        if (this->should_skip(task_id))
+        {
+            m_skipped_count.fetch_add(1u, std::memory_order_relaxed);
+            this->record_start(task_id, true);
+            return this->finish_task(task_id, true, completed);
+        }
+        if (m_spill_store)
+        {
+            m_started[task_id].store(true, std::memory_order_relaxed);
+        }
+        if (m_replay_timing)
+        {
+            std::this_thread::sleep_until(m_run_start +
+                std::chrono::nanoseconds{m_replay->at(task_id).start_ns});
+        }
+        this->record_start(task_id, false);
+        auto dataset = plan_task.task->get_dataset();
+        if (plan_task.task->kind() == TaskKind::Async)
+        {
+            this->start_async(task_id);
+            return -1;
+        }
+        try
+        {
+            populate_inputs(m_plan, m_data, plan_task);
+            TaskContext context{m_executor, m_token, m_aborted, m_branch_cancelled[task_id]};
+            plan_task.task->on_execute();
+            this->publish_outputs(plan_task);
+        }
+        catch (...)
+        {
+            this->fail(std::current_exception());
+        }
+        dataset->release();
+        m_executed_count.fetch_add(1u, std::memory_order_relaxed);
+        this->record_end(task_id);
+        this->spill_if_over_budget();
+        return this->finish_task(task_id, m_branch_cancelled[task_id].load(std::memory_order_acquire),
+            completed);
+    }
+
+    /**
+     * @brief Starts an AsyncTask. The worker returns to the pool as soon as
+     * on_execute_async() returns.
+     */
+    void start_async(int task_id)
+    {
+        const auto& plan_task = m_plan.tasks[task_id];
+        AsyncCompletion completion{&Run::complete_async, this, static_cast<std::size_t>(task_id)};
+        try
+        {
+            populate_inputs(m_plan, m_data, plan_task);
+            TaskContext context{m_executor, m_token, m_aborted, m_branch_cancelled[task_id]};
+            static_cast<AsyncTask&>(*plan_task.task).on_execute_async(completion);
+        }
+        catch (...)
+        {
+            if (completion)
+            {
+                completion.fail(std::current_exception());
+            }
+            else
+            {
+                this->fail(std::current_exception());
+            }
+        }
+    }
+
+    /**
+     * @brief Called through AsyncCompletion, from any thread. The rest of
+     * the task is submitted to the pool as a ready event.
+     */
+    static void complete_async(void* context, std::size_t index, std::exception_ptr error)
+    {
+        auto* run = static_cast<Run*>(context);
+        if (error)
+        {
+            run->fail(error);
+        }
+        WorkItem item{&Run::finish_async_item, run, index};
+        run->submit(item, -1);
+    }
+
+    static void finish_async_item(void* context, std::size_t index)
+    {
+        auto* run = static_cast<Run*>(context);
+        int task_id = static_cast<int>(index);
+        const auto& plan_task = run->m_plan.tasks[task_id];
+        auto dataset = plan_task.task->get_dataset();
+        if (!run->m_aborted.load(std::memory_order_acquire))
+        {
+            try
+            {
+                run->publish_outputs(plan_task);
+            }
+            catch (...)
+            {
+                run->fail(std::current_exception());
+            }
+        }
+        dataset->release();
+        run->m_executed_count.fetch_add(1u, std::memory_order_relaxed);
+        run->record_end(task_id);
+        run->spill_if_over_budget();
+        int completed = 0;
+        int next = run->finish_task(task_id,
+            run->m_branch_cancelled[task_id].load(std::memory_order_acquire), completed);
+        while (next >= 0)
+        {
+            next = run->execute_task(next, completed);
+        }
+        run->retire(completed);
+    }
+
+    void skip_successors(int task_id)
+    {
+        for (int successor : m_plan.tasks[task_id].successors)
+        {
+            m_skipped[successor].store(true, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Completes a task, and then the successors that are skipped.
+     * @details Skipped tasks are completed inline, without a round-trip
+     * through the pool, so that a cancelled run drains quickly.
+     * @param completed Incremented by the number of tasks completed; the
+     * caller passes the total to retire().
+     * @return The fused successor that is ready to run inline, or -1.
+     */
+    int finish_task(int task_id, bool skip_successors, int& completed)
+    {
+        std::vector<int> inline_skips;
+        int fused_next = this->complete_task(task_id, skip_successors, inline_skips);
+        ++completed;
+        while (!inline_skips.empty())
+        {
+            int skipped_id = inline_skips.back();
+            inline_skips.pop_back();
+            this->complete_task(skipped_id, true, inline_skips);
+            ++completed;
+        }
+        return fused_next;
+    }
+
+    /**
+     * @brief Releases inputs whose last consumer has completed, and schedules
+     * the successors that have become ready.
+     * @details The fused successor has no other predecessor: it is ready
+     * without touching its counter, and is returned to run inline instead of
+     * being scheduled.
+     */
+    int complete_task(int task_id, bool skip_successors, std::vector<int>& inline_skips)
+    {
+        const auto& plan_task = m_plan.tasks[task_id];
+        for (int slot : plan_task.input_slots)
+        {
+            const auto& plan_slot = m_plan.slots[slot];
+            if (!plan_slot.fused &&
+                m_consumers[slot].fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !plan_slot.retained)
+            {
+                m_data.release(slot);
+            }
+        }
+        if (skip_successors)
+        {
+            this->skip_successors(task_id);
+        }
+        int fused_next = -1;
+        for (int successor : plan_task.successors)
+        {
+            bool fused = (successor == plan_task.fused_next);
+            if (fused || m_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                if (this->should_skip(successor))
+                {
+                    m_skipped_count.fetch_add(1u, std::memory_order_relaxed);
+                    this->record_start(successor, true);
+                    inline_skips.push_back(successor);
+                    if (fused)
+                    {
+                        m_plan.tasks[successor].task->get_dataset()->release();
+                    }
+                    if (m_replay)
+                    {
+                        this->replay_ready(successor, false);
+                    }
+                }
+                else if (fused && !m_replay)
+                {
+                    fused_next = successor;
+                }
+                else
+                {
+                    this->schedule(successor);
+                }
+            }
+        }
+        return fused_next;
+    }
+
+    /**
+     * @brief Counts completed tasks, and marks the run as done after the
+     * last one.
+     */
+    void retire(int count)
+    {
+        if (count > 0 && m_remaining.fetch_sub(count, std::memory_order_acq_rel) == count)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done = true;
+            m_done_cv.notify_all();
+        }
+    }
+
+    void publish_outputs(const PlanTask& plan_task)
+    {
+        int worker = m_executor.m_pool->current_worker();
+        publish_task_outputs(m_plan, m_data, plan_task,
+            [this, worker](int slot, std::size_t byte_size)
+            {
+                m_byte_size[slot].store(byte_size, std::memory_order_relaxed);
+                m_producer_worker[slot].store(worker, std::memory_order_relaxed);
+            });
+    }
+
+    /**
+     * @brief Called after a task has released its TaskDataSet, once its
+     * outputs are referenced by the global dataset only.
+     */
+    void spill_if_over_budget()
+    {
+        if (m_spill_store && m_data.resident_bytes() > m_spill_budget)
+        {
+            this->spill_cold_values();
+        }
+    }
+
+    /**
+     * @brief Ranks tasks by topological order, and lists the readers of
+     * each slot by rank, to estimate how soon each value is needed.
+     */
+    void init_spill()
+    {
+        m_rank.assign(m_plan.tasks.size(), 0);
+        for (std::size_t k = 0u; k < m_plan.topological_order.size(); ++k)
+        {
+            m_rank[m_plan.topological_order[k]] = static_cast<int>(k);
+        }
+        m_readers.assign(m_plan.slots.size(), std::vector<int>{});
+        for (int task_id : m_plan.topological_order)
+        {
+            for (int slot : m_plan.tasks[task_id].input_slots)
+            {
+                m_readers[slot].push_back(task_id);
+            }
+        }
+        m_started = std::make_unique<std::atomic<bool>[]>(m_plan.tasks.size());
+        for (std::size_t k = 0u; k < m_plan.tasks.size(); ++k)
+        {
+            m_started[k].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Rank of the first reader of a slot that has not started yet,
+     * or INT_MAX if there is none, as for a graph output.
+     */
+    int next_use(int slot) const
+    {
+        for (int task_id : m_readers[slot])
+        {
+            if (!m_started[task_id].load(std::memory_order_relaxed))
+            {
+                return m_rank[task_id];
+            }
+        }
+        return std::numeric_limits<int>::max();
+    }
+
+    /**
+     * @brief Spills values, coldest first, until the dataset is back under
+     * budget.
+     * @details The expected schedule is the topological order: the value
+     * whose next reader is furthest in that order is spilled first. Only
+     * the values that are resident and could be spilled are ranked, in a
+     * heap, so that the coldest are taken without sorting the others. Values
+     * currently read by a running task are not spilled. Only one worker
+     * spills at a time; the others carry on.
+     */
+    void spill_cold_values()
+    {
+        std::unique_lock<std::mutex> lock(m_spill_mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+        std::vector<std::pair<int, int>> candidates;
+        for (std::size_t slot = 0u; slot < m_plan.slots.size(); ++slot)
+        {
+            if (!m_plan.slots[slot].fused && m_data.is_spillable(static_cast<int>(slot)))
+            {
+                candidates.emplace_back(this->next_use(static_cast<int>(slot)), static_cast<int>(slot));
+            }
+        }
+        std::make_heap(candidates.begin(), candidates.end());
+        while (!candidates.empty() && m_data.resident_bytes() > m_spill_budget)
+        {
+            std::pop_heap(candidates.begin(), candidates.end());
+            m_data.try_spill(candidates.back().second, *m_spill_store);
+            candidates.pop_back();
+        }
+    }
+
+    void fail(std::exception_ptr error)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_error)
+        {
+            m_error = error;
+        }
+        m_aborted.store(true, std::memory_order_release);
+    }
+
+private:
+    Executor& m_executor;
+    const ExecutionPlan& m_plan;
+    GlobalDataSet& m_data;
+    const CancellationToken* m_token;
+    std::unique_ptr<std::atomic<int>[]> m_pending;  ///< Per task.
+    std::unique_ptr<std::atomic<bool>[]> m_skipped;  ///< Per task.
+    std::unique_ptr<std::atomic<bool>[]> m_branch_cancelled;  ///< Per task.
+    std::unique_ptr<std::atomic<int>[]> m_consumers;  ///< Per slot.
+    std::unique_ptr<std::atomic<int>[]> m_producer_worker;  ///< Per slot.
+    std::unique_ptr<std::atomic<std::size_t>[]> m_byte_size;  ///< Per slot.
+    std::atomic<int> m_remaining;
+    std::atomic<std::size_t> m_executed_count;
+    std::atomic<std::size_t> m_skipped_count;
+    std::atomic<bool> m_aborted;
+    std::mutex m_mutex;
+    std::condition_variable m_done_cv;
+    bool m_done;
+    std::exception_ptr m_error;
+    const bool m_has_helper;  ///< Whether a worker of the pool waits for the run, see help_until_done().
+    std::uint64_t m_schedule_epoch;  ///< Guarded by m_mutex.
+    const std::chrono::steady_clock::time_point m_run_start;
+
+    ScheduleLog* m_record;
+    std::vector<ScheduledTask> m_record_entries;  ///< Per task; copied to m_record when done.
+    std::atomic<std::uint32_t> m_sequence;
+
+    enum class ReplayState : char
+    {
+        Waiting,
+        Ready,
+        Skipped
+    };
+    const ScheduleLog* m_replay;
+    const bool m_replay_timing;
+    std::mutex m_replay_mutex;
+    std::vector<int> m_replay_order;  ///< Task ids in recorded start order.
+    std::vector<ReplayState> m_replay_state;  ///< Per task; guarded by m_replay_mutex.
+    std::size_t m_replay_turn;  ///< Guarded by m_replay_mutex.
+
+    TenantPtr m_tenant;
+
+    SpillStorePtr m_spill_store;
+    const std::size_t m_spill_budget;
+    std::mutex m_spill_mutex;
+    std::vector<int> m_rank;  ///< Per task: position in the topological order.
+    std::vector<std::vector<int>> m_readers;  ///< Per slot: consumer tasks, by rank.
+    std::unique_ptr<std::atomic<bool>[]> m_started;  ///< Per task.
+};
+
+/**
+ * @brief The state of one call to Executor::run() that runs inline.
+ * @details Tasks run in the plan's topological order on the calling
+ * thread. Nothing is shared with other threads, so the counters are plain
+ * integers, and no work item is queued.
+ */
+class Executor::InlineRun
+{
+public:
+    InlineRun(Executor& executor, const ExecutionPlan& plan, GlobalDataSet& data,
+        const RunOptions& options)
+        : m_executor{executor}
+        , m_plan{plan}
+        , m_data{data}
+        , m_token{options.token.get()}
+        , m_skipped(plan.tasks.size(), 0)
+        , m_consumers(plan.slots.size(), 0)
+        , m_executed_count{0u}
+        , m_skipped_count{0u}
+        , m_aborted{false}
+        , m_branch_cancelled{false}
+        , m_error{}
+    {
+        for (std::size_t k = 0u; k < plan.slots.size(); ++k)
+        {
+            m_consumers[k] = plan.slots[k].consumer_count;
+        }
+    }
+
+    RunResult run()
+    {
+        for (int task_id : m_plan.topological_order)
+        {
+            this->execute_task(task_id);
+        }
+        bool aborted = m_aborted.load(std::memory_order_relaxed);
+        return RunResult{status_of(m_error, aborted, m_token), m_executed_count, m_skipped_count,
+            m_error};
+    }
+
+private:
+    bool is_aborted()
+    {
+        if (m_aborted.load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+        if (m_token && m_token->is_cancelled())
+        {
+            m_aborted.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void execute_task(int task_id)
+    {
+        const auto& plan_task = m_plan.tasks[task_id];
+        auto dataset = plan_task.task->get_dataset();
+        if (m_skipped[task_id] || this->is_aborted())
+        {
+            ++m_skipped_count;
+            if (plan_task.fused_prev >= 0)
+            {
+                dataset->release();
+            }
+            this->complete_task(task_id, true);
+            return;
+        }
+        m_branch_cancelled.store(false, std::memory_order_relaxed);
+        try
+        {
+            populate_inputs(m_plan, m_data, plan_task);
+            TaskContext context{m_executor, m_token, m_aborted, m_branch_cancelled};
+            plan_task.task->on_execute();
+            publish_task_outputs(m_plan, m_data, plan_task, [](int, std::size_t) {});
+        }
+        catch (...)
+        {
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+            m_aborted.store(true, std::memory_order_relaxed);
+        }
+        dataset->release();
+        ++m_executed_count;
+        this->complete_task(task_id, m_branch_cancelled.load(std::memory_order_relaxed));
+    }
+
+    void complete_task(int task_id, bool skip_successors)
+    {
+        const auto& plan_task = m_plan.tasks[task_id];
+        for (int slot : plan_task.input_slots)
+        {
+            const auto& plan_slot = m_plan.slots[slot];
+            if (!plan_slot.fused && --m_consumers[slot] == 0 && !plan_slot.retained)
+            {
+                m_data.release(slot);
+            }
+        }
+        if (skip_successors)
+        {
+            for (int successor : plan_task.successors)
+            {
+                m_skipped[successor] = 1;
+            }
+        }
+    }
+
+private:
+    Executor& m_executor;
+    const ExecutionPlan& m_plan;
+    GlobalDataSet& m_data;
+    const CancellationToken* m_token;
+    std::vector<char> m_skipped;  ///< Per task.
+    std::vector<int> m_consumers;  ///< Per slot.
+    std::size_t m_executed_count;
+    std::size_t m_skipped_count;
+
+    /**
+     * @note Atomic only because TaskContext takes a reference to it; only
+     * the calling thread accesses it.
+     */
+    std::atomic<bool> m_aborted;
+    std::atomic<bool> m_branch_cancelled;
+
+    std::exception_ptr m_error;
+};
+
+Executor::Executor(WorkerPoolPtr pool, const ExecutorOptions& options)
+    : m_pool{std::move(pool)}
+    , m_options{options}
+    , m_tenants{}
+{
+    if (!m_pool)
+    {
+        throw std::invalid_argument("Executor::Executor(): pool cannot be null.");
+    }
+    m_tenants = std::make_shared<TenantScheduler>(m_pool);
+}
+
+Executor::~Executor()
+{
+}
+
+const WorkerPoolPtr& Executor::pool() const
+{
+    return m_pool;
+}
+
+Executor* Executor::current()
+{
+    TaskContext* context = TaskContext::current();
+    return context ? &context->executor() : nullptr;
+}
+
+void Executor::run(const ExecutionPlan& plan, GlobalDataSet& data)
+{
+    RunResult result = this->try_run(plan, data);
+    if (result.error)
+    {
+        std::rethrow_exception(result.error);
+    }
+}
+
+RunResult Executor::try_run(const ExecutionPlan& plan, GlobalDataSet& data, const RunOptions& options)
+{
+    if (!data.is_frozen() || data.size() != plan.slots.size())
+    {
+        throw std::invalid_argument("Executor::try_run(): dataset does not match the plan.");
+    }
+    if (options.replay_schedule)
+    {
+        this->check_replay(plan, *options.replay_schedule);
+    }
+    if (options.tenant && !m_tenants->owns(*options.tenant))
+    {
+        throw std::invalid_argument("Executor::try_run(): tenant of another executor.");
+    }
+    std::vector<LockSiteStats> locks_before;
+    if (options.lock_report && LockProfiler::enabled())
+    {
+        locks_before = LockProfiler::snapshot();
+    }
+    RunResult result;
+    if (this->runs_inline(plan, options))
+    {
+        InlineRun run{*this, plan, data, options};
+        result = run.run();
+    }
+    else
+    {
+        Run run{*this, plan, data, options};
+        run.start();
+        result = run.wait();
+    }
+    if (options.lock_report)
+    {
+        *options.lock_report = LockProfiler::enabled() ?
+            LockProfiler::since(locks_before) : std::vector<LockSiteStats>{};
+    }
+    return result;
+}
+
+TenantPtr Executor::create_tenant(const TenantOptions& options)
+{
+    return m_tenants->create_tenant(options);
+}
+
+bool Executor::runs_inline(const ExecutionPlan& plan, const RunOptions& options) const
+{
+    if (options.record_schedule || options.replay_schedule || options.spill_store)
+    {
+        return false;
+    }
+    std::size_t limit = (m_pool->current_worker() >= 0) ?
+        m_options.nested_inline_task_limit : m_options.inline_task_limit;
+    if (plan.tasks.size() > limit)
+    {
+        return false;
+    }
+    for (const auto& plan_task : plan.tasks)
+    {
+        if (plan_task.task->kind() == TaskKind::Async)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Executor::check_replay(const ExecutionPlan& plan, const ScheduleLog& log) const
+{
+    if (log.task_count() != plan.tasks.size())
+    {
+        throw std::invalid_argument("Executor::try_run(): schedule log does not match the plan.");
+    }
+    std::vector<int> order = log.start_order();
+    for (std::size_t rank = 0u; rank < order.size(); ++rank)
+    {
+        const auto& entry = log.at(order[rank]);
+        if (entry.sequence != rank || entry.worker >= static_cast<int>(m_pool->size()))
+        {
+            throw std::invalid_argument("Executor::try_run(): invalid schedule log for this pool.");
+        }
+    }
+    /**
+     * @note Replay dispatches in the recorded order only: a task recorded
+     * before one of its predecessors would wait forever.
+     */
+    for (std::size_t task_id = 0u; task_id < plan.tasks.size(); ++task_id)
+    {
+        std::uint32_t sequence = log.at(static_cast<int>(task_id)).sequence;
+        for (int successor : plan.tasks[task_id].successors)
+        {
+            if (log.at(successor).sequence <= sequence)
+            {
+                throw std::invalid_argument("Executor::try_run(): schedule log starts task " +
+                    std::to_string(successor) + " before its predecessor " + std::to_string(task_id) + ".");
+            }
+        }
+    }
+}
+
+bool Executor::execute_chain(const ExecutionPlan& plan, GlobalDataSet& data, int task_id)
+{
+    std::atomic<bool> aborted{false};
+    std::atomic<bool> branch_cancelled{false};
+    auto release_rest = [&plan](int next)
+    {
+        for (; next >= 0; next = plan.tasks[next].fused_next)
+        {
+            plan.tasks[next].task->get_dataset()->release();
+        }
+    };
+    for (; task_id >= 0; task_id = plan.tasks[task_id].fused_next)
+    {
+        const auto& plan_task = plan.tasks[task_id];
+        auto dataset = plan_task.task->get_dataset();
+        try
+        {
+            if (plan_task.task->kind() == TaskKind::Async)
+            {
+                throw std::invalid_argument("Executor::execute_chain(): async tasks are not supported.");
+            }
+            populate_inputs(plan, data, plan_task);
+            TaskContext context{*this, nullptr, aborted, branch_cancelled};
+            plan_task.task->on_execute();
+            publish_task_outputs(plan, data, plan_task, [](int, std::size_t) {});
+        }
+        catch (...)
+        {
+            release_rest(task_id);
+            throw;
+        }
+        dataset->release();
+        if (branch_cancelled.load(std::memory_order_relaxed))
+        {
+            release_rest(plan_task.fused_next);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace tg::core
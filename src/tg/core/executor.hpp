@@ -0,0 +1,240 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+#include "tg/core/cancellation_token.hpp"
+#include "tg/core/tenant.hpp"
+
+namespace tg::core
+{
+
+struct ExecutorOptions
+{
+    /**
+     * @brief Prefer running a task on the worker that produced its largest
+     * input.
+     * @details The size of each input is estimated with
+     * TaskData::byte_size_hint(). When the preferred worker is busy, an idle
+     * worker on the same NUMA node steals the task before workers on remote
+     * nodes do (see WorkerPool).
+     */
+    bool locality_aware = true;
+
+    /**
+     * @brief Plans with at most this many tasks run inline on the calling
+     * thread, in topological order, instead of on the pool.
+     * @details For tiny graphs, handing tasks to the pool and waking up
+     * workers costs more than the tasks themselves. Plans containing an
+     * AsyncTask always run on the pool.
+     */
+    std::size_t inline_task_limit = 8u;
+
+    /**
+     * @brief Same as inline_task_limit, for a nested graph run from a worker
+     * of the pool, which is already running in parallel with its siblings.
+     */
+    std::size_t nested_inline_task_limit = 32u;
+};
+
+struct RunOptions
+{
+    /**
+     * @brief Optional token to cancel the run, or to give it a deadline.
+     */
+    CancellationTokenPtr token;
+
+    /**
+     * @brief If set, the schedule of the run is recorded into this log when
+     * the run is done.
+     */
+    ScheduleLog* record_schedule = nullptr;
+
+    /**
+     * @brief If set, the run replays this schedule: tasks are started in the
+     * recorded global order, each on its recorded worker.
+     * @details The log must come from a run of a plan with the same
+     * structure, on a pool with at least as many workers.
+     */
+    const ScheduleLog* replay_schedule = nullptr;
+
+    /**
+     * @brief When replaying, also delays each task until its recorded start
+     * time, relative to the start of the run.
+     */
+    bool replay_timing = false;
+
+    /**
+     * @brief The tenant on whose behalf the run executes, created by
+     * Executor::create_tenant(). Null for a run outside of tenant
+     * scheduling.
+     * @details Ignored by nested runs, which execute on behalf of a task
+     * that already holds its tenant's share, and by replayed runs.
+     */
+    TenantPtr tenant;
+
+    /**
+     * @brief Scratch store to spill cold values to, when the dataset's
+     * resident bytes exceed spill_budget. Spilling is disabled if null.
+     * @details Only values whose type supports it are spilled (see
+     * SpillTraits). Values whose next consumer is furthest in the
+     * topological order are spilled first; a spilled value is faulted back
+     * in when a consumer reads it. Such runs are never inlined.
+     */
+    SpillStorePtr spill_store;
+
+    std::size_t spill_budget = 0u;
+
+    /**
+     * @brief If set, receives the lock sites acquired during the run, by
+     * decreasing total wait time (see LockProfiler). Empty unless built
+     * with TG_PROFILE_LOCKS.
+     */
+    std::vector<LockSiteStats>* lock_report = nullptr;
+};
+
+enum class RunStatus
+{
+    /**
+     * @brief The run was not aborted. Branches cancelled by tasks through
+     * TaskContext::cancel_branch() are counted in RunResult::skipped_tasks.
+     */
+    Completed = 0,
+
+    Cancelled = 1,
+    DeadlineExceeded = 2,
+
+    /**
+     * @brief A task threw; RunResult::error holds the first exception.
+     */
+    Failed = 3
+};
+
+struct RunResult
+{
+    RunStatus status;
+    std::size_t executed_tasks;
+    std::size_t skipped_tasks;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Executes an ExecutionPlan on a WorkerPool.
+ *
+ * @details
+ * Scheduling follows Kahn's algorithm: each task has a counter of pending
+ * predecessors, and a task is submitted to the pool when its counter drops
+ * to zero.
+ *
+ * For each task, the Executor:
+ * (1) populates the inputs of the task's TaskDataSet from the global dataset; <br/>
+ * (2) calls Task::on_execute(); <br/>
+ * (3) copies the outputs into the global dataset; <br/>
+ * (4) releases the task's TaskDataSet, and releases each intermediate whose
+ *     last consumer has run. <br/>
+ *
+ * Linear chains fused by TaskGraph::compile() are one scheduling unit: the
+ * worker that runs the first task of a chain runs each fused successor
+ * right after it, and a value passed along the chain is assigned from one
+ * TaskDataSet to the next without going through the global dataset.
+ *
+ * An AsyncTask does not hold a worker between (2) and (3): the worker
+ * returns to the pool after on_execute_async(), and steps (3) and (4) are
+ * submitted to the pool when the task's AsyncCompletion is completed.
+ *
+ * Small plans bypass the pool entirely; see ExecutorOptions::inline_task_limit.
+ *
+ * For performance investigation, a run can record its schedule, and a later
+ * run can replay it deterministically: each task is started on the same
+ * worker and in the same global order, optionally at the same time. Fused
+ * chains are dispatched task by task in that mode, and runs are never
+ * inlined. See RunOptions::record_schedule.
+ *
+ * Several graphs can share one Executor, each run being started from its
+ * own thread. Runs given a Tenant are dispatched to the pool by priority
+ * lane, weighted-fair within a lane, and under the tenant's concurrency cap;
+ * see TenantScheduler.
+ *
+ * Runs of huge data can spill cold intermediates to disk instead of
+ * exhausting memory; see RunOptions::spill_store.
+ *
+ * A run is aborted when a task throws, or when the token in RunOptions is
+ * cancelled or its deadline is missed. Once aborted, no further task is
+ * started: tasks that become ready are skipped inline and their pending
+ * inputs are released, so the run drains without occupying the pool.
+ * Outputs produced before the abort remain in the global dataset.
+ */
+class Executor
+{
+public:
+    explicit Executor(WorkerPoolPtr pool, const ExecutorOptions& options = ExecutorOptions{});
+    ~Executor();
+
+    const WorkerPoolPtr& pool() const;
+
+    /**
+     * @brief Returns the Executor running the task on the calling thread, or
+     * null outside of task execution.
+     * @details A plugin task uses this to run a nested graph on the same
+     * worker pool.
+     */
+    static Executor* current();
+
+    /**
+     * @brief Runs the plan to completion, and rethrows the first exception
+     * thrown by a task.
+     * @param data A frozen dataset created by ExecutionPlan::make_dataset(),
+     * with all graph inputs assigned.
+     * @details When called from a worker of this Executor's pool, as for a
+     * nested graph launched by a task, the calling worker executes the
+     * nested graph's tasks while waiting, instead of blocking.
+     * @note A plan can only be run by one call at a time, because its tasks
+     * own their TaskDataSet.
+     */
+    void run(const ExecutionPlan& plan, GlobalDataSet& data);
+
+    /**
+     * @brief Runs the plan until it completes or is aborted.
+     * @details Unlike run(), task failures are reported through the result
+     * rather than rethrown.
+     */
+    RunResult try_run(const ExecutionPlan& plan, GlobalDataSet& data,
+        const RunOptions& options = RunOptions{});
+
+    /**
+     * @brief Creates a tenant of this Executor, to be passed to runs in
+     * RunOptions::tenant.
+     * @throws std::invalid_argument if the options are invalid.
+     */
+    TenantPtr create_tenant(const TenantOptions& options);
+
+    /**
+     * @brief Executes a task, then the tasks fused after it, on the calling
+     * thread, outside of a run.
+     * @details Used to execute a plan piecemeal under an external
+     * scheduler, such as a PartitionWorker. Inputs are read from @p data,
+     * outputs are published to it, and no value is released. The first
+     * exception thrown by a task is rethrown.
+     * @return Whether a task cancelled its branch, in which case the rest of
+     * the chain is not executed.
+     * @throws std::invalid_argument for an AsyncTask.
+     */
+    bool execute_chain(const ExecutionPlan& plan, GlobalDataSet& data, int task_id);
+
+private:
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    Executor(Executor&&) = delete;
+    Executor& operator=(Executor&&) = delete;
+
+private:
+    class Run;
+    class InlineRun;
+
+    bool runs_inline(const ExecutionPlan& plan, const RunOptions& options) const;
+    void check_replay(const ExecutionPlan& plan, const ScheduleLog& log) const;
+
+private:
+    WorkerPoolPtr m_pool;
+    ExecutorOptions m_options;
+    std::shared_ptr<TenantScheduler> m_tenants;
+};
+
+} // namespace tg::core
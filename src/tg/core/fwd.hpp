@@ -2,8 +2,6 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
-#include <typeinfo>
-#include <typeindex>
 #include <stdexcept>
 #include <mutex>
 #include <string>
@@ -11,6 +9,7 @@
 #include <unordered_map>
 
 #include "tg/core/task_data_flags.hpp"
+#include "tg/core/type_id.hpp"
 
 namespace tg::core
 {
@@ -18,6 +17,8 @@ namespace tg::core
 class Task;
 using TaskPtr = std::shared_ptr<Task>;
 
+class AsyncTask;
+
 class TaskData;
 using TaskDataPtr = std::shared_ptr<TaskData>;
 
@@ -27,6 +28,47 @@ using TaskDataSetPtr = std::shared_ptr<TaskDataSet>;
 class Subgraph;
 using SubgraphPtr = std::shared_ptr<Subgraph>;
 
+class TaskGraph;
+
+class GlobalDataSet;
+using GlobalDataSetPtr = std::shared_ptr<GlobalDataSet>;
+
+struct ExecutionPlan;
+using ExecutionPlanPtr = std::shared_ptr<const ExecutionPlan>;
+
+class MappedPlanFile;
+
+class ScheduleLog;
+
+struct SpillCodec;
+class SpillRegion;
+using SpillRegionPtr = std::shared_ptr<SpillRegion>;
+class SpillStore;
+using SpillStorePtr = std::shared_ptr<SpillStore>;
+
+struct SharedHandle;
+class SharedMemoryPool;
+
+class UnixChannel;
+using UnixChannelPtr = std::shared_ptr<UnixChannel>;
+
+struct GraphPartition;
+
+class WorkerPool;
+using WorkerPoolPtr = std::shared_ptr<WorkerPool>;
+
+class Executor;
+
+class ImageBuffer;
+
+class ScratchArena;
+
+struct LockSiteStats;
+
+class Tenant;
+using TenantPtr = std::shared_ptr<Tenant>;
+class TenantScheduler;
+
 template <typename T> class TaskInput;
 template <typename T> class TaskOutput;
 
@@ -1,12 +1,219 @@
 #include "tg/core/global_dataset.hpp"
+#include "tg/core/spill_store.hpp"
 
 namespace tg::core
 {
 
+struct GlobalDataSet::Slot
+{
+    mutable MutexType mutex;
+
+    /**
+     * @note Mutable because try_get() faults a spilled value back in.
+     */
+    mutable std::shared_ptr<void> value;
+
+    TypeId type;
+    const SpillCodec* codec;
+    std::size_t byte_size;
+    SpillRegionPtr spilled;  ///< Set while the value is in the spill store.
+};
+
 GlobalDataSet::GlobalDataSet()
+    : m_frozen{false}
+    , m_keys{}
+    , m_index{}
+    , m_slots{}
+    , m_resident_bytes{0u}
 {}
 
 GlobalDataSet::~GlobalDataSet()
 {}
 
+int GlobalDataSet::add(const std::string& name)
+{
+    if (m_frozen)
+    {
+        throw std::logic_error("GlobalDataSet::add(): cannot add keys after freeze().");
+    }
+    auto iter = m_index.find(name);
+    if (iter != m_index.end())
+    {
+        return iter->second;
+    }
+    int index = static_cast<int>(m_keys.size());
+    m_keys.push_back(name);
+    m_index.emplace(name, index);
+    return index;
+}
+
+void GlobalDataSet::freeze()
+{
+    if (m_frozen)
+    {
+        return;
+    }
+    m_slots = std::make_unique<Slot[]>(m_keys.size());
+    if constexpr (LockProfiler::enabled())
+    {
+        for (std::size_t k = 0u; k < m_keys.size(); ++k)
+        {
+            m_slots[k].mutex.set_site("GlobalDataSet:", m_keys[k]);
+        }
+    }
+    m_frozen = true;
+}
+
+bool GlobalDataSet::is_frozen() const
+{
+    return m_frozen;
+}
+
+std::size_t GlobalDataSet::size() const
+{
+    return m_keys.size();
+}
+
+int GlobalDataSet::find(const std::string& name) const
+{
+    auto iter = m_index.find(name);
+    return (iter == m_index.end()) ? -1 : iter->second;
+}
+
+const std::string& GlobalDataSet::name_of(int index) const
+{
+    if (index < 0 || static_cast<std::size_t>(index) >= m_keys.size())
+    {
+        throw std::out_of_range("GlobalDataSet::name_of(): bad index " + std::to_string(index));
+    }
+    return m_keys[index];
+}
+
+const GlobalDataSet::Slot& GlobalDataSet::slot_at(int index) const
+{
+    if (!m_frozen)
+    {
+        throw std::logic_error("GlobalDataSet: values cannot be accessed before freeze().");
+    }
+    if (index < 0 || static_cast<std::size_t>(index) >= m_keys.size())
+    {
+        throw std::out_of_range("GlobalDataSet: bad index " + std::to_string(index));
+    }
+    return m_slots[index];
+}
+
+GlobalDataSet::Slot& GlobalDataSet::slot_at(int index)
+{
+    return const_cast<Slot&>(static_cast<const GlobalDataSet*>(this)->slot_at(index));
+}
+
+bool GlobalDataSet::try_assign(int index, std::shared_ptr<void> value, TypeId actual_type)
+{
+    return this->try_assign(index, std::move(value), actual_type, nullptr, 0u);
+}
+
+bool GlobalDataSet::try_assign(int index, std::shared_ptr<void> value, TypeId actual_type,
+    const SpillCodec* codec, std::size_t byte_size)
+{
+    auto& slot = this->slot_at(index);
+    if (!value)
+    {
+        throw std::invalid_argument("GlobalDataSet::try_assign(): value cannot be null.");
+    }
+    LockType lock(slot.mutex);
+    if (slot.value || slot.spilled)
+    {
+        return false;
+    }
+    slot.value = std::move(value);
+    slot.type = actual_type;
+    slot.codec = codec;
+    slot.byte_size = byte_size;
+    m_resident_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+    return true;
+}
+
+bool GlobalDataSet::try_get(int index, std::shared_ptr<void>& out_value, TypeId& out_type) const
+{
+    const auto& slot = this->slot_at(index);
+    LockType lock(slot.mutex);
+    if (!slot.value)
+    {
+        if (!slot.spilled)
+        {
+            return false;
+        }
+        slot.value = slot.spilled->store().read(*slot.codec, slot.spilled);
+        m_resident_bytes.fetch_add(slot.byte_size, std::memory_order_relaxed);
+    }
+    out_value = slot.value;
+    out_type = slot.type;
+    return true;
+}
+
+void GlobalDataSet::release(int index)
+{
+    auto& slot = this->slot_at(index);
+    std::shared_ptr<void> value;
+    SpillRegionPtr spilled;
+    {
+        LockType lock(slot.mutex);
+        if (slot.value)
+        {
+            m_resident_bytes.fetch_sub(slot.byte_size, std::memory_order_relaxed);
+        }
+        value = std::move(slot.value);
+        spilled = std::move(slot.spilled);
+        slot.type = TypeId{};
+        slot.codec = nullptr;
+        slot.byte_size = 0u;
+    }
+    /**
+     * @note The value is destroyed outside of the lock.
+     */
+}
+
+bool GlobalDataSet::try_spill(int index, SpillStore& store)
+{
+    auto& slot = this->slot_at(index);
+    std::shared_ptr<void> value;
+    {
+        LockType lock(slot.mutex);
+        if (!slot.value || !slot.codec || slot.value.use_count() != 1)
+        {
+            return false;
+        }
+        /**
+         * @note A value restored from the store is still in it, and is
+         * dropped without being written again.
+         */
+        if (!slot.spilled)
+        {
+            slot.spilled = store.write(*slot.codec, slot.value.get());
+        }
+        value = std::move(slot.value);
+        m_resident_bytes.fetch_sub(slot.byte_size, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool GlobalDataSet::is_spillable(int index) const
+{
+    const auto& slot = this->slot_at(index);
+    LockType lock(slot.mutex);
+    return slot.value && slot.codec && slot.value.use_count() == 1;
+}
+
+bool GlobalDataSet::is_spilled(int index) const
+{
+    const auto& slot = this->slot_at(index);
+    LockType lock(slot.mutex);
+    return !slot.value && slot.spilled;
+}
+
+std::size_t GlobalDataSet::resident_bytes() const
+{
+    return m_resident_bytes.load(std::memory_order_relaxed);
+}
+
 } // namespace tg::core
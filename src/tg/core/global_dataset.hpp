@@ -1,20 +1,188 @@
 #pragma once
+#include <atomic>
 #include "tg/core/fwd.hpp"
+#include "tg/core/data_size_traits.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/core/spill_traits.hpp"
 
 namespace tg::core
 {
 
+/**
+ * @brief Holds the data exchanged between tasks during graph execution.
+ *
+ * @details
+ * GlobalDataSet has two phases.
+ *
+ * In the design phase, which is single-threaded, keys (data names) are
+ * added, each receiving a zero-based slot index in order of insertion.
+ *
+ * After freeze(), no key can be added, and the slots are accessed by index
+ * from many threads. The slot array itself is never modified after freeze,
+ * so that locating a slot does not require a lock; each slot has its own
+ * mutex that protects its value.
+ *
+ * Each value is stored type-erased, as a pair of std::shared_ptr<void>
+ * and TypeId.
+ *
+ * Under memory pressure, a value that nobody else holds can be spilled to a
+ * SpillStore, if its type supports it (see SpillTraits). The slot still
+ * counts as populated: try_get() faults the value back in transparently.
+ * The dataset keeps track of the estimated bytes of its resident values, to
+ * let the Executor decide when to spill.
+ */
 class GlobalDataSet
 {
+public:
+    using MutexType = SiteMutex;
+    using LockType = std::unique_lock<MutexType>;
+
 public:
     GlobalDataSet();
     ~GlobalDataSet();
 
+public:
+    /**
+     * @brief Adds a key in the design phase, and returns its slot index.
+     * @details Adding an existing key returns the existing index.
+     */
+    int add(const std::string& name);
+
+    /**
+     * @brief Ends the design phase.
+     */
+    void freeze();
+
+    bool is_frozen() const;
+
+    std::size_t size() const;
+
+    /**
+     * @brief Returns the slot index of a key, or -1 if not found.
+     */
+    int find(const std::string& name) const;
+
+    const std::string& name_of(int index) const;
+
+    /**
+     * @brief Assigns the value of a slot, if the slot is empty.
+     */
+    bool try_assign(int index, std::shared_ptr<void> value, TypeId actual_type);
+
+    /**
+     * @brief Assigns the value of a slot, if the slot is empty.
+     * @param codec How to spill the value, or null if it cannot be spilled.
+     * @param byte_size Estimated size of the value, counted in
+     * resident_bytes().
+     */
+    bool try_assign(int index, std::shared_ptr<void> value, TypeId actual_type,
+        const SpillCodec* codec, std::size_t byte_size);
+
+    /**
+     * @brief Reads out the value of a slot, if the slot is populated.
+     * @details A spilled value is restored first.
+     */
+    bool try_get(int index, std::shared_ptr<void>& out_value, TypeId& out_type) const;
+
+    /**
+     * @brief Releases the value of a slot.
+     */
+    void release(int index);
+
+    /**
+     * @brief Spills the value of a slot to the store, and drops it from
+     * memory.
+     * @return False if the slot is empty or already spilled, if its type
+     * cannot be spilled, or if the value is still referenced elsewhere, in
+     * which case spilling would not free memory.
+     */
+    bool try_spill(int index, SpillStore& store);
+
+    /**
+     * @brief Whether try_spill() would currently succeed on a slot, and
+     * free memory.
+     */
+    bool is_spillable(int index) const;
+
+    bool is_spilled(int index) const;
+
+    /**
+     * @brief Sum of the estimated sizes of the values held in memory.
+     */
+    std::size_t resident_bytes() const;
+
+    /**
+     * @brief Assigns a typed value by key.
+     */
+    template <typename T>
+    void set(const std::string& name, std::shared_ptr<T> value);
+
+    /**
+     * @brief Reads a typed value by key. Returns null if the slot is empty.
+     */
+    template <typename T>
+    std::shared_ptr<T> get(const std::string& name) const;
+
 private:
     GlobalDataSet(const GlobalDataSet&) = delete;
     GlobalDataSet(GlobalDataSet&&) = delete;
     GlobalDataSet& operator=(const GlobalDataSet&) = delete;
     GlobalDataSet& operator=(GlobalDataSet&&) = delete;
+
+private:
+    struct Slot;
+
+    const Slot& slot_at(int index) const;
+    Slot& slot_at(int index);
+
+private:
+    bool m_frozen;
+    std::vector<std::string> m_keys;
+    std::unordered_map<std::string, int> m_index;
+    std::unique_ptr<Slot[]> m_slots;
+    mutable std::atomic<std::size_t> m_resident_bytes;
 };
 
+template <typename T>
+void GlobalDataSet::set(const std::string& name, std::shared_ptr<T> value)
+{
+    int index = this->find(name);
+    if (index < 0)
+    {
+        throw std::out_of_range("GlobalDataSet::set(): unknown name " + name);
+    }
+    using ValueType = std::remove_const_t<T>;
+    std::size_t byte_size = value ? DataSizeTraits<ValueType>::byte_size(*value) : 0u;
+    std::shared_ptr<void> vp = std::const_pointer_cast<void>(
+        std::static_pointer_cast<const void>(std::move(value)));
+    if (!this->try_assign(index, std::move(vp), TypeId::of<ValueType>(),
+            SpillCodec::of<ValueType>(), byte_size))
+    {
+        throw std::runtime_error("GlobalDataSet::set(): already assigned: " + name);
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> GlobalDataSet::get(const std::string& name) const
+{
+    int index = this->find(name);
+    if (index < 0)
+    {
+        throw std::out_of_range("GlobalDataSet::get(): unknown name " + name);
+    }
+    std::shared_ptr<void> out_value;
+    TypeId out_type;
+    if (!this->try_get(index, out_value, out_type))
+    {
+        return nullptr;
+    }
+    if (out_type != TypeId::of<std::remove_const_t<T>>())
+    {
+        std::string str_expected{type_name<T>()};
+        throw std::runtime_error("GlobalDataSet::get(): type mismatch. Expected: " +
+            str_expected + ", got: " + to_string(out_type));
+    }
+    return std::static_pointer_cast<T>(out_value);
+}
+
 } // namespace tg::core
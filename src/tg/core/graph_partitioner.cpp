@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <numeric>
+#include "tg/core/graph_partitioner.hpp"
+#include "tg/core/execution_plan.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+/**
+ * @brief The partitioning problem, with fused chains collapsed into units.
+ */
+class PartitionState
+{
+public:
+    PartitionState(const ExecutionPlan& plan, const std::vector<double>& costs,
+        const std::vector<std::uint64_t>& bytes, std::size_t parts)
+        : m_parts{parts}
+        , m_unit_of_task(plan.tasks.size(), -1)
+        , m_unit_cost{}
+        , m_order{}
+        , m_slot_bytes{}
+        , m_producer(plan.slots.size(), -1)
+        , m_readers(plan.slots.size())
+        , m_unit_inputs{}
+        , m_unit_outputs{}
+        , m_part{}
+        , m_reader_count(plan.slots.size() * parts, 0)
+        , m_loads(parts, 0.0)
+    {
+        for (int head : plan.topological_order)
+        {
+            if (plan.tasks[head].fused_prev >= 0)
+            {
+                continue;
+            }
+            int unit = static_cast<int>(m_unit_cost.size());
+            m_unit_cost.push_back(0.0);
+            m_order.push_back(unit);
+            for (int task_id = head; task_id >= 0; task_id = plan.tasks[task_id].fused_next)
+            {
+                m_unit_of_task[task_id] = unit;
+                m_unit_cost[unit] += costs.empty() ? 1.0 : costs[task_id];
+            }
+        }
+        m_unit_inputs.resize(m_unit_cost.size());
+        m_unit_outputs.resize(m_unit_cost.size());
+        m_part.assign(m_unit_cost.size(), -1);
+        m_slot_bytes.resize(plan.slots.size());
+        for (std::size_t slot = 0u; slot < plan.slots.size(); ++slot)
+        {
+            m_slot_bytes[slot] = bytes.empty() ? 1u : bytes[slot];
+            if (plan.slots[slot].fused)
+            {
+                continue;
+            }
+            int producer = plan.slots[slot].producer;
+            if (producer >= 0)
+            {
+                m_producer[slot] = m_unit_of_task[producer];
+                m_unit_outputs[m_producer[slot]].push_back(static_cast<int>(slot));
+            }
+        }
+        for (std::size_t task_id = 0u; task_id < plan.tasks.size(); ++task_id)
+        {
+            int unit = m_unit_of_task[task_id];
+            for (int slot : plan.tasks[task_id].input_slots)
+            {
+                auto& readers = m_readers[slot];
+                if (!plan.slots[slot].fused && std::find(readers.begin(), readers.end(), unit) == readers.end())
+                {
+                    readers.push_back(unit);
+                    m_unit_inputs[unit].push_back(slot);
+                }
+            }
+        }
+    }
+
+    double total_cost() const
+    {
+        return std::accumulate(m_unit_cost.begin(), m_unit_cost.end(), 0.0);
+    }
+
+    /**
+     * @brief Places units in topological order, each on the part with
+     * room that already holds most of its input bytes.
+     */
+    void place_greedily(double capacity)
+    {
+        std::vector<std::uint64_t> affinity(m_parts);
+        for (int unit : m_order)
+        {
+            std::fill(affinity.begin(), affinity.end(), 0u);
+            for (int slot : m_unit_inputs[unit])
+            {
+                for (std::size_t part = 0u; part < m_parts; ++part)
+                {
+                    if (this->holds(slot, static_cast<int>(part)))
+                    {
+                        affinity[part] += m_slot_bytes[slot];
+                    }
+                }
+            }
+            int best = -1;
+            for (std::size_t part = 0u; part < m_parts; ++part)
+            {
+                if (m_loads[part] + m_unit_cost[unit] > capacity)
+                {
+                    continue;
+                }
+                if (best < 0 || affinity[part] > affinity[best] ||
+                    (affinity[part] == affinity[best] && m_loads[part] < m_loads[best]))
+                {
+                    best = static_cast<int>(part);
+                }
+            }
+            if (best < 0)
+            {
+                best = static_cast<int>(std::min_element(m_loads.begin(), m_loads.end()) - m_loads.begin());
+            }
+            this->assign(unit, best);
+        }
+    }
+
+    /**
+     * @brief Moves single units to the part that reduces the cut the most,
+     * within capacity.
+     * @return Whether any move was made.
+     */
+    bool refine(double capacity)
+    {
+        bool improved = false;
+        for (int unit : m_order)
+        {
+            int current = m_part[unit];
+            std::int64_t before = this->incident_cost(unit);
+            std::int64_t best_delta = 0;
+            int best = -1;
+            for (std::size_t part = 0u; part < m_parts; ++part)
+            {
+                if (static_cast<int>(part) == current || m_loads[part] + m_unit_cost[unit] > capacity)
+                {
+                    continue;
+                }
+                this->assign(unit, static_cast<int>(part));
+                std::int64_t delta = this->incident_cost(unit) - before;
+                this->assign(unit, current);
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    best = static_cast<int>(part);
+                }
+            }
+            if (best >= 0)
+            {
+                this->assign(unit, best);
+                improved = true;
+            }
+        }
+        return improved;
+    }
+
+    GraphPartition result(std::size_t task_count) const
+    {
+        GraphPartition partition;
+        partition.part_of_task.resize(task_count);
+        for (std::size_t task_id = 0u; task_id < task_count; ++task_id)
+        {
+            partition.part_of_task[task_id] = m_part[m_unit_of_task[task_id]];
+        }
+        partition.loads = m_loads;
+        for (std::size_t slot = 0u; slot < m_readers.size(); ++slot)
+        {
+            partition.cut_bytes += static_cast<std::uint64_t>(this->slot_cost(static_cast<int>(slot)));
+        }
+        return partition;
+    }
+
+private:
+    /**
+     * @brief Moves a unit, updating loads and reader counts. A unit that
+     * is not placed yet has part -1.
+     */
+    void assign(int unit, int part)
+    {
+        int previous = m_part[unit];
+        if (previous >= 0)
+        {
+            m_loads[previous] -= m_unit_cost[unit];
+            for (int slot : m_unit_inputs[unit])
+            {
+                --m_reader_count[slot * m_parts + previous];
+            }
+        }
+        m_part[unit] = part;
+        m_loads[part] += m_unit_cost[unit];
+        for (int slot : m_unit_inputs[unit])
+        {
+            ++m_reader_count[slot * m_parts + part];
+        }
+    }
+
+    int producer_part(int slot) const
+    {
+        return m_producer[slot] >= 0 ? m_part[m_producer[slot]] : -1;
+    }
+
+    /**
+     * @brief Whether a part already has the value of a slot.
+     */
+    bool holds(int slot, int part) const
+    {
+        return this->producer_part(slot) == part || m_reader_count[slot * m_parts + part] > 0;
+    }
+
+    std::int64_t slot_cost(int slot) const
+    {
+        int producer_part = this->producer_part(slot);
+        std::int64_t remote_parts = 0;
+        for (std::size_t part = 0u; part < m_parts; ++part)
+        {
+            if (static_cast<int>(part) != producer_part && m_reader_count[slot * m_parts + part] > 0)
+            {
+                ++remote_parts;
+            }
+        }
+        return remote_parts * static_cast<std::int64_t>(m_slot_bytes[slot]);
+    }
+
+    std::int64_t incident_cost(int unit) const
+    {
+        std::int64_t cost = 0;
+        for (int slot : m_unit_inputs[unit])
+        {
+            cost += this->slot_cost(slot);
+        }
+        for (int slot : m_unit_outputs[unit])
+        {
+            cost += this->slot_cost(slot);
+        }
+        return cost;
+    }
+
+private:
+    std::size_t m_parts;
+    std::vector<int> m_unit_of_task;
+    std::vector<double> m_unit_cost;
+    std::vector<int> m_order;  ///< Units in topological order.
+    std::vector<std::uint64_t> m_slot_bytes;
+    std::vector<int> m_producer;  ///< Per slot: producing unit, or -1.
+    std::vector<std::vector<int>> m_readers;  ///< Per slot: distinct reading units.
+    std::vector<std::vector<int>> m_unit_inputs;  ///< Per unit: distinct slots read.
+    std::vector<std::vector<int>> m_unit_outputs;  ///< Per unit: non-fused slots produced.
+    std::vector<int> m_part;  ///< Per unit.
+    std::vector<int> m_reader_count;  ///< Per slot and part: reading units.
+    std::vector<double> m_loads;  ///< Per part.
+};
+
+} // namespace
+
+GraphPartitioner::GraphPartitioner(const ExecutionPlan& plan)
+    : m_plan{plan}
+    , m_costs{}
+    , m_bytes{}
+{
+}
+
+GraphPartitioner::~GraphPartitioner()
+{
+}
+
+void GraphPartitioner::set_task_costs(std::vector<double> costs)
+{
+    if (costs.size() != m_plan.tasks.size())
+    {
+        throw std::invalid_argument("GraphPartitioner::set_task_costs(): one cost per task is required.");
+    }
+    m_costs = std::move(costs);
+}
+
+void GraphPartitioner::set_slot_bytes(std::vector<std::uint64_t> bytes)
+{
+    if (bytes.size() != m_plan.slots.size())
+    {
+        throw std::invalid_argument("GraphPartitioner::set_slot_bytes(): one size per slot is required.");
+    }
+    m_bytes = std::move(bytes);
+}
+
+GraphPartition GraphPartitioner::partition(const PartitionOptions& options) const
+{
+    if (options.parts == 0u)
+    {
+        throw std::invalid_argument("GraphPartitioner::partition(): at least one part is required.");
+    }
+    PartitionState state{m_plan, m_costs, m_bytes, options.parts};
+    double capacity = (1.0 + options.imbalance) * state.total_cost() / static_cast<double>(options.parts);
+    state.place_greedily(capacity);
+    for (int pass = 0; pass < options.refinement_passes && state.refine(capacity); ++pass)
+    {
+    }
+    return state.result(m_plan.tasks.size());
+}
+
+} // namespace tg::core
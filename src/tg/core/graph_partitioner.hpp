@@ -0,0 +1,91 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+struct PartitionOptions
+{
+    /**
+     * @brief Number of parts, typically one per worker process.
+     */
+    std::size_t parts = 2u;
+
+    /**
+     * @brief Allowed excess of a part's load over the average, as a
+     * fraction. A single unit heavier than that is still placed.
+     */
+    double imbalance = 0.05;
+
+    /**
+     * @brief Maximum number of refinement passes.
+     */
+    int refinement_passes = 8;
+};
+
+/**
+ * @brief An assignment of the tasks of a plan to parts.
+ */
+struct GraphPartition
+{
+    std::vector<int> part_of_task;  ///< Per task of the plan.
+    std::vector<double> loads;  ///< Per part: sum of the task costs.
+
+    /**
+     * @brief Bytes crossing part boundaries: each value is counted once for
+     * every part, other than its producer's, that reads it. Graph inputs
+     * are counted for every part that reads them.
+     */
+    std::uint64_t cut_bytes = 0u;
+};
+
+/**
+ * @brief Assigns the tasks of a compiled plan to parts, balancing the load
+ * while minimizing the bytes crossing part boundaries.
+ *
+ * @details
+ * The unit of assignment is a fused chain (see PlanTask::fused_next), whose
+ * values are handed over inline and must not be split. The partitioner
+ * first places units greedily in topological order, each on the part it
+ * reads the most bytes from, among the parts with room left. It then
+ * refines the cut by moving single units to the part that reduces the cut
+ * the most, as long as the balance holds, in the style of
+ * Fiduccia-Mattheyses, until a pass finds no improving move.
+ *
+ * Task costs and value sizes are estimates supplied by the caller; both
+ * default to one.
+ */
+class GraphPartitioner
+{
+public:
+    explicit GraphPartitioner(const ExecutionPlan& plan);
+    ~GraphPartitioner();
+
+    /**
+     * @param costs Per task of the plan.
+     */
+    void set_task_costs(std::vector<double> costs);
+
+    /**
+     * @param bytes Per slot of the plan.
+     */
+    void set_slot_bytes(std::vector<std::uint64_t> bytes);
+
+    /**
+     * @throws std::invalid_argument if there are no parts.
+     */
+    GraphPartition partition(const PartitionOptions& options = PartitionOptions{}) const;
+
+private:
+    GraphPartitioner(const GraphPartitioner&) = delete;
+    GraphPartitioner& operator=(const GraphPartitioner&) = delete;
+    GraphPartitioner(GraphPartitioner&&) = delete;
+    GraphPartitioner& operator=(GraphPartitioner&&) = delete;
+
+private:
+    const ExecutionPlan& m_plan;
+    std::vector<double> m_costs;
+    std::vector<std::uint64_t> m_bytes;
+};
+
+} // namespace tg::core
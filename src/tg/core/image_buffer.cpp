@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <new>
+#if defined(LINUX)
+#include <sys/mman.h>
+#endif
+#include "tg/core/image_buffer.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+std::size_t round_up(std::size_t value, std::size_t multiple)
+{
+    return (value + multiple - 1u) / multiple * multiple;
+}
+
+std::shared_ptr<void> allocate_aligned(std::size_t size)
+{
+    void* p = ::operator new(size, std::align_val_t{ImageBuffer::alignment});
+    std::memset(p, 0, size);
+    return std::shared_ptr<void>(p, [](void* q) { ::operator delete(q, std::align_val_t{ImageBuffer::alignment}); });
+}
+
+/**
+ * @return Null if huge pages are not available.
+ * @note Anonymous mappings are zero-filled.
+ */
+std::shared_ptr<void> allocate_huge(std::size_t size)
+{
+#if defined(LINUX)
+    constexpr std::size_t huge_page_size = std::size_t{2u} << 20u;
+    std::size_t capacity = round_up(size, huge_page_size);
+    void* addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        ::madvise(addr, capacity, MADV_HUGEPAGE);
+    }
+    return std::shared_ptr<void>(addr, [capacity](void* p) { ::munmap(p, capacity); });
+#else
+    (void)size;
+    return nullptr;
+#endif
+}
+
+} // namespace
+
+ImageBuffer::ImageBuffer()
+    : m_storage{}
+    , m_data{nullptr}
+    , m_width{0}
+    , m_height{0}
+    , m_pixel_bytes{0u}
+    , m_stride{0u}
+{
+}
+
+ImageBuffer::ImageBuffer(std::shared_ptr<void> storage, char* data, int width, int height,
+    std::size_t pixel_bytes, std::size_t stride)
+    : m_storage{std::move(storage)}
+    , m_data{data}
+    , m_width{width}
+    , m_height{height}
+    , m_pixel_bytes{pixel_bytes}
+    , m_stride{stride}
+{
+}
+
+ImageBuffer ImageBuffer::allocate(int width, int height, std::size_t pixel_bytes,
+    const ImageAllocation& allocation)
+{
+    if (width < 0 || height < 0 || pixel_bytes == 0u)
+    {
+        throw std::invalid_argument("ImageBuffer::allocate(): invalid size.");
+    }
+    std::size_t stride = round_up(static_cast<std::size_t>(width) * pixel_bytes, alignment);
+    std::size_t size = std::max<std::size_t>(stride * static_cast<std::size_t>(height), 1u);
+    std::shared_ptr<void> storage;
+    if (allocation.huge_pages)
+    {
+        storage = allocate_huge(size);
+    }
+    if (!storage)
+    {
+        storage = allocate_aligned(size);
+    }
+    char* data = static_cast<char*>(storage.get());
+    return ImageBuffer{std::move(storage), data, width, height, pixel_bytes, stride};
+}
+
+ImageBuffer ImageBuffer::wrap(std::shared_ptr<void> storage, void* data, int width, int height,
+    std::size_t pixel_bytes, std::size_t stride)
+{
+    if (width < 0 || height < 0 || pixel_bytes == 0u ||
+        stride < static_cast<std::size_t>(width) * pixel_bytes)
+    {
+        throw std::invalid_argument("ImageBuffer::wrap(): invalid size or stride.");
+    }
+    return ImageBuffer{std::move(storage), static_cast<char*>(data), width, height, pixel_bytes, stride};
+}
+
+bool ImageBuffer::empty() const
+{
+    return m_width == 0 || m_height == 0;
+}
+
+int ImageBuffer::width() const
+{
+    return m_width;
+}
+
+int ImageBuffer::height() const
+{
+    return m_height;
+}
+
+std::size_t ImageBuffer::pixel_bytes() const
+{
+    return m_pixel_bytes;
+}
+
+std::size_t ImageBuffer::stride() const
+{
+    return m_stride;
+}
+
+std::size_t ImageBuffer::row_bytes() const
+{
+    return static_cast<std::size_t>(m_width) * m_pixel_bytes;
+}
+
+bool ImageBuffer::is_contiguous() const
+{
+    return m_height <= 1 || m_stride == this->row_bytes();
+}
+
+bool ImageBuffer::is_aligned() const
+{
+    return reinterpret_cast<std::uintptr_t>(m_data) % alignment == 0u &&
+        (m_height <= 1 || m_stride % alignment == 0u);
+}
+
+char* ImageBuffer::data() const
+{
+    return m_data;
+}
+
+char* ImageBuffer::row(int y) const
+{
+    return m_data + static_cast<std::ptrdiff_t>(y) * static_cast<std::ptrdiff_t>(m_stride);
+}
+
+ImageBuffer ImageBuffer::roi(int x, int y, int width, int height) const
+{
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x > m_width - width || y > m_height - height)
+    {
+        throw std::out_of_range("ImageBuffer::roi(): rectangle out of the buffer.");
+    }
+    char* data = this->row(y) + static_cast<std::size_t>(x) * m_pixel_bytes;
+    return ImageBuffer{m_storage, data, width, height, m_pixel_bytes, m_stride};
+}
+
+/**
+ * @details A default-constructed buffer has no pixel size to allocate with,
+ * and clones to another one. An empty view of a real buffer keeps its size
+ * and pixel size.
+ */
+ImageBuffer ImageBuffer::clone(const ImageAllocation& allocation) const
+{
+    if (m_pixel_bytes == 0u)
+    {
+        return ImageBuffer{};
+    }
+    ImageBuffer copy = ImageBuffer::allocate(m_width, m_height, m_pixel_bytes, allocation);
+    this->copy_to(copy);
+    return copy;
+}
+
+void ImageBuffer::copy_to(const ImageBuffer& dst) const
+{
+    if (dst.m_width != m_width || dst.m_height != m_height || dst.m_pixel_bytes != m_pixel_bytes)
+    {
+        throw std::invalid_argument("ImageBuffer::copy_to(): size mismatch.");
+    }
+    if (this->empty())
+    {
+        return;
+    }
+    if (this->is_contiguous() && dst.is_contiguous())
+    {
+        std::memmove(dst.m_data, m_data, this->row_bytes() * static_cast<std::size_t>(m_height));
+        return;
+    }
+    for (int y = 0; y < m_height; ++y)
+    {
+        std::memmove(dst.row(y), this->row(y), this->row_bytes());
+    }
+}
+
+bool ImageBuffer::shares_storage_with(const ImageBuffer& other) const
+{
+    return m_storage && !m_storage.owner_before(other.m_storage) && !other.m_storage.owner_before(m_storage);
+}
+
+} // namespace tg::core
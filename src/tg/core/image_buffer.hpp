@@ -0,0 +1,222 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include "tg/core/fwd.hpp"
+#include "tg/core/data_size_traits.hpp"
+#include "tg/core/spill_traits.hpp"
+
+namespace tg::core
+{
+
+struct ImageAllocation
+{
+    /**
+     * @brief Back the buffer with huge pages where the platform allows it.
+     * @details On Linux, explicit huge pages are tried first, then
+     * transparent huge pages are requested; a regular mapping is used if
+     * neither is available.
+     */
+    bool huge_pages = false;
+};
+
+/**
+ * @brief A 2D pixel buffer with padded, aligned rows, and O(1) views of its
+ * sub-regions.
+ *
+ * @details
+ * An ImageBuffer is a handle: it refers to refcounted storage, the first
+ * pixel of the image in it, its size in pixels, the size of a pixel in
+ * bytes, and the stride between rows in bytes. Copying an ImageBuffer, or
+ * taking a roi(), shares the storage without copying the pixels, so that
+ * tiles, crops and pyramid levels can be passed between tasks for free.
+ * Use clone() for a deep copy.
+ *
+ * Buffers made by allocate() start on a 64-byte boundary, and their stride
+ * is a multiple of 64 bytes, so every row is aligned for SIMD loads. A view
+ * is aligned if its left edge is.
+ *
+ * As a task value, an ImageBuffer is passed as std::shared_ptr<ImageBuffer>
+ * like any other type; writing through a view is visible in every view of
+ * the same storage, so a task writing into its input must own it.
+ */
+class ImageBuffer
+{
+public:
+    static constexpr std::size_t alignment = 64u;
+
+    /**
+     * @brief An empty buffer, with no storage.
+     */
+    ImageBuffer();
+
+    /**
+     * @brief Allocates a zero-filled buffer.
+     * @throws std::invalid_argument if a dimension is negative, or the pixel
+     * size is zero.
+     * @throws std::bad_alloc if memory cannot be allocated.
+     */
+    static ImageBuffer allocate(int width, int height, std::size_t pixel_bytes,
+        const ImageAllocation& allocation = ImageAllocation{});
+
+    /**
+     * @brief Refers to pixels in storage owned by the caller, for example a
+     * block of a SharedMemoryPool.
+     * @param data The first pixel; must lie in @p storage, which is kept
+     * alive by the buffer and its views.
+     * @throws std::invalid_argument if the stride is smaller than a row.
+     */
+    static ImageBuffer wrap(std::shared_ptr<void> storage, void* data, int width, int height,
+        std::size_t pixel_bytes, std::size_t stride);
+
+    bool empty() const;
+    int width() const;
+    int height() const;
+    std::size_t pixel_bytes() const;
+
+    /**
+     * @brief Bytes between the starts of two consecutive rows.
+     */
+    std::size_t stride() const;
+
+    /**
+     * @brief Bytes of pixels in a row, without padding.
+     */
+    std::size_t row_bytes() const;
+
+    /**
+     * @brief Whether the rows follow each other without padding.
+     */
+    bool is_contiguous() const;
+
+    /**
+     * @brief Whether every row starts on an alignment boundary.
+     */
+    bool is_aligned() const;
+
+    char* data() const;
+
+    char* row(int y) const;
+
+    template <typename T>
+    T* row(int y) const
+    {
+        return reinterpret_cast<T*>(this->row(y));
+    }
+
+    /**
+     * @note Not bounds-checked, like row().
+     */
+    template <typename T>
+    T& at(int x, int y) const
+    {
+        return this->row<T>(y)[x];
+    }
+
+    /**
+     * @brief A view of the rectangle at (@p x, @p y), sharing the storage.
+     * @throws std::out_of_range if the rectangle is not inside the buffer.
+     */
+    ImageBuffer roi(int x, int y, int width, int height) const;
+
+    /**
+     * @brief A newly allocated, aligned copy of the pixels of this view.
+     */
+    ImageBuffer clone(const ImageAllocation& allocation = ImageAllocation{}) const;
+
+    /**
+     * @brief Copies the pixels into @p dst, row by row.
+     * @throws std::invalid_argument if the sizes differ.
+     */
+    void copy_to(const ImageBuffer& dst) const;
+
+    /**
+     * @brief Whether two buffers share storage.
+     */
+    bool shares_storage_with(const ImageBuffer& other) const;
+
+private:
+    ImageBuffer(std::shared_ptr<void> storage, char* data, int width, int height,
+        std::size_t pixel_bytes, std::size_t stride);
+
+private:
+    std::shared_ptr<void> m_storage;
+    char* m_data;
+    int m_width;
+    int m_height;
+    std::size_t m_pixel_bytes;
+    std::size_t m_stride;
+};
+
+/**
+ * @brief Reports the bytes spanned by the rows of the view.
+ */
+template <>
+struct DataSizeTraits<ImageBuffer>
+{
+    static std::size_t byte_size(const ImageBuffer& value)
+    {
+        return static_cast<std::size_t>(value.height()) * value.stride();
+    }
+};
+
+/**
+ * @brief Spills the pixels of the view, after a header padded to the
+ * alignment, with the stride of a fresh allocation.
+ * @details Restored buffers alias the mapped bytes, and are aligned if
+ * those are, as spill file regions are.
+ */
+template <>
+struct SpillTraits<ImageBuffer>
+{
+    struct Header
+    {
+        std::int32_t width;
+        std::int32_t height;
+        std::uint64_t pixel_bytes;
+        std::uint64_t stride;
+    };
+
+    static constexpr bool enabled = true;
+
+    static std::size_t spill_size(const ImageBuffer& value)
+    {
+        return ImageBuffer::alignment + static_cast<std::size_t>(value.height()) * packed_stride(value);
+    }
+
+    static void spill(const ImageBuffer& value, void* dst)
+    {
+        std::size_t stride = packed_stride(value);
+        Header header{value.width(), value.height(), value.pixel_bytes(), stride};
+        std::memcpy(dst, &header, sizeof(header));
+        char* rows = static_cast<char*>(dst) + ImageBuffer::alignment;
+        for (int y = 0; y < value.height(); ++y)
+        {
+            std::memcpy(rows + static_cast<std::size_t>(y) * stride, value.row(y), value.row_bytes());
+        }
+    }
+
+    static std::shared_ptr<ImageBuffer> restore(std::shared_ptr<void> bytes, std::size_t size)
+    {
+        Header header{};
+        if (size < ImageBuffer::alignment)
+        {
+            throw std::runtime_error("SpillTraits<ImageBuffer>::restore(): truncated value.");
+        }
+        std::memcpy(&header, bytes.get(), sizeof(header));
+        if (size < ImageBuffer::alignment + static_cast<std::size_t>(header.height) * header.stride)
+        {
+            throw std::runtime_error("SpillTraits<ImageBuffer>::restore(): truncated value.");
+        }
+        char* rows = static_cast<char*>(bytes.get()) + ImageBuffer::alignment;
+        return std::make_shared<ImageBuffer>(ImageBuffer::wrap(std::move(bytes), rows, header.width,
+            header.height, header.pixel_bytes, header.stride));
+    }
+
+private:
+    static std::size_t packed_stride(const ImageBuffer& value)
+    {
+        return (value.row_bytes() + ImageBuffer::alignment - 1u) / ImageBuffer::alignment * ImageBuffer::alignment;
+    }
+};
+
+} // namespace tg::core
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include "tg/core/lock_profiler.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+struct SiteRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<LockSite>> sites;
+};
+
+/**
+ * @note Never destroyed, so that mutexes of static objects can still be
+ * used during exit.
+ */
+SiteRegistry& registry()
+{
+    static SiteRegistry* instance = new SiteRegistry{};
+    return *instance;
+}
+
+} // namespace
+
+LockSite& LockProfiler::site(const std::string& name)
+{
+    SiteRegistry& r = registry();
+    std::unique_lock<std::mutex> lock(r.mutex);
+    auto& site = r.sites[name];
+    if (!site)
+    {
+        site = std::make_unique<LockSite>();
+        site->name = name;
+    }
+    return *site;
+}
+
+std::vector<LockSiteStats> LockProfiler::snapshot()
+{
+    SiteRegistry& r = registry();
+    std::vector<LockSiteStats> stats;
+    {
+        std::unique_lock<std::mutex> lock(r.mutex);
+        stats.reserve(r.sites.size());
+        for (const auto& entry : r.sites)
+        {
+            const LockSite& site = *entry.second;
+            stats.push_back(LockSiteStats{site.name,
+                site.acquisitions.load(std::memory_order_relaxed),
+                site.contended.load(std::memory_order_relaxed),
+                site.total_wait_ns.load(std::memory_order_relaxed),
+                site.max_wait_ns.load(std::memory_order_relaxed)});
+        }
+    }
+    std::sort(stats.begin(), stats.end(),
+        [](const LockSiteStats& a, const LockSiteStats& b) { return a.name < b.name; });
+    return stats;
+}
+
+std::vector<LockSiteStats> LockProfiler::since(const std::vector<LockSiteStats>& before)
+{
+    std::vector<LockSiteStats> after = LockProfiler::snapshot();
+    std::vector<LockSiteStats> delta;
+    auto prior = before.begin();
+    for (auto& stats : after)
+    {
+        while (prior != before.end() && prior->name < stats.name)
+        {
+            ++prior;
+        }
+        if (prior != before.end() && prior->name == stats.name)
+        {
+            stats.acquisitions -= prior->acquisitions;
+            stats.contended -= prior->contended;
+            stats.total_wait_ns -= prior->total_wait_ns;
+        }
+        if (stats.acquisitions > 0u)
+        {
+            delta.push_back(std::move(stats));
+        }
+    }
+    std::stable_sort(delta.begin(), delta.end(), [](const LockSiteStats& a, const LockSiteStats& b)
+        { return a.total_wait_ns > b.total_wait_ns; });
+    return delta;
+}
+
+ProfiledMutex::ProfiledMutex()
+    : m_mutex{}
+    , m_site{&LockProfiler::site("unnamed")}
+{
+}
+
+ProfiledMutex::ProfiledMutex(const std::string& site)
+    : m_mutex{}
+    , m_site{&LockProfiler::site(site)}
+{
+}
+
+ProfiledMutex::ProfiledMutex(const char* prefix, const std::string& name)
+    : m_mutex{}
+    , m_site{&LockProfiler::site(prefix + name)}
+{
+}
+
+void ProfiledMutex::set_site(const std::string& site)
+{
+    m_site = &LockProfiler::site(site);
+}
+
+void ProfiledMutex::set_site(const char* prefix, const std::string& name)
+{
+    m_site = &LockProfiler::site(prefix + name);
+}
+
+void ProfiledMutex::lock()
+{
+    if (m_mutex.try_lock())
+    {
+        m_site->acquisitions.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    m_mutex.lock();
+    auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::uint64_t wait_ns = static_cast<std::uint64_t>(wait);
+    m_site->acquisitions.fetch_add(1u, std::memory_order_relaxed);
+    m_site->contended.fetch_add(1u, std::memory_order_relaxed);
+    m_site->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    std::uint64_t max = m_site->max_wait_ns.load(std::memory_order_relaxed);
+    while (wait_ns > max &&
+        !m_site->max_wait_ns.compare_exchange_weak(max, wait_ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool ProfiledMutex::try_lock()
+{
+    if (!m_mutex.try_lock())
+    {
+        return false;
+    }
+    m_site->acquisitions.fetch_add(1u, std::memory_order_relaxed);
+    return true;
+}
+
+void ProfiledMutex::unlock()
+{
+    m_mutex.unlock();
+}
+
+} // namespace tg::core
@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Counters of one lock site, as reported by LockProfiler.
+ */
+struct LockSiteStats
+{
+    std::string name;
+    std::uint64_t acquisitions = 0u;
+    std::uint64_t contended = 0u;  ///< Acquisitions that had to wait.
+    std::uint64_t total_wait_ns = 0u;
+    std::uint64_t max_wait_ns = 0u;  ///< Over the lifetime of the site.
+};
+
+/**
+ * @brief Counters shared by every ProfiledMutex with the same site name.
+ */
+struct LockSite
+{
+    std::string name;
+    std::atomic<std::uint64_t> acquisitions{0u};
+    std::atomic<std::uint64_t> contended{0u};
+    std::atomic<std::uint64_t> total_wait_ns{0u};
+    std::atomic<std::uint64_t> max_wait_ns{0u};
+};
+
+/**
+ * @brief The process-wide registry of lock sites.
+ *
+ * @details
+ * Lock profiling is selected at build time with the TG_PROFILE_LOCKS CMake
+ * option, which makes SiteMutex a ProfiledMutex. Without it, no counters
+ * are kept and the reports are empty.
+ *
+ * To report the locks of one graph run, set RunOptions::lock_report; the
+ * Executor reports the difference between two snapshots, so locks taken by
+ * concurrent runs are counted too.
+ */
+class LockProfiler
+{
+public:
+    static constexpr bool enabled()
+    {
+#if defined(TG_PROFILE_LOCKS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns the site of a name, creating it on first use. Sites
+     * live until the process exits.
+     */
+    static LockSite& site(const std::string& name);
+
+    /**
+     * @brief The current counters of every site, by name.
+     */
+    static std::vector<LockSiteStats> snapshot();
+
+    /**
+     * @brief The counters accumulated since @p before, for the sites that
+     * were acquired, by decreasing total wait time.
+     * @note max_wait_ns is not a difference: it is the maximum over the
+     * lifetime of the site.
+     */
+    static std::vector<LockSiteStats> since(const std::vector<LockSiteStats>& before);
+};
+
+/**
+ * @brief A std::mutex that counts acquisitions and wait time on its site.
+ * @details An uncontended lock() costs one try_lock() and one relaxed
+ * increment; the clock is read only when the mutex is contended.
+ */
+class ProfiledMutex
+{
+public:
+    ProfiledMutex();
+    explicit ProfiledMutex(const std::string& site);
+
+    /**
+     * @brief Uses the site named @p prefix followed by @p name.
+     */
+    ProfiledMutex(const char* prefix, const std::string& name);
+
+    /**
+     * @brief Moves the mutex to another site, before it is first used.
+     */
+    void set_site(const std::string& site);
+    void set_site(const char* prefix, const std::string& name);
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+    ProfiledMutex(ProfiledMutex&&) = delete;
+    ProfiledMutex& operator=(ProfiledMutex&&) = delete;
+
+private:
+    std::mutex m_mutex;
+    LockSite* m_site;
+};
+
+/**
+ * @brief A std::mutex that accepts, and ignores, a site name.
+ */
+class UnprofiledMutex : public std::mutex
+{
+public:
+    UnprofiledMutex() = default;
+
+    explicit UnprofiledMutex(const std::string& /* site */)
+    {
+    }
+
+    /**
+     * @details Takes the parts of the site name separately, so that callers
+     * do not build a name that is then ignored.
+     */
+    UnprofiledMutex(const char* /* prefix */, const std::string& /* name */)
+    {
+    }
+
+    void set_site(const std::string& /* site */)
+    {
+    }
+
+    void set_site(const char* /* prefix */, const std::string& /* name */)
+    {
+    }
+};
+
+/**
+ * @brief The mutex of the data containers, profiled if TG_PROFILE_LOCKS is
+ * defined.
+ */
+#if defined(TG_PROFILE_LOCKS)
+using SiteMutex = ProfiledMutex;
+#else
+using SiteMutex = UnprofiledMutex;
+#endif
+
+} // namespace tg::core
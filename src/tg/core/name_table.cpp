@@ -0,0 +1,99 @@
+#include <array>
+#include <atomic>
+#include "tg/core/name_table.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+constexpr std::size_t shard_count = 64u;
+constexpr std::size_t block_bits = 12u;
+constexpr std::size_t block_size = std::size_t{1u} << block_bits;
+constexpr std::size_t max_blocks = std::size_t{1u} << 16u;
+
+/**
+ * @brief The strings are stored in fixed-size blocks, allocated on demand
+ * and never moved, so that a string is found from its id without a lock.
+ * @note Never destroyed, so that names stay valid during exit.
+ */
+struct Table
+{
+    std::atomic<std::string*> blocks[max_blocks];
+    std::mutex block_mutex;
+    std::atomic<std::uint32_t> next_id{0u};
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, NameId> index;
+    };
+    std::array<Shard, shard_count> shards;
+
+    Table()
+    {
+        for (auto& block : blocks)
+        {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    std::string& at(NameId id)
+    {
+        std::size_t block_index = id >> block_bits;
+        std::string* block = blocks[block_index].load(std::memory_order_acquire);
+        if (!block)
+        {
+            std::unique_lock<std::mutex> lock(block_mutex);
+            block = blocks[block_index].load(std::memory_order_relaxed);
+            if (!block)
+            {
+                block = new std::string[block_size];
+                blocks[block_index].store(block, std::memory_order_release);
+            }
+        }
+        return block[id & (block_size - 1u)];
+    }
+};
+
+Table& table()
+{
+    static Table* instance = new Table{};
+    return *instance;
+}
+
+} // namespace
+
+NameId NameTable::intern(std::string_view name)
+{
+    Table& t = table();
+    auto& shard = t.shards[std::hash<std::string_view>{}(name) % shard_count];
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto iter = shard.index.find(name);
+    if (iter != shard.index.end())
+    {
+        return iter->second;
+    }
+    NameId id = t.next_id.fetch_add(1u, std::memory_order_relaxed);
+    if (id >= max_blocks * block_size)
+    {
+        throw std::length_error("NameTable::intern(): too many names.");
+    }
+    std::string& stored = t.at(id);
+    stored.assign(name.data(), name.size());
+    shard.index.emplace(std::string_view{stored}, id);
+    return id;
+}
+
+const std::string& NameTable::name(NameId id)
+{
+    return table().at(id);
+}
+
+std::size_t NameTable::size()
+{
+    return table().next_id.load(std::memory_order_relaxed);
+}
+
+} // namespace tg::core
@@ -0,0 +1,51 @@
+#pragma once
+#include <string_view>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A name interned in the NameTable.
+ */
+using NameId = std::uint32_t;
+
+/**
+ * @brief The process-wide table of interned data names.
+ *
+ * @details
+ * Each distinct name is stored once, and identified by a dense 32-bit id,
+ * so that TaskData keeps a NameId instead of a std::string, and compile()
+ * resolves names by comparing and hashing integers.
+ *
+ * Interning is thread-safe, and scales with the number of threads by
+ * splitting the index into shards, so that graphs can be built in
+ * parallel. Looking up the string of an id does not lock; the id must have
+ * been obtained in a way that orders it after its intern() call, as
+ * passing it between threads normally does.
+ *
+ * Names are never removed; the table only grows with the number of
+ * distinct names.
+ */
+class NameTable
+{
+public:
+    /**
+     * @brief Returns the id of a name, adding the name if it is new.
+     * @throws std::length_error if the table is full.
+     */
+    static NameId intern(std::string_view name);
+
+    /**
+     * @brief Returns the string of an id returned by intern(). The reference
+     * stays valid until the process exits.
+     */
+    static const std::string& name(NameId id);
+
+    /**
+     * @brief Number of interned names.
+     */
+    static std::size_t size();
+};
+
+} // namespace tg::core
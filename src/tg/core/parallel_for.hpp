@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include "tg/core/fwd.hpp"
+#include "tg/core/executor.hpp"
+#include "tg/core/scratch_arena.hpp"
+#include "tg/core/task_context.hpp"
+#include "tg/core/worker_pool.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Calls body(k) for every k in [0, count), on the workers of a pool
+ * and on the calling thread.
+ *
+ * @details
+ * At most one work item per worker is submitted; each item, and the
+ * calling thread, takes indices from a shared counter until none are left,
+ * so the load balances itself. The calling thread takes part, and then
+ * runs the items of this loop still queued, so that the loop completes
+ * even if every worker is busy, or the caller is itself a worker. No
+ * thread is added, and no thread blocks while there is work of this loop
+ * it could do.
+ *
+ * Each call of the body may allocate from ScratchArena::for_this_thread();
+ * the arena is rewound after the call.
+ *
+ * The first exception thrown by the body is rethrown, after the indices
+ * not yet started have been skipped.
+ */
+template <typename Body>
+void parallel_for_index(WorkerPool& pool, std::size_t count, Body&& body)
+{
+    struct Loop
+    {
+        Loop(Body& body, std::size_t count)
+            : body{body}
+            , count{count}
+            , next{0u}
+            , failed{false}
+            , mutex{}
+            , done_cv{}
+            , pending_items{0u}
+            , error{}
+        {
+        }
+
+        Body& body;
+        const std::size_t count;
+        std::atomic<std::size_t> next;
+        std::atomic<bool> failed;
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        std::size_t pending_items;  ///< Guarded by mutex.
+        std::exception_ptr error;  ///< Guarded by mutex.
+
+        void drain()
+        {
+            ScratchArena& scratch = ScratchArena::for_this_thread();
+            for (std::size_t k = next.fetch_add(1u); k < count && !failed.load(std::memory_order_relaxed);
+                k = next.fetch_add(1u))
+            {
+                ScratchArena::Marker mark = scratch.mark();
+                try
+                {
+                    body(k);
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+                scratch.rewind(mark);
+            }
+        }
+
+        static void run_item(void* context, std::size_t /* index */)
+        {
+            auto* loop = static_cast<Loop*>(context);
+            loop->drain();
+            std::unique_lock<std::mutex> lock(loop->mutex);
+            if (--loop->pending_items == 0u)
+            {
+                loop->done_cv.notify_all();
+            }
+        }
+    };
+
+    Loop loop{body, count};
+    std::size_t helpers = std::min(pool.size(), count) - std::min<std::size_t>(count, 1u);
+    loop.pending_items = helpers;
+    for (std::size_t k = 0u; k < helpers; ++k)
+    {
+        pool.submit(WorkItem{&Loop::run_item, &loop, k});
+    }
+    loop.drain();
+    while (pool.try_run_one(&loop))
+    {
+    }
+    std::unique_lock<std::mutex> lock(loop.mutex);
+    loop.done_cv.wait(lock, [&loop]() { return loop.pending_items == 0u; });
+    if (loop.error)
+    {
+        std::rethrow_exception(loop.error);
+    }
+}
+
+/**
+ * @brief Calls body(chunk_begin, chunk_end) over chunks of [begin, end) of
+ * at most @p grain indices, in parallel on the pool of the Executor running
+ * the current task.
+ *
+ * @details
+ * Meant for the data parallelism inside a task, such as the rows of a
+ * large filter, which the graph cannot see. Called from on_execute(), the
+ * chunks are scheduled on the same pool as the graph, and the calling
+ * worker runs chunks instead of blocking, so that the internal parallelism
+ * fills idle workers without oversubscribing the machine. See
+ * parallel_for_index().
+ *
+ * Called outside of a task, the chunks run in order on the calling thread.
+ *
+ * The body runs on several threads: TaskContext::current() is not the
+ * caller's context there. A long loop should check the caller's
+ * TaskContext::is_cancelled() in the body, and after the loop.
+ *
+ * @param grain The size of a chunk; zero is taken as one.
+ */
+template <typename Body>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Body&& body)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1u);
+    const std::size_t chunks = (end - begin + grain - 1u) / grain;
+    auto run_chunk = [&](std::size_t chunk)
+    {
+        std::size_t chunk_begin = begin + chunk * grain;
+        body(chunk_begin, std::min(end, chunk_begin + grain));
+    };
+    TaskContext* context = TaskContext::current();
+    if (!context || chunks == 1u)
+    {
+        for (std::size_t chunk = 0u; chunk < chunks; ++chunk)
+        {
+            run_chunk(chunk);
+        }
+        return;
+    }
+    parallel_for_index(*context->executor().pool(), chunks, run_chunk);
+}
+
+} // namespace tg::core
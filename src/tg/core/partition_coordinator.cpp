@@ -0,0 +1,816 @@
+#include <algorithm>
+#include <cstring>
+#if defined(LINUX) || defined(MACOS)
+#include <poll.h>
+#endif
+#include "tg/core/partition_coordinator.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/global_dataset.hpp"
+#include "tg/core/shared_memory.hpp"
+#include "tg/core/spill_traits.hpp"
+#include "tg/core/task.hpp"
+#include "tg/core/task_data.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/unix_channel.hpp"
+#include "tg/core/worker_pool.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+enum MessageType : std::uint32_t
+{
+    Execute = 1u,  ///< arg0: head task; payload: slots to send back.
+    Value = 2u,  ///< arg0: slot; flags: ValueFlags; payload: bytes or SharedHandle.
+    Release = 3u,  ///< arg0: slot.
+    Done = 4u,  ///< arg0: head task; flags: 1 if the branch was cancelled.
+    Failed = 5u,  ///< arg0: head task; payload: error message.
+    Shutdown = 6u
+};
+
+enum ValueFlags : std::uint32_t
+{
+    Encoded = 0u,
+    Shared = 1u
+};
+
+/**
+ * @brief The codec of each slot, from the TaskData bound to it.
+ */
+std::vector<const SpillCodec*> slot_codecs(const ExecutionPlan& plan)
+{
+    std::vector<const SpillCodec*> codecs(plan.slots.size(), nullptr);
+    for (const auto& plan_task : plan.tasks)
+    {
+        for (const auto& binding : plan_task.bindings)
+        {
+            if (!codecs[binding.slot])
+            {
+                codecs[binding.slot] = binding.data->spill_codec();
+            }
+        }
+    }
+    return codecs;
+}
+
+/**
+ * @brief Fills a Value message, as a shared memory handle if possible.
+ * @param sent_segments Segments whose descriptor the peer already has; the
+ * descriptor is attached to the message on first use.
+ */
+void encode_value(const ExecutionPlan& plan, int slot, const std::shared_ptr<void>& value,
+    const SpillCodec* codec, SharedMemoryPool* shared_memory,
+    std::vector<std::uint64_t>& sent_segments, ChannelMessage& message)
+{
+    message = ChannelMessage{};
+    message.type = MessageType::Value;
+    message.arg0 = slot;
+    if (shared_memory && shared_memory->contains(value.get()))
+    {
+        SharedHandle handle = shared_memory->export_handle(value);
+        message.flags = ValueFlags::Shared;
+        message.payload.resize(sizeof(handle));
+        std::memcpy(message.payload.data(), &handle, sizeof(handle));
+        if (std::find(sent_segments.begin(), sent_segments.end(), handle.segment_id) == sent_segments.end())
+        {
+            message.fds.push_back(shared_memory->segment_fd(handle.segment_id));
+            sent_segments.push_back(handle.segment_id);
+        }
+        return;
+    }
+    if (!codec)
+    {
+        throw std::runtime_error("Value of " + plan.slots[slot].name +
+            " cannot be sent to another process: its type has no SpillTraits.");
+    }
+    message.flags = ValueFlags::Encoded;
+    message.payload.resize(codec->spill_size(value.get()));
+    codec->spill(value.get(), message.payload.data());
+}
+
+std::shared_ptr<void> decode_value(const ExecutionPlan& plan, const ChannelMessage& message,
+    const SpillCodec* codec, SharedMemoryPool* shared_memory)
+{
+    int slot = message.arg0;
+    if (message.flags == ValueFlags::Shared)
+    {
+        SharedHandle handle{};
+        if (!shared_memory || message.payload.size() != sizeof(handle))
+        {
+            throw std::runtime_error("Value of " + plan.slots[slot].name +
+                " is in shared memory, but no SharedMemoryPool was given.");
+        }
+        std::memcpy(&handle, message.payload.data(), sizeof(handle));
+        for (int fd : message.fds)
+        {
+            shared_memory->attach(handle.segment_id, fd);
+        }
+        return shared_memory->import_handle(handle);
+    }
+    if (!codec)
+    {
+        throw std::runtime_error("Value of " + plan.slots[slot].name +
+            " cannot be received: its type has no SpillTraits.");
+    }
+    std::size_t size = message.payload.size();
+    std::shared_ptr<void> bytes{::operator new(std::max<std::size_t>(size, 1u)),
+        [](void* p) { ::operator delete(p); }};
+    std::memcpy(bytes.get(), message.payload.data(), size);
+    return codec->restore(std::move(bytes), size);
+}
+
+bool is_valid_slot(const ExecutionPlan& plan, int slot)
+{
+    return slot >= 0 && static_cast<std::size_t>(slot) < plan.slots.size();
+}
+
+} // namespace
+
+/**
+ * @brief The state of one call to PartitionCoordinator::run().
+ */
+class PartitionCoordinator::Run
+{
+public:
+    Run(PartitionCoordinator& coordinator, GlobalDataSet& data)
+        : m_owner{coordinator}
+        , m_plan{coordinator.m_plan}
+        , m_data{data}
+        , m_pending(coordinator.m_unit_predecessor_count)
+        , m_skipped(m_plan.tasks.size(), 0)
+        , m_consumers(m_plan.slots.size(), 0)
+        , m_holders(m_plan.slots.size() * coordinator.m_channels.size(), 0)
+        , m_in_flight(coordinator.m_channels.size(), 0u)
+        , m_lost(coordinator.m_channels.size(), 0)
+        , m_executed_count{0u}
+        , m_skipped_count{0u}
+        , m_aborted{false}
+        , m_error{}
+    {
+        for (std::size_t slot = 0u; slot < m_plan.slots.size(); ++slot)
+        {
+            m_consumers[slot] = m_plan.slots[slot].consumer_count;
+        }
+    }
+
+    RunResult run()
+    {
+        this->send_graph_inputs();
+        for (std::size_t head = 0u; head < m_plan.tasks.size(); ++head)
+        {
+            if (m_owner.m_unit_of_task[head] == static_cast<int>(head) && m_pending[head] == 0)
+            {
+                this->ready(static_cast<int>(head));
+            }
+        }
+        while (this->in_flight() > 0u)
+        {
+            this->receive_some();
+        }
+        this->release_all();
+        while (this->posting())
+        {
+            this->receive_some();
+        }
+        RunStatus status = m_error ? RunStatus::Failed : RunStatus::Completed;
+        return RunResult{status, m_executed_count, m_skipped_count, m_error};
+    }
+
+private:
+    std::size_t parts() const
+    {
+        return m_owner.m_channels.size();
+    }
+
+    char& holder(int slot, int part)
+    {
+        return m_holders[static_cast<std::size_t>(slot) * this->parts() + part];
+    }
+
+    std::size_t in_flight() const
+    {
+        std::size_t total = 0u;
+        for (std::size_t count : m_in_flight)
+        {
+            total += count;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Whether a worker still has messages posted to it.
+     */
+    bool posting() const
+    {
+        for (std::size_t part = 0u; part < this->parts(); ++part)
+        {
+            if (!m_lost[part] && m_owner.m_channels[part]->has_posted())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Posts a message to a worker, and sends what the socket takes.
+     * @details Never blocks: a worker may itself be blocked sending to the
+     * coordinator, which must keep reading. The rest is sent by
+     * receive_some() when the socket is writable.
+     */
+    void send(int part, ChannelMessage message)
+    {
+        if (m_lost[part])
+        {
+            return;
+        }
+        try
+        {
+            m_owner.m_channels[part]->post(std::move(message));
+            m_owner.m_channels[part]->flush();
+        }
+        catch (const std::exception&)
+        {
+            this->lose(part);
+        }
+    }
+
+    void send_value(int slot, const std::shared_ptr<void>& value, int part)
+    {
+        ChannelMessage message;
+        encode_value(m_plan, slot, value, m_owner.m_codecs[slot], m_owner.m_shared_memory,
+            m_owner.m_sent_segments[part], message);
+        this->send(part, std::move(message));
+        this->holder(slot, part) = 1;
+    }
+
+    void send_graph_inputs()
+    {
+        std::shared_ptr<void> value;
+        TypeId type;
+        for (std::size_t slot = 0u; slot < m_plan.slots.size(); ++slot)
+        {
+            const auto& plan_slot = m_plan.slots[slot];
+            if (plan_slot.producer >= 0 || plan_slot.consumer_count == 0)
+            {
+                continue;
+            }
+            if (!m_data.try_get(static_cast<int>(slot), value, type))
+            {
+                throw std::runtime_error("PartitionCoordinator::run(): input " + plan_slot.name +
+                    " is not populated.");
+            }
+            for (int part : m_owner.m_reader_parts[slot])
+            {
+                this->send_value(static_cast<int>(slot), value, part);
+            }
+        }
+    }
+
+    /**
+     * @brief Dispatches a ready chain, or skips it if the run is aborted or
+     * its branch was cancelled.
+     */
+    void ready(int head)
+    {
+        if (m_aborted || m_skipped[head])
+        {
+            this->complete(head, true, false);
+            return;
+        }
+        int part = m_owner.m_partition.part_of_task[head];
+        if (m_lost[part])
+        {
+            this->complete(head, true, false);
+            return;
+        }
+        ChannelMessage message;
+        message.type = MessageType::Execute;
+        message.arg0 = head;
+        const auto& exports = m_owner.m_exports[head];
+        message.payload.resize(exports.size() * sizeof(std::int32_t));
+        std::memcpy(message.payload.data(), exports.data(), message.payload.size());
+        ++m_in_flight[part];
+        this->send(part, std::move(message));
+    }
+
+    /**
+     * @brief Waits until a channel has a message to read or can take more
+     * of the posted ones, and handles it.
+     */
+    void receive_some()
+    {
+#if defined(LINUX) || defined(MACOS)
+        std::vector<pollfd> fds;
+        std::vector<int> parts;
+        for (std::size_t part = 0u; part < this->parts(); ++part)
+        {
+            if (m_lost[part])
+            {
+                continue;
+            }
+            short events = 0;
+            if (m_in_flight[part] > 0u)
+            {
+                events |= POLLIN;
+            }
+            if (m_owner.m_channels[part]->has_posted())
+            {
+                events |= POLLOUT;
+            }
+            if (events != 0)
+            {
+                fds.push_back(pollfd{m_owner.m_channels[part]->fd(), events, 0});
+                parts.push_back(static_cast<int>(part));
+            }
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            return;
+        }
+        for (std::size_t k = 0u; k < fds.size(); ++k)
+        {
+            int part = parts[k];
+            if ((fds[k].revents & (POLLOUT | POLLERR | POLLHUP)) != 0 && (fds[k].events & POLLOUT) != 0)
+            {
+                this->send_posted(part);
+            }
+            if ((fds[k].revents & (POLLIN | POLLERR | POLLHUP)) != 0 && (fds[k].events & POLLIN) != 0 &&
+                !m_lost[part])
+            {
+                this->receive_one(part);
+            }
+        }
+#endif
+    }
+
+    void send_posted(int part)
+    {
+        try
+        {
+            m_owner.m_channels[part]->flush();
+        }
+        catch (const std::exception&)
+        {
+            this->lose(part);
+        }
+    }
+
+    void receive_one(int part)
+    {
+        ChannelMessage message;
+        try
+        {
+            if (!m_owner.m_channels[part]->receive(message))
+            {
+                this->lose(part);
+                return;
+            }
+            this->handle(part, message);
+        }
+        catch (...)
+        {
+            this->fail(std::current_exception());
+            this->lose(part);
+        }
+    }
+
+    void handle(int part, const ChannelMessage& message)
+    {
+        switch (message.type)
+        {
+        case MessageType::Value:
+        {
+            int slot = message.arg0;
+            if (!is_valid_slot(m_plan, slot))
+            {
+                throw std::runtime_error("PartitionCoordinator: bad slot from a worker.");
+            }
+            std::shared_ptr<void> value = decode_value(m_plan, message, m_owner.m_codecs[slot],
+                m_owner.m_shared_memory);
+            this->holder(slot, part) = 1;
+            for (int reader : m_owner.m_reader_parts[slot])
+            {
+                if (reader != part)
+                {
+                    this->send_value(slot, value, reader);
+                }
+            }
+            if (m_plan.slots[slot].retained)
+            {
+                m_data.try_assign(slot, std::move(value), m_plan.slots[slot].type,
+                    m_owner.m_codecs[slot], 0u);
+            }
+            break;
+        }
+        case MessageType::Done:
+        case MessageType::Failed:
+        {
+            int head = message.arg0;
+            if (head < 0 || static_cast<std::size_t>(head) >= m_plan.tasks.size() ||
+                m_owner.m_unit_of_task[head] != head || m_in_flight[part] == 0u)
+            {
+                throw std::runtime_error("PartitionCoordinator: bad task from a worker.");
+            }
+            --m_in_flight[part];
+            if (message.type == MessageType::Failed)
+            {
+                std::string what(message.payload.begin(), message.payload.end());
+                this->fail(std::make_exception_ptr(std::runtime_error(
+                    "PartitionCoordinator: task failed in part " + std::to_string(part) + ": " + what)));
+            }
+            this->complete(head, message.flags != 0u || message.type == MessageType::Failed, true);
+            break;
+        }
+        default:
+            throw std::runtime_error("PartitionCoordinator: unexpected message from a worker.");
+        }
+    }
+
+    /**
+     * @brief Completes a chain: releases the values whose last reader it
+     * was, and readies the successor chains. Skipped chains are completed
+     * inline.
+     */
+    void complete(int head, bool skip_successors, bool executed)
+    {
+        std::vector<std::pair<int, bool>> stack{{head, skip_successors}};
+        bool first = true;
+        while (!stack.empty())
+        {
+            auto [unit, skip] = stack.back();
+            stack.pop_back();
+            std::size_t chain_length = 0u;
+            for (int task_id = unit; task_id >= 0; task_id = m_plan.tasks[task_id].fused_next)
+            {
+                ++chain_length;
+                for (int slot : m_plan.tasks[task_id].input_slots)
+                {
+                    const auto& plan_slot = m_plan.slots[slot];
+                    if (!plan_slot.fused && --m_consumers[slot] == 0 && !plan_slot.retained)
+                    {
+                        this->release(slot);
+                    }
+                }
+            }
+            ((first && executed) ? m_executed_count : m_skipped_count) += chain_length;
+            first = false;
+            for (int successor : m_owner.m_unit_successors[unit])
+            {
+                if (skip)
+                {
+                    m_skipped[successor] = 1;
+                }
+                if (--m_pending[successor] == 0)
+                {
+                    if (m_aborted || m_skipped[successor])
+                    {
+                        stack.emplace_back(successor, true);
+                    }
+                    else
+                    {
+                        this->ready(successor);
+                    }
+                }
+            }
+        }
+    }
+
+    void release(int slot)
+    {
+        ChannelMessage message;
+        message.type = MessageType::Release;
+        message.arg0 = slot;
+        for (std::size_t part = 0u; part < this->parts(); ++part)
+        {
+            if (this->holder(slot, static_cast<int>(part)))
+            {
+                this->holder(slot, static_cast<int>(part)) = 0;
+                this->send(static_cast<int>(part), ChannelMessage{message});
+            }
+        }
+    }
+
+    /**
+     * @brief Clears the workers' datasets for the next run; the graph
+     * outputs are now held by the coordinator.
+     */
+    void release_all()
+    {
+        for (std::size_t slot = 0u; slot < m_plan.slots.size(); ++slot)
+        {
+            this->release(static_cast<int>(slot));
+        }
+    }
+
+    void fail(std::exception_ptr error)
+    {
+        if (!m_error)
+        {
+            m_error = error;
+        }
+        m_aborted = true;
+    }
+
+    /**
+     * @brief Gives up on a worker: its chains in flight count as failed.
+     */
+    void lose(int part)
+    {
+        if (m_lost[part])
+        {
+            return;
+        }
+        m_lost[part] = 1;
+        this->fail(std::make_exception_ptr(std::runtime_error(
+            "PartitionCoordinator: lost the worker of part " + std::to_string(part) + ".")));
+        m_in_flight[part] = 0u;
+    }
+
+private:
+    PartitionCoordinator& m_owner;
+    const ExecutionPlan& m_plan;
+    GlobalDataSet& m_data;
+    std::vector<int> m_pending;  ///< Per head.
+    std::vector<char> m_skipped;  ///< Per head.
+    std::vector<int> m_consumers;  ///< Per slot.
+    std::vector<char> m_holders;  ///< Per slot and part: whether the part holds the value.
+    std::vector<std::size_t> m_in_flight;  ///< Per part.
+    std::vector<char> m_lost;  ///< Per part.
+    std::size_t m_executed_count;
+    std::size_t m_skipped_count;
+    bool m_aborted;
+    std::exception_ptr m_error;
+};
+
+PartitionCoordinator::PartitionCoordinator(const ExecutionPlan& plan, GraphPartition partition,
+    std::vector<UnixChannelPtr> channels, SharedMemoryPool* shared_memory)
+    : m_plan{plan}
+    , m_partition{std::move(partition)}
+    , m_channels{std::move(channels)}
+    , m_shared_memory{shared_memory}
+    , m_codecs{slot_codecs(plan)}
+    , m_unit_of_task(plan.tasks.size(), -1)
+    , m_unit_successors(plan.tasks.size())
+    , m_unit_predecessor_count(plan.tasks.size(), 0)
+    , m_exports(plan.tasks.size())
+    , m_reader_parts(plan.slots.size())
+    , m_sent_segments(m_channels.size())
+    , m_shut_down{false}
+{
+    if (m_partition.part_of_task.size() != plan.tasks.size())
+    {
+        throw std::invalid_argument("PartitionCoordinator: partition does not match the plan.");
+    }
+    for (std::size_t task_id = 0u; task_id < plan.tasks.size(); ++task_id)
+    {
+        int part = m_partition.part_of_task[task_id];
+        if (part < 0 || static_cast<std::size_t>(part) >= m_channels.size() || !m_channels[part])
+        {
+            throw std::invalid_argument("PartitionCoordinator: no channel for part " + std::to_string(part));
+        }
+        if (plan.tasks[task_id].task->kind() == TaskKind::Async)
+        {
+            throw std::invalid_argument("PartitionCoordinator: async tasks are not supported.");
+        }
+    }
+    for (int head : plan.topological_order)
+    {
+        if (plan.tasks[head].fused_prev >= 0)
+        {
+            continue;
+        }
+        for (int task_id = head; task_id >= 0; task_id = plan.tasks[task_id].fused_next)
+        {
+            if (m_partition.part_of_task[task_id] != m_partition.part_of_task[head])
+            {
+                throw std::invalid_argument("PartitionCoordinator: a fused chain is split.");
+            }
+            m_unit_of_task[task_id] = head;
+        }
+    }
+    for (std::size_t task_id = 0u; task_id < plan.tasks.size(); ++task_id)
+    {
+        int unit = m_unit_of_task[task_id];
+        for (int successor : plan.tasks[task_id].successors)
+        {
+            int successor_unit = m_unit_of_task[successor];
+            auto& successors = m_unit_successors[unit];
+            if (successor_unit != unit &&
+                std::find(successors.begin(), successors.end(), successor_unit) == successors.end())
+            {
+                successors.push_back(successor_unit);
+                ++m_unit_predecessor_count[successor_unit];
+            }
+        }
+        for (int slot : plan.tasks[task_id].input_slots)
+        {
+            auto& parts = m_reader_parts[slot];
+            int part = m_partition.part_of_task[task_id];
+            if (!plan.slots[slot].fused && std::find(parts.begin(), parts.end(), part) == parts.end())
+            {
+                parts.push_back(part);
+            }
+        }
+    }
+    for (std::size_t slot = 0u; slot < plan.slots.size(); ++slot)
+    {
+        const auto& plan_slot = plan.slots[slot];
+        if (plan_slot.producer < 0 || plan_slot.fused)
+        {
+            continue;
+        }
+        int part = m_partition.part_of_task[plan_slot.producer];
+        const auto& readers = m_reader_parts[slot];
+        bool remote = std::any_of(readers.begin(), readers.end(), [part](int reader) { return reader != part; });
+        if (remote || plan_slot.retained)
+        {
+            m_exports[m_unit_of_task[plan_slot.producer]].push_back(static_cast<int>(slot));
+        }
+    }
+}
+
+PartitionCoordinator::~PartitionCoordinator()
+{
+    try
+    {
+        this->shutdown();
+    }
+    catch (...)
+    {
+    }
+}
+
+RunResult PartitionCoordinator::run(GlobalDataSet& data)
+{
+    if (!data.is_frozen() || data.size() != m_plan.slots.size())
+    {
+        throw std::invalid_argument("PartitionCoordinator::run(): dataset does not match the plan.");
+    }
+    if (m_shut_down)
+    {
+        throw std::logic_error("PartitionCoordinator::run(): the workers were shut down.");
+    }
+    Run run{*this, data};
+    return run.run();
+}
+
+void PartitionCoordinator::shutdown()
+{
+    if (m_shut_down)
+    {
+        return;
+    }
+    m_shut_down = true;
+    ChannelMessage message;
+    message.type = MessageType::Shutdown;
+    for (const auto& channel : m_channels)
+    {
+        try
+        {
+            channel->send(message);
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+}
+
+PartitionWorker::PartitionWorker(Executor& executor, const ExecutionPlan& plan,
+    UnixChannelPtr channel, SharedMemoryPool* shared_memory)
+    : m_executor{executor}
+    , m_plan{plan}
+    , m_data{plan.make_dataset()}
+    , m_channel{std::move(channel)}
+    , m_shared_memory{shared_memory}
+    , m_codecs{slot_codecs(plan)}
+    , m_exports(plan.tasks.size())
+    , m_mutex{}
+    , m_idle_cv{}
+    , m_outstanding{0u}
+    , m_send_mutex{}
+    , m_sent_segments{}
+{
+}
+
+PartitionWorker::~PartitionWorker()
+{
+    this->wait_idle();
+}
+
+void PartitionWorker::serve()
+{
+    ChannelMessage message;
+    try
+    {
+        while (m_channel->receive(message) && message.type != MessageType::Shutdown)
+        {
+            int arg = message.arg0;
+            if (message.type == MessageType::Execute)
+            {
+                if (arg < 0 || static_cast<std::size_t>(arg) >= m_plan.tasks.size() ||
+                    message.payload.size() % sizeof(std::int32_t) != 0u)
+                {
+                    throw std::runtime_error("PartitionWorker: bad task from the coordinator.");
+                }
+                auto& exports = m_exports[arg];
+                exports.resize(message.payload.size() / sizeof(std::int32_t));
+                std::memcpy(exports.data(), message.payload.data(), message.payload.size());
+                m_outstanding.fetch_add(1u, std::memory_order_relaxed);
+                m_executor.pool()->submit(WorkItem{&PartitionWorker::execute_item, this,
+                    static_cast<std::size_t>(arg)});
+                continue;
+            }
+            if (!is_valid_slot(m_plan, arg))
+            {
+                throw std::runtime_error("PartitionWorker: bad slot from the coordinator.");
+            }
+            if (message.type == MessageType::Value)
+            {
+                std::shared_ptr<void> value = decode_value(m_plan, message, m_codecs[arg], m_shared_memory);
+                m_data->try_assign(arg, std::move(value), m_plan.slots[arg].type, m_codecs[arg], 0u);
+            }
+            else if (message.type == MessageType::Release)
+            {
+                m_data->release(arg);
+            }
+        }
+    }
+    catch (...)
+    {
+        this->wait_idle();
+        throw;
+    }
+    this->wait_idle();
+}
+
+void PartitionWorker::execute_item(void* context, std::size_t index)
+{
+    static_cast<PartitionWorker*>(context)->execute(static_cast<int>(index));
+}
+
+/**
+ * @note Sends are serialized by m_send_mutex, so that a segment descriptor
+ * reaches the coordinator before any handle into that segment. serve()
+ * never takes it, and keeps reading while a send blocks.
+ */
+void PartitionWorker::execute(int task_id)
+{
+    ChannelMessage reply;
+    reply.arg0 = task_id;
+    try
+    {
+        bool cancelled = m_executor.execute_chain(m_plan, *m_data, task_id);
+        std::shared_ptr<void> value;
+        TypeId type;
+        ChannelMessage message;
+        std::unique_lock<std::mutex> lock(m_send_mutex);
+        for (int slot : m_exports[task_id])
+        {
+            if (m_data->try_get(slot, value, type))
+            {
+                encode_value(m_plan, slot, value, m_codecs[slot], m_shared_memory, m_sent_segments, message);
+                m_channel->send(message);
+            }
+        }
+        reply.type = MessageType::Done;
+        reply.flags = cancelled ? 1u : 0u;
+    }
+    catch (const std::exception& e)
+    {
+        reply.type = MessageType::Failed;
+        std::string what = e.what();
+        reply.payload.assign(what.begin(), what.end());
+    }
+    catch (...)
+    {
+        reply.type = MessageType::Failed;
+        std::string what = "unknown exception";
+        reply.payload.assign(what.begin(), what.end());
+    }
+    try
+    {
+        m_channel->send(reply);
+    }
+    catch (const std::exception&)
+    {
+        /**
+         * @note The coordinator is gone; serve() returns on its own.
+         */
+    }
+    if (m_outstanding.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle_cv.notify_all();
+    }
+}
+
+void PartitionWorker::wait_idle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle_cv.wait(lock, [this]() { return m_outstanding.load(std::memory_order_acquire) == 0u; });
+}
+
+} // namespace tg::core
@@ -0,0 +1,142 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include "tg/core/fwd.hpp"
+#include "tg/core/executor.hpp"
+#include "tg/core/graph_partitioner.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Runs a partitioned plan across worker processes, each connected
+ * through a UnixChannel.
+ *
+ * @details
+ * Every process builds the same plan; the worker processes serve a
+ * PartitionWorker, and the coordinator keeps the readiness tracking. Tasks
+ * are dispatched by fused chain, the unit of GraphPartitioner: when a chain
+ * is ready, the coordinator asks the worker of its part to execute it,
+ * naming the outputs that other parts read or that are graph outputs. The
+ * worker sends those values back, and the coordinator forwards each one to
+ * the parts that read it. Values on edges within a part never leave their
+ * process. When the last reader of a value has completed, the coordinator
+ * tells the parts holding it to release it.
+ *
+ * A value crosses processes as a SharedHandle if it lives in shared memory
+ * (see SharedMemoryPool and TaskOutput<T>::emplace_shared()), and otherwise
+ * as bytes encoded by its SpillTraits.
+ *
+ * Graph inputs are taken from the coordinator's dataset, and graph outputs
+ * are stored into it. AsyncTask is not supported.
+ *
+ * Only available on Linux and macOS.
+ */
+class PartitionCoordinator
+{
+public:
+    /**
+     * @param channels One per part, connected to the worker serving it.
+     * @param shared_memory The coordinator's pool, required to forward
+     * values in shared memory.
+     * @throws std::invalid_argument if the partition does not fit the plan,
+     * splits a fused chain, or the plan has an AsyncTask.
+     */
+    PartitionCoordinator(const ExecutionPlan& plan, GraphPartition partition,
+        std::vector<UnixChannelPtr> channels, SharedMemoryPool* shared_memory = nullptr);
+
+    /**
+     * @details Shuts down the workers.
+     */
+    ~PartitionCoordinator();
+
+    /**
+     * @brief Runs the plan to completion on the workers.
+     * @param data A dataset made by the plan, with all graph inputs
+     * assigned.
+     * @details Like Executor::try_run(), a task failure is reported in the
+     * result. Losing a worker is reported as a failure too.
+     */
+    RunResult run(GlobalDataSet& data);
+
+    /**
+     * @brief Asks the workers to stop serving.
+     */
+    void shutdown();
+
+private:
+    PartitionCoordinator(const PartitionCoordinator&) = delete;
+    PartitionCoordinator& operator=(const PartitionCoordinator&) = delete;
+    PartitionCoordinator(PartitionCoordinator&&) = delete;
+    PartitionCoordinator& operator=(PartitionCoordinator&&) = delete;
+
+private:
+    class Run;
+
+private:
+    const ExecutionPlan& m_plan;
+    GraphPartition m_partition;
+    std::vector<UnixChannelPtr> m_channels;
+    SharedMemoryPool* m_shared_memory;
+    std::vector<const SpillCodec*> m_codecs;  ///< Per slot.
+    std::vector<int> m_unit_of_task;  ///< The head of the task's fused chain.
+    std::vector<std::vector<int>> m_unit_successors;  ///< Per head: distinct successor heads.
+    std::vector<int> m_unit_predecessor_count;  ///< Per head.
+    std::vector<std::vector<int>> m_exports;  ///< Per head: slots to send back.
+    std::vector<std::vector<int>> m_reader_parts;  ///< Per slot: distinct parts reading it.
+    std::vector<std::vector<std::uint64_t>> m_sent_segments;  ///< Per part.
+    bool m_shut_down;
+};
+
+/**
+ * @brief Serves the part of a plan assigned to this worker process, on
+ * behalf of a PartitionCoordinator.
+ *
+ * @details
+ * The worker keeps its own dataset. Chains are executed on the executor's
+ * pool with Executor::execute_chain(), so that independent chains of the
+ * part run in parallel.
+ */
+class PartitionWorker
+{
+public:
+    /**
+     * @param shared_memory The worker's pool, required to exchange values in
+     * shared memory.
+     */
+    PartitionWorker(Executor& executor, const ExecutionPlan& plan, UnixChannelPtr channel,
+        SharedMemoryPool* shared_memory = nullptr);
+    ~PartitionWorker();
+
+    /**
+     * @brief Serves until the coordinator shuts down or disconnects.
+     */
+    void serve();
+
+private:
+    PartitionWorker(const PartitionWorker&) = delete;
+    PartitionWorker& operator=(const PartitionWorker&) = delete;
+    PartitionWorker(PartitionWorker&&) = delete;
+    PartitionWorker& operator=(PartitionWorker&&) = delete;
+
+private:
+    static void execute_item(void* context, std::size_t index);
+    void execute(int task_id);
+    void wait_idle();
+
+private:
+    Executor& m_executor;
+    const ExecutionPlan& m_plan;
+    GlobalDataSetPtr m_data;
+    UnixChannelPtr m_channel;
+    SharedMemoryPool* m_shared_memory;
+    std::vector<const SpillCodec*> m_codecs;  ///< Per slot.
+    std::vector<std::vector<int>> m_exports;  ///< Per head, as last requested.
+    std::mutex m_mutex;  ///< Pairs with m_idle_cv.
+    std::condition_variable m_idle_cv;
+    std::atomic<std::size_t> m_outstanding;  ///< Chains submitted and not yet replied to.
+    std::mutex m_send_mutex;  ///< Held while sending; never taken by serve().
+    std::vector<std::uint64_t> m_sent_segments;  ///< Guarded by m_send_mutex.
+};
+
+} // namespace tg::core
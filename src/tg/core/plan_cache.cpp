@@ -0,0 +1,50 @@
+#include <cstdio>
+#include "tg/core/plan_cache.hpp"
+#include "tg/core/plan_file.hpp"
+#include "tg/core/task_graph.hpp"
+
+namespace tg::core
+{
+
+PlanCache::PlanCache(const std::string& directory)
+    : m_directory{directory}
+{
+}
+
+PlanCache::~PlanCache()
+{
+}
+
+std::string PlanCache::path_for(std::uint64_t structural_hash) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tgplan",
+        static_cast<unsigned long long>(structural_hash));
+    if (m_directory.empty() || m_directory.back() == '/')
+    {
+        return m_directory + name;
+    }
+    return m_directory + "/" + name;
+}
+
+ExecutionPlanPtr PlanCache::load_or_compile(const TaskGraph& graph) const
+{
+    std::uint64_t hash = graph.structural_hash();
+    std::string path = this->path_for(hash);
+    try
+    {
+        MappedPlanFile cached{path};
+        return graph.compile(cached);
+    }
+    catch (const std::exception&)
+    {
+        /**
+         * @note Missing, stale or corrupted file: fall through and rebuild.
+         */
+    }
+    ExecutionPlanPtr plan = graph.compile();
+    write_plan_file(*plan, hash, path);
+    return plan;
+}
+
+} // namespace tg::core
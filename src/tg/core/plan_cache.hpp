@@ -0,0 +1,31 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A directory of plan files, keyed by the structural hash of the
+ * graph that produced them.
+ *
+ * @details
+ * load_or_compile() looks up the file for the graph's structural hash. If
+ * it exists and is valid, the plan is built from the memory-mapped file,
+ * skipping validation and compilation. Otherwise the graph is compiled and
+ * the plan is written for the next start.
+ */
+class PlanCache
+{
+public:
+    explicit PlanCache(const std::string& directory);
+    ~PlanCache();
+
+    ExecutionPlanPtr load_or_compile(const TaskGraph& graph) const;
+
+    std::string path_for(std::uint64_t structural_hash) const;
+
+private:
+    std::string m_directory;
+};
+
+} // namespace tg::core
@@ -0,0 +1,281 @@
+#include <cstring>
+#include <fstream>
+#if defined(LINUX) || defined(MACOS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "tg/core/plan_file.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/task.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+std::uint64_t align_up(std::uint64_t value)
+{
+    return (value + 7u) & ~std::uint64_t{7u};
+}
+
+/**
+ * @brief Appends a section to the file image, 8-byte aligned, and returns
+ * its offset.
+ */
+template <typename T>
+std::uint64_t append_section(std::vector<char>& image, const T* items, std::size_t count)
+{
+    std::uint64_t offset = align_up(image.size());
+    image.resize(offset + sizeof(T) * count);
+    if (count)
+    {
+        std::memcpy(image.data() + offset, items, sizeof(T) * count);
+    }
+    return offset;
+}
+
+} // namespace
+
+void write_plan_file(const ExecutionPlan& plan, std::uint64_t structural_hash,
+    const std::string& path)
+{
+    std::vector<plan_file::Task> tasks;
+    std::vector<plan_file::Binding> bindings;
+    std::vector<plan_file::Slot> slots;
+    std::vector<std::int32_t> slot_refs;
+    std::vector<std::int32_t> successors;
+    std::vector<std::int32_t> order(plan.topological_order.begin(), plan.topological_order.end());
+    std::string names;
+
+    for (const auto& plan_task : plan.tasks)
+    {
+        plan_file::Task file_task{};
+        file_task.binding_begin = static_cast<std::uint32_t>(bindings.size());
+        file_task.binding_count = static_cast<std::uint32_t>(plan_task.bindings.size());
+        for (const auto& binding : plan_task.bindings)
+        {
+            bindings.push_back(plan_file::Binding{binding.local_index, binding.slot,
+                static_cast<std::uint32_t>(binding.flags), 0u});
+        }
+        file_task.input_begin = static_cast<std::uint32_t>(slot_refs.size());
+        file_task.input_count = static_cast<std::uint32_t>(plan_task.input_slots.size());
+        slot_refs.insert(slot_refs.end(), plan_task.input_slots.begin(), plan_task.input_slots.end());
+        file_task.output_begin = static_cast<std::uint32_t>(slot_refs.size());
+        file_task.output_count = static_cast<std::uint32_t>(plan_task.output_slots.size());
+        slot_refs.insert(slot_refs.end(), plan_task.output_slots.begin(), plan_task.output_slots.end());
+        file_task.successor_begin = static_cast<std::uint32_t>(successors.size());
+        file_task.successor_count = static_cast<std::uint32_t>(plan_task.successors.size());
+        successors.insert(successors.end(), plan_task.successors.begin(), plan_task.successors.end());
+        file_task.predecessor_count = plan_task.predecessor_count;
+        file_task.kind = static_cast<std::uint32_t>(plan_task.task->kind());
+        file_task.fused_next = plan_task.fused_next;
+        file_task.fused_prev = plan_task.fused_prev;
+        file_task.graph_index = static_cast<std::uint32_t>(plan_task.graph_index);
+        tasks.push_back(file_task);
+    }
+    for (const auto& plan_slot : plan.slots)
+    {
+        plan_file::Slot file_slot{};
+        file_slot.name_offset = names.size();
+        file_slot.name_size = static_cast<std::uint32_t>(plan_slot.name.size());
+        file_slot.producer = plan_slot.producer;
+        file_slot.consumer_count = plan_slot.consumer_count;
+        file_slot.retained = plan_slot.retained ? 1u : 0u;
+        file_slot.fused = plan_slot.fused ? 1u : 0u;
+        file_slot.type_id = plan_slot.type.value();
+        names += plan_slot.name;
+        slots.push_back(file_slot);
+    }
+
+    std::vector<char> image(sizeof(plan_file::Header), '\0');
+    plan_file::Header header{};
+    std::memcpy(header.magic, plan_file::magic, sizeof(header.magic));
+    header.version = plan_file::current_version;
+    header.byte_order = plan_file::byte_order_mark;
+    header.structural_hash = structural_hash;
+    header.task_count = static_cast<std::uint32_t>(tasks.size());
+    header.binding_count = static_cast<std::uint32_t>(bindings.size());
+    header.slot_count = static_cast<std::uint32_t>(slots.size());
+    header.slot_ref_count = static_cast<std::uint32_t>(slot_refs.size());
+    header.successor_count = static_cast<std::uint32_t>(successors.size());
+    header.tasks_offset = append_section(image, tasks.data(), tasks.size());
+    header.bindings_offset = append_section(image, bindings.data(), bindings.size());
+    header.slots_offset = append_section(image, slots.data(), slots.size());
+    header.slot_refs_offset = append_section(image, slot_refs.data(), slot_refs.size());
+    header.successors_offset = append_section(image, successors.data(), successors.size());
+    header.order_offset = append_section(image, order.data(), order.size());
+    header.names_offset = append_section(image, names.data(), names.size());
+    header.names_size = names.size();
+    image.resize(align_up(image.size()));
+    header.file_size = image.size();
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    /**
+     * @note Written to a temporary file first, so that a concurrent reader
+     * never maps a partially written plan.
+     */
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(image.data(), static_cast<std::streamsize>(image.size()));
+        if (!file)
+        {
+            throw std::runtime_error("write_plan_file(): cannot write " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("write_plan_file(): cannot rename " + temp_path);
+    }
+}
+
+MappedPlanFile::MappedPlanFile(const std::string& path)
+    : m_data{nullptr}
+    , m_size{0u}
+    , m_fallback{}
+{
+#if defined(LINUX) || defined(MACOS)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("MappedPlanFile: cannot open " + path);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("MappedPlanFile: cannot stat " + path);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        throw std::runtime_error("MappedPlanFile: cannot map " + path);
+    }
+    m_data = static_cast<const char*>(addr);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw std::runtime_error("MappedPlanFile: cannot open " + path);
+    }
+    m_size = static_cast<std::size_t>(file.tellg());
+    m_fallback.resize((m_size + 7u) / 8u);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_fallback.data()), static_cast<std::streamsize>(m_size));
+    m_data = reinterpret_cast<const char*>(m_fallback.data());
+#endif
+    try
+    {
+        this->validate(path);
+    }
+    catch (...)
+    {
+#if defined(LINUX) || defined(MACOS)
+        ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+        throw;
+    }
+}
+
+MappedPlanFile::~MappedPlanFile()
+{
+#if defined(LINUX) || defined(MACOS)
+    ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+}
+
+void MappedPlanFile::validate(const std::string& path) const
+{
+    if (m_size < sizeof(plan_file::Header))
+    {
+        throw std::runtime_error("MappedPlanFile: file too small: " + path);
+    }
+    const auto& h = this->header();
+    if (std::memcmp(h.magic, plan_file::magic, sizeof(h.magic)) != 0 ||
+        h.byte_order != plan_file::byte_order_mark)
+    {
+        throw std::runtime_error("MappedPlanFile: not a plan file: " + path);
+    }
+    if (h.version != plan_file::current_version)
+    {
+        throw std::runtime_error("MappedPlanFile: unsupported version " +
+            std::to_string(h.version) + ": " + path);
+    }
+    auto check = [&](std::uint64_t offset, std::uint64_t bytes)
+    {
+        if ((offset & 7u) != 0u || offset > m_size || bytes > m_size - offset)
+        {
+            throw std::runtime_error("MappedPlanFile: corrupted section: " + path);
+        }
+    };
+    if (h.file_size != m_size)
+    {
+        throw std::runtime_error("MappedPlanFile: truncated file: " + path);
+    }
+    check(h.tasks_offset, std::uint64_t{h.task_count} * sizeof(plan_file::Task));
+    check(h.bindings_offset, std::uint64_t{h.binding_count} * sizeof(plan_file::Binding));
+    check(h.slots_offset, std::uint64_t{h.slot_count} * sizeof(plan_file::Slot));
+    check(h.slot_refs_offset, std::uint64_t{h.slot_ref_count} * sizeof(std::int32_t));
+    check(h.successors_offset, std::uint64_t{h.successor_count} * sizeof(std::int32_t));
+    check(h.order_offset, std::uint64_t{h.task_count} * sizeof(std::int32_t));
+    check(h.names_offset, h.names_size);
+}
+
+const plan_file::Header& MappedPlanFile::header() const
+{
+    return *this->section<plan_file::Header>(0u);
+}
+
+std::uint64_t MappedPlanFile::structural_hash() const
+{
+    return this->header().structural_hash;
+}
+
+const plan_file::Task* MappedPlanFile::tasks() const
+{
+    return this->section<plan_file::Task>(this->header().tasks_offset);
+}
+
+const plan_file::Binding* MappedPlanFile::bindings() const
+{
+    return this->section<plan_file::Binding>(this->header().bindings_offset);
+}
+
+const plan_file::Slot* MappedPlanFile::slots() const
+{
+    return this->section<plan_file::Slot>(this->header().slots_offset);
+}
+
+const std::int32_t* MappedPlanFile::slot_refs() const
+{
+    return this->section<std::int32_t>(this->header().slot_refs_offset);
+}
+
+const std::int32_t* MappedPlanFile::successors() const
+{
+    return this->section<std::int32_t>(this->header().successors_offset);
+}
+
+const std::int32_t* MappedPlanFile::topological_order() const
+{
+    return this->section<std::int32_t>(this->header().order_offset);
+}
+
+std::string_view MappedPlanFile::slot_name(std::size_t slot) const
+{
+    const auto& h = this->header();
+    const auto& file_slot = this->slots()[slot];
+    if (file_slot.name_offset > h.names_size || file_slot.name_size > h.names_size - file_slot.name_offset)
+    {
+        throw std::runtime_error("MappedPlanFile::slot_name(): corrupted name.");
+    }
+    return std::string_view{m_data + h.names_offset + file_slot.name_offset, file_slot.name_size};
+}
+
+} // namespace tg::core
@@ -0,0 +1,166 @@
+#pragma once
+#include <string_view>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief On-disk layout of a compiled ExecutionPlan.
+ *
+ * @details
+ * The file is position-independent: every reference is an offset from the
+ * start of the file, or an index into one of its arrays. All integers are
+ * fixed-width, in host byte order, which the header records; all sections
+ * are 8-byte aligned. A file can therefore be memory-mapped and used in
+ * place, without parsing.
+ *
+ * Sections, in order:
+ * - plan_file::Header
+ * - plan_file::Task[task_count]
+ * - plan_file::Binding[binding_count]
+ * - plan_file::Slot[slot_count]
+ * - int32_t slot references (inputs and outputs of tasks)
+ * - int32_t successors
+ * - int32_t topological order[task_count]
+ * - interned names, as a character blob
+ *
+ * Task objects are not stored. A plan loaded from a file is attached to the
+ * tasks of a TaskGraph with the same structural hash; see
+ * TaskGraph::compile(const MappedPlanFile&).
+ */
+namespace plan_file
+{
+
+constexpr char magic[8] = {'T', 'G', 'P', 'L', 'A', 'N', '\0', '\0'};
+constexpr std::uint32_t current_version = 3u;
+constexpr std::uint32_t byte_order_mark = 0x01020304u;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t structural_hash;
+    std::uint64_t file_size;
+    std::uint32_t task_count;
+    std::uint32_t binding_count;
+    std::uint32_t slot_count;
+    std::uint32_t slot_ref_count;
+    std::uint32_t successor_count;
+    std::uint32_t reserved;
+    std::uint64_t tasks_offset;
+    std::uint64_t bindings_offset;
+    std::uint64_t slots_offset;
+    std::uint64_t slot_refs_offset;
+    std::uint64_t successors_offset;
+    std::uint64_t order_offset;
+    std::uint64_t names_offset;
+    std::uint64_t names_size;
+};
+
+struct Task
+{
+    std::uint32_t binding_begin;
+    std::uint32_t binding_count;
+    std::uint32_t input_begin;  ///< Index into the slot references.
+    std::uint32_t input_count;
+    std::uint32_t output_begin;  ///< Index into the slot references.
+    std::uint32_t output_count;
+    std::uint32_t successor_begin;
+    std::uint32_t successor_count;
+    std::int32_t predecessor_count;
+    std::uint32_t kind;  ///< TaskKind, checked against the attached task.
+    std::int32_t fused_next;
+    std::int32_t fused_prev;
+    std::uint32_t graph_index;  ///< Index of the attached task in the TaskGraph.
+    std::uint32_t reserved;
+};
+
+struct Binding
+{
+    std::int32_t local_index;
+    std::int32_t slot;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+};
+
+struct Slot
+{
+    std::uint64_t name_offset;  ///< Offset into the names blob.
+    std::uint32_t name_size;
+    std::int32_t producer;
+    std::int32_t consumer_count;
+    std::uint32_t retained;
+    std::uint32_t fused;
+    std::uint32_t reserved;
+    std::uint64_t type_id;  ///< TypeId value; zero if the type is not known at compile time.
+};
+
+} // namespace plan_file
+
+/**
+ * @brief Writes a compiled plan to a file.
+ * @param structural_hash The hash of the TaskGraph that produced the plan,
+ * see TaskGraph::structural_hash().
+ * @throws std::runtime_error on I/O failure.
+ */
+void write_plan_file(const ExecutionPlan& plan, std::uint64_t structural_hash,
+    const std::string& path);
+
+/**
+ * @brief A read-only, memory-mapped plan file.
+ *
+ * @details
+ * Opening the file validates the header and the section bounds only; the
+ * arrays are accessed in place. The file has no checksum: the indices, and
+ * the links between tasks and slots, are checked by
+ * TaskGraph::compile(const MappedPlanFile&).
+ */
+class MappedPlanFile
+{
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be mapped, or if it is
+     * not a valid plan file of the current version.
+     */
+    explicit MappedPlanFile(const std::string& path);
+    ~MappedPlanFile();
+
+    const plan_file::Header& header() const;
+    std::uint64_t structural_hash() const;
+
+    const plan_file::Task* tasks() const;
+    const plan_file::Binding* bindings() const;
+    const plan_file::Slot* slots() const;
+    const std::int32_t* slot_refs() const;
+    const std::int32_t* successors() const;
+    const std::int32_t* topological_order() const;
+
+    std::string_view slot_name(std::size_t slot) const;
+
+private:
+    MappedPlanFile(const MappedPlanFile&) = delete;
+    MappedPlanFile& operator=(const MappedPlanFile&) = delete;
+    MappedPlanFile(MappedPlanFile&&) = delete;
+    MappedPlanFile& operator=(MappedPlanFile&&) = delete;
+
+    void validate(const std::string& path) const;
+
+    template <typename T>
+    const T* section(std::uint64_t offset) const
+    {
+        return reinterpret_cast<const T*>(m_data + offset);
+    }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+
+    /**
+     * @brief Used when memory mapping is not available on the platform.
+     */
+    std::vector<std::uint64_t> m_fallback;
+};
+
+} // namespace tg::core
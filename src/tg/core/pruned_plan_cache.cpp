@@ -0,0 +1,77 @@
+#include <algorithm>
+#include "tg/core/pruned_plan_cache.hpp"
+#include "tg/core/execution_plan.hpp"
+
+namespace tg::core
+{
+
+PrunedPlanCache::PrunedPlanCache(ExecutionPlanPtr plan)
+    : m_plan{std::move(plan)}
+    , m_slot_index{}
+    , m_mutex{}
+    , m_pruned{}
+{
+    if (!m_plan)
+    {
+        throw std::invalid_argument("PrunedPlanCache::PrunedPlanCache(): plan cannot be null.");
+    }
+    m_slot_index.reserve(m_plan->slots.size());
+    for (std::size_t k = 0u; k < m_plan->slots.size(); ++k)
+    {
+        m_slot_index.emplace(m_plan->slots[k].name, static_cast<int>(k));
+    }
+}
+
+PrunedPlanCache::~PrunedPlanCache()
+{
+}
+
+const ExecutionPlanPtr& PrunedPlanCache::full_plan() const
+{
+    return m_plan;
+}
+
+ExecutionPlanPtr PrunedPlanCache::plan_for(const std::vector<std::string>& outputs)
+{
+    std::vector<int> output_slots;
+    output_slots.reserve(outputs.size());
+    for (const auto& name : outputs)
+    {
+        auto iter = m_slot_index.find(name);
+        if (iter == m_slot_index.end())
+        {
+            throw std::invalid_argument("PrunedPlanCache::plan_for(): unknown output " + name + ".");
+        }
+        output_slots.push_back(iter->second);
+    }
+    return this->plan_for_slots(std::move(output_slots));
+}
+
+ExecutionPlanPtr PrunedPlanCache::plan_for_slots(std::vector<int> output_slots)
+{
+    std::sort(output_slots.begin(), output_slots.end());
+    output_slots.erase(std::unique(output_slots.begin(), output_slots.end()), output_slots.end());
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto iter = m_pruned.find(output_slots);
+        if (iter != m_pruned.end())
+        {
+            return iter->second;
+        }
+    }
+    /**
+     * @note Pruning happens outside the lock. If two callers race on the
+     * same signature, the first plan inserted wins.
+     */
+    ExecutionPlanPtr pruned = m_plan->prune(output_slots);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_pruned.emplace(std::move(output_slots), std::move(pruned)).first->second;
+}
+
+std::size_t PrunedPlanCache::size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_pruned.size();
+}
+
+} // namespace tg::core
@@ -0,0 +1,63 @@
+#pragma once
+#include <map>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Caches pruned plans of one compiled plan, keyed by the set of
+ * requested outputs.
+ *
+ * @details
+ * A large "superset" graph is compiled once; each caller then requests the
+ * outputs it needs, and runs the plan returned by plan_for(), which only
+ * contains the tasks in the backward cone of those outputs (see
+ * ExecutionPlan::prune()). The signature of a request is its sorted set of
+ * slot indices, so the order of the names and duplicates do not matter.
+ *
+ * A dataset made by the full plan can be used with every pruned plan.
+ * Pruned plans share tasks with the full plan, so only one of them can run
+ * at a time.
+ *
+ * This class is thread-safe.
+ */
+class PrunedPlanCache
+{
+public:
+    explicit PrunedPlanCache(ExecutionPlanPtr plan);
+    ~PrunedPlanCache();
+
+    const ExecutionPlanPtr& full_plan() const;
+
+    /**
+     * @brief Returns the pruned plan for the given fully-qualified output
+     * names, pruning on first use.
+     * @throws std::invalid_argument if a name is not a slot of the plan.
+     */
+    ExecutionPlanPtr plan_for(const std::vector<std::string>& outputs);
+
+    /**
+     * @brief Returns the pruned plan for the given slot indices.
+     */
+    ExecutionPlanPtr plan_for_slots(std::vector<int> output_slots);
+
+    /**
+     * @brief Number of cached pruned plans.
+     */
+    std::size_t size() const;
+
+private:
+    PrunedPlanCache(const PrunedPlanCache&) = delete;
+    PrunedPlanCache& operator=(const PrunedPlanCache&) = delete;
+    PrunedPlanCache(PrunedPlanCache&&) = delete;
+    PrunedPlanCache& operator=(PrunedPlanCache&&) = delete;
+
+private:
+    ExecutionPlanPtr m_plan;
+    std::unordered_map<std::string, int> m_slot_index;
+    mutable std::mutex m_mutex;
+    std::map<std::vector<int>, ExecutionPlanPtr> m_pruned;
+};
+
+} // namespace tg::core
@@ -0,0 +1,405 @@
+#pragma once
+#include <functional>
+#include "tg/core/fwd.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/core/subgraph.hpp"
+#include "tg/core/task.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/task_input.hpp"
+#include "tg/core/task_output.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Merges two partial results into one.
+ * @details Must be associative. With ReductionShape::ArrivalOrder, it must
+ * also be commutative. Called concurrently from several workers.
+ */
+template <typename T>
+using CombineFunction = std::function<T(const T& lhs, const T& rhs)>;
+
+enum class ReductionShape
+{
+    /**
+     * @brief A balanced binary tree over the inputs, in their order.
+     * @details Each combine runs as soon as its two operands are ready, and
+     * the combines of a level run in parallel. The depth is log2(N), but a
+     * slow input still delays the combines on its path to the root.
+     */
+    Balanced = 0,
+
+    /**
+     * @brief Inputs are combined in the order they become ready.
+     * @details Each input is handed to the reduction as soon as it is
+     * produced; if another partial result is waiting, the two are combined
+     * right away, on the worker that brought the input, and the result is
+     * handed on in the same way. Combines never wait for a particular
+     * input, so a slow input only delays the last combine.
+     */
+    ArrivalOrder = 1
+};
+
+namespace reduction_detail
+{
+
+inline std::string local_name(const std::string& prefix, const std::string& kind, std::size_t level,
+    std::size_t index)
+{
+    return prefix + kind + "_" + std::to_string(level) + "_" + std::to_string(index);
+}
+
+template <typename T>
+std::shared_ptr<T> get_shared(const TaskData& data)
+{
+    std::shared_ptr<void> value;
+    TypeId type;
+    if (!data.try_get(value, type) || type != TypeId::of<T>())
+    {
+        throw std::runtime_error("Reduction: failed to get value of " + data.name());
+    }
+    return std::static_pointer_cast<T>(value);
+}
+
+template <typename T>
+void assign_shared(TaskData& data, std::shared_ptr<T> value)
+{
+    if (!data.try_assign(std::static_pointer_cast<void>(std::move(value)), TypeId::of<T>()))
+    {
+        throw std::runtime_error("Reduction: failed to assign value of " + data.name());
+    }
+}
+
+/**
+ * @brief Outputs its input, sharing the value. Reduces a single input.
+ */
+template <typename T>
+class ForwardTask final : public Task
+{
+public:
+    ForwardTask(const std::string& input, const std::string& output)
+        : Task{}
+        , m_input{std::make_shared<TaskInput<T>>(input)}
+        , m_output{std::make_shared<TaskOutput<T>>(output)}
+    {
+        auto dataset = this->get_dataset();
+        dataset->add(m_input);
+        dataset->add(m_output);
+        dataset->freeze_add();
+    }
+
+    void on_execute() final
+    {
+        assign_shared(*m_output, get_shared<T>(*m_input));
+    }
+
+private:
+    std::shared_ptr<TaskInput<T>> m_input;
+    std::shared_ptr<TaskOutput<T>> m_output;
+};
+
+/**
+ * @brief A node of a balanced reduction tree.
+ */
+template <typename T>
+class CombineTask final : public Task
+{
+public:
+    CombineTask(const std::string& lhs, const std::string& rhs, const std::string& output,
+        CombineFunction<T> combine)
+        : Task{}
+        , m_lhs{std::make_shared<TaskInput<T>>(lhs)}
+        , m_rhs{std::make_shared<TaskInput<T>>(rhs)}
+        , m_output{std::make_shared<TaskOutput<T>>(output)}
+        , m_combine{std::move(combine)}
+    {
+        auto dataset = this->get_dataset();
+        dataset->add(m_lhs);
+        dataset->add(m_rhs);
+        dataset->add(m_output);
+        dataset->freeze_add();
+    }
+
+    void on_execute() final
+    {
+        m_output->emplace(m_combine(**m_lhs, **m_rhs));
+    }
+
+private:
+    std::shared_ptr<TaskInput<T>> m_lhs;
+    std::shared_ptr<TaskInput<T>> m_rhs;
+    std::shared_ptr<TaskOutput<T>> m_output;
+    CombineFunction<T> m_combine;
+};
+
+/**
+ * @brief The partial results of an arrival-order reduction, shared by its
+ * tasks.
+ * @details Belongs to the tasks, like their data, which is why a plan can
+ * only be run by one call at a time.
+ */
+template <typename T>
+class ArrivalState
+{
+public:
+    ArrivalState(std::size_t leaves, CombineFunction<T> combine)
+        : m_mutex{"ArrivalState"}
+        , m_leaves{leaves}
+        , m_combine{std::move(combine)}
+        , m_waiting{}
+        , m_result{}
+    {
+    }
+
+    /**
+     * @details Clears what a failed run may have left.
+     */
+    void reset()
+    {
+        std::unique_lock<SiteMutex> lock(m_mutex);
+        m_waiting.clear();
+        m_result.reset();
+    }
+
+    /**
+     * @details Combines outside the lock, so that several workers can
+     * combine at once.
+     */
+    void arrive(std::shared_ptr<T> value)
+    {
+        std::size_t count = 1u;
+        while (true)
+        {
+            std::pair<std::shared_ptr<T>, std::size_t> other;
+            {
+                std::unique_lock<SiteMutex> lock(m_mutex);
+                if (count == m_leaves)
+                {
+                    m_result = std::move(value);
+                    return;
+                }
+                if (m_waiting.empty())
+                {
+                    m_waiting.emplace_back(std::move(value), count);
+                    return;
+                }
+                other = std::move(m_waiting.back());
+                m_waiting.pop_back();
+            }
+            value = std::make_shared<T>(m_combine(*other.first, *value));
+            count += other.second;
+        }
+    }
+
+    std::shared_ptr<T> take_result()
+    {
+        std::unique_lock<SiteMutex> lock(m_mutex);
+        if (!m_result)
+        {
+            throw std::logic_error("Reduction: not all inputs have arrived.");
+        }
+        return std::move(m_result);
+    }
+
+private:
+    SiteMutex m_mutex;
+    const std::size_t m_leaves;
+    const CombineFunction<T> m_combine;
+    std::vector<std::pair<std::shared_ptr<T>, std::size_t>> m_waiting;  ///< With their leaf counts.
+    std::shared_ptr<T> m_result;
+};
+
+/**
+ * @brief Starts an arrival-order reduction: resets its state, and outputs
+ * the token that every ArrivalTask reads, so that none of them can run
+ * before.
+ */
+template <typename T>
+class ArrivalStartTask final : public Task
+{
+public:
+    ArrivalStartTask(const std::string& token, std::shared_ptr<ArrivalState<T>> state)
+        : Task{}
+        , m_token{std::make_shared<TaskOutput<std::uint64_t>>(token)}
+        , m_state{std::move(state)}
+        , m_runs{0u}
+    {
+        auto dataset = this->get_dataset();
+        dataset->add(m_token);
+        dataset->freeze_add();
+    }
+
+    void on_execute() final
+    {
+        m_state->reset();
+        m_token->emplace(++m_runs);
+    }
+
+private:
+    std::shared_ptr<TaskOutput<std::uint64_t>> m_token;
+    std::shared_ptr<ArrivalState<T>> m_state;
+    std::uint64_t m_runs;
+};
+
+/**
+ * @brief Hands one input to an arrival-order reduction.
+ */
+template <typename T>
+class ArrivalTask final : public Task
+{
+public:
+    ArrivalTask(const std::string& start_token, const std::string& input, const std::string& token,
+        std::shared_ptr<ArrivalState<T>> state)
+        : Task{}
+        , m_start_token{std::make_shared<TaskInput<std::uint64_t>>(start_token)}
+        , m_input{std::make_shared<TaskInput<T>>(input)}
+        , m_token{std::make_shared<TaskOutput<std::uint64_t>>(token)}
+        , m_state{std::move(state)}
+    {
+        auto dataset = this->get_dataset();
+        dataset->add(m_start_token);
+        dataset->add(m_input);
+        dataset->add(m_token);
+        dataset->freeze_add();
+    }
+
+    void on_execute() final
+    {
+        m_state->arrive(get_shared<T>(*m_input));
+        m_token->emplace(**m_start_token);
+    }
+
+private:
+    std::shared_ptr<TaskInput<std::uint64_t>> m_start_token;
+    std::shared_ptr<TaskInput<T>> m_input;
+    std::shared_ptr<TaskOutput<std::uint64_t>> m_token;
+    std::shared_ptr<ArrivalState<T>> m_state;
+};
+
+/**
+ * @brief Outputs the result of an arrival-order reduction, once every
+ * ArrivalTask has run.
+ */
+template <typename T>
+class ArrivalResultTask final : public Task
+{
+public:
+    ArrivalResultTask(const std::vector<std::string>& tokens, const std::string& output,
+        std::shared_ptr<ArrivalState<T>> state)
+        : Task{}
+        , m_tokens{}
+        , m_output{std::make_shared<TaskOutput<T>>(output)}
+        , m_state{std::move(state)}
+    {
+        auto dataset = this->get_dataset();
+        for (const auto& token : tokens)
+        {
+            m_tokens.push_back(std::make_shared<TaskInput<std::uint64_t>>(token));
+            dataset->add(m_tokens.back());
+        }
+        dataset->add(m_output);
+        dataset->freeze_add();
+    }
+
+    void on_execute() final
+    {
+        assign_shared(*m_output, m_state->take_result());
+    }
+
+private:
+    std::vector<std::shared_ptr<TaskInput<std::uint64_t>>> m_tokens;
+    std::shared_ptr<TaskOutput<T>> m_output;
+    std::shared_ptr<ArrivalState<T>> m_state;
+};
+
+} // namespace reduction_detail
+
+/**
+ * @brief Adds the tasks that reduce @p inputs into @p output with
+ * @p combine to a subgraph.
+ *
+ * @details
+ * The inputs and the output are data names of @p subgraph, local or part
+ * of its interface. The intermediate results get local names starting with
+ * @p prefix, so that a subgraph can hold several reductions.
+ *
+ * A Balanced reduction adds N - 1 combine tasks. An ArrivalOrder reduction
+ * adds N + 2 tasks; the combines run inside the tasks that hand the inputs
+ * over. A single input is forwarded without copying it.
+ *
+ * An ArrivalOrder reduction shares state between its tasks in memory, so a
+ * plan using it cannot be split across processes by a GraphPartitioner.
+ *
+ * @throws std::invalid_argument if there are no inputs or no combine
+ * function.
+ */
+template <typename T>
+void add_reduction(Subgraph& subgraph, const std::string& prefix, const std::vector<std::string>& inputs,
+    const std::string& output, CombineFunction<T> combine, ReductionShape shape = ReductionShape::Balanced)
+{
+    using namespace reduction_detail;
+    if (inputs.empty() || !combine)
+    {
+        throw std::invalid_argument("add_reduction(): needs inputs and a combine function.");
+    }
+    if (inputs.size() == 1u)
+    {
+        subgraph.add_task(std::make_shared<ForwardTask<T>>(inputs.front(), output));
+        return;
+    }
+    if (shape == ReductionShape::ArrivalOrder)
+    {
+        auto state = std::make_shared<ArrivalState<T>>(inputs.size(), std::move(combine));
+        std::string start_token = prefix + "start";
+        subgraph.add_task(std::make_shared<ArrivalStartTask<T>>(start_token, state));
+        std::vector<std::string> tokens;
+        tokens.reserve(inputs.size());
+        for (std::size_t k = 0u; k < inputs.size(); ++k)
+        {
+            tokens.push_back(local_name(prefix, "arrived", 0u, k));
+            subgraph.add_task(std::make_shared<ArrivalTask<T>>(start_token, inputs[k], tokens.back(), state));
+        }
+        subgraph.add_task(std::make_shared<ArrivalResultTask<T>>(tokens, output, state));
+        return;
+    }
+    std::vector<std::string> level_names = inputs;
+    for (std::size_t level = 1u; level_names.size() > 1u; ++level)
+    {
+        std::vector<std::string> next_names;
+        next_names.reserve((level_names.size() + 1u) / 2u);
+        for (std::size_t k = 0u; k + 1u < level_names.size(); k += 2u)
+        {
+            next_names.push_back(level_names.size() == 2u ? output :
+                local_name(prefix, "partial", level, k / 2u));
+            subgraph.add_task(std::make_shared<CombineTask<T>>(level_names[k], level_names[k + 1u],
+                next_names.back(), combine));
+        }
+        if (level_names.size() % 2u != 0u)
+        {
+            next_names.push_back(level_names.back());
+        }
+        level_names = std::move(next_names);
+    }
+}
+
+/**
+ * @brief Makes a subgraph that reduces @p inputs into @p output; see
+ * add_reduction().
+ * @details The inputs and the output form the interface of the subgraph,
+ * and the intermediate results are qualified by its name.
+ */
+template <typename T>
+SubgraphPtr make_reduction(const std::string& name, const std::vector<std::string>& inputs,
+    const std::string& output, CombineFunction<T> combine, ReductionShape shape = ReductionShape::Balanced)
+{
+    auto subgraph = std::make_shared<Subgraph>(name);
+    for (const auto& input : inputs)
+    {
+        subgraph->add_input(input);
+    }
+    subgraph->add_output(output);
+    add_reduction<T>(*subgraph, "", inputs, output, std::move(combine), shape);
+    return subgraph;
+}
+
+} // namespace tg::core
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "tg/core/schedule_log.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+constexpr char schedule_magic[8] = {'T', 'G', 'S', 'C', 'H', 'E', 'D', '\0'};
+constexpr std::uint32_t schedule_version = 1u;
+
+struct ScheduleHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entry_size;
+    std::uint64_t task_count;
+};
+
+} // namespace
+
+ScheduleLog::ScheduleLog()
+    : m_entries{}
+{
+}
+
+ScheduleLog::~ScheduleLog()
+{
+}
+
+void ScheduleLog::reset(std::size_t task_count)
+{
+    m_entries.assign(task_count, ScheduledTask{-1, 0u, ScheduledTask::None, 0u, 0, 0});
+}
+
+std::size_t ScheduleLog::task_count() const
+{
+    return m_entries.size();
+}
+
+const ScheduledTask& ScheduleLog::at(int task_id) const
+{
+    return m_entries.at(static_cast<std::size_t>(task_id));
+}
+
+void ScheduleLog::set(int task_id, const ScheduledTask& entry)
+{
+    m_entries.at(static_cast<std::size_t>(task_id)) = entry;
+}
+
+std::vector<int> ScheduleLog::start_order() const
+{
+    std::vector<int> order(m_entries.size());
+    for (std::size_t k = 0u; k < order.size(); ++k)
+    {
+        order[k] = static_cast<int>(k);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b)
+        { return m_entries[a].sequence < m_entries[b].sequence; });
+    return order;
+}
+
+void ScheduleLog::save(const std::string& path) const
+{
+    ScheduleHeader header{};
+    std::memcpy(header.magic, schedule_magic, sizeof(header.magic));
+    header.version = schedule_version;
+    header.entry_size = sizeof(ScheduledTask);
+    header.task_count = m_entries.size();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_entries.data()),
+        static_cast<std::streamsize>(m_entries.size() * sizeof(ScheduledTask)));
+    if (!file)
+    {
+        throw std::runtime_error("ScheduleLog::save(): cannot write " + path);
+    }
+}
+
+ScheduleLog ScheduleLog::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    ScheduleHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, schedule_magic, sizeof(header.magic)) != 0 ||
+        header.version != schedule_version || header.entry_size != sizeof(ScheduledTask))
+    {
+        throw std::runtime_error("ScheduleLog::load(): not a schedule log: " + path);
+    }
+    file.seekg(0, std::ios::end);
+    std::uint64_t payload = static_cast<std::uint64_t>(file.tellg()) - sizeof(header);
+    if (header.task_count > payload / sizeof(ScheduledTask))
+    {
+        throw std::runtime_error("ScheduleLog::load(): truncated file: " + path);
+    }
+    file.seekg(sizeof(header));
+    ScheduleLog log;
+    log.reset(static_cast<std::size_t>(header.task_count));
+    if (!file.read(reinterpret_cast<char*>(log.m_entries.data()),
+            static_cast<std::streamsize>(log.m_entries.size() * sizeof(ScheduledTask))))
+    {
+        throw std::runtime_error("ScheduleLog::load(): truncated file: " + path);
+    }
+    return log;
+}
+
+} // namespace tg::core
@@ -0,0 +1,81 @@
+#pragma once
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief How one task of a run was scheduled.
+ */
+struct ScheduledTask
+{
+    enum Flags : std::uint32_t
+    {
+        None = 0u,
+        Skipped = 1u,  ///< The task was skipped rather than executed.
+    };
+
+    std::int32_t worker;  ///< Worker that started the task, or -1.
+    std::uint32_t sequence;  ///< Rank of the task in the global start order.
+    std::uint32_t flags;
+    std::uint32_t reserved;
+    std::int64_t start_ns;  ///< Start time, relative to the start of the run.
+    std::int64_t duration_ns;  ///< Until the task completed; zero if skipped.
+};
+
+/**
+ * @brief A compact record of the schedule of one run: which worker started
+ * each task, in which global order, and when.
+ *
+ * @details
+ * A log is recorded by passing it in RunOptions::record_schedule, and
+ * replayed by passing it in RunOptions::replay_schedule; see Executor.
+ * Entries are indexed by task, in the order of the plan's tasks, so a log
+ * can only be replayed on a plan with the same structure.
+ *
+ * The file format is a small header followed by the entries, in host byte
+ * order.
+ */
+class ScheduleLog
+{
+public:
+    ScheduleLog();
+    ~ScheduleLog();
+
+    /**
+     * @brief Clears the log, and sizes it for a plan of @p task_count tasks.
+     */
+    void reset(std::size_t task_count);
+
+    std::size_t task_count() const;
+
+    const ScheduledTask& at(int task_id) const;
+
+    /**
+     * @brief Sets the entry of a task.
+     * @details Entries of different tasks can be set from different threads
+     * concurrently.
+     */
+    void set(int task_id, const ScheduledTask& entry);
+
+    /**
+     * @brief Task ids in the order they were started.
+     */
+    std::vector<int> start_order() const;
+
+    /**
+     * @throws std::runtime_error on I/O failure.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @throws std::runtime_error if the file cannot be read, or is not a
+     * schedule log.
+     */
+    static ScheduleLog load(const std::string& path);
+
+private:
+    std::vector<ScheduledTask> m_entries;
+};
+
+} // namespace tg::core
@@ -0,0 +1,133 @@
+#include <new>
+#include "tg/core/scratch_arena.hpp"
+
+namespace tg::core
+{
+
+ScratchArena::ScratchArena(std::size_t initial_capacity)
+    : m_blocks{}
+    , m_block{0u}
+    , m_offset{0u}
+    , m_initial_capacity{initial_capacity}
+    , m_heap_allocations{0u}
+{
+}
+
+ScratchArena::~ScratchArena()
+{
+    this->free_blocks();
+}
+
+ScratchArena& ScratchArena::for_this_thread()
+{
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+void* ScratchArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (alignment == 0u || (alignment & (alignment - 1u)) != 0u || alignment > default_alignment)
+    {
+        throw std::invalid_argument("ScratchArena::allocate(): bad alignment " + std::to_string(alignment));
+    }
+    while (m_block < m_blocks.size())
+    {
+        const Block& block = m_blocks[m_block];
+        std::size_t offset = (m_offset + alignment - 1u) & ~(alignment - 1u);
+        if (offset <= block.size && bytes <= block.size - offset)
+        {
+            m_offset = offset + bytes;
+            return block.data + offset;
+        }
+        if (m_block + 1u == m_blocks.size())
+        {
+            break;
+        }
+        ++m_block;
+        m_offset = 0u;
+    }
+    this->add_block(bytes);
+    m_offset = bytes;
+    return m_blocks[m_block].data;
+}
+
+ScratchArena::Marker ScratchArena::mark() const
+{
+    return Marker{m_block, m_offset};
+}
+
+/**
+ * @details Rewinding to empty is where the blocks are merged, since nothing
+ * can point into them then.
+ */
+void ScratchArena::rewind(const Marker& marker)
+{
+    m_block = marker.block;
+    m_offset = marker.offset;
+    if (m_block == 0u && m_offset == 0u && m_blocks.size() > 1u)
+    {
+        std::size_t total = this->capacity();
+        this->free_blocks();
+        this->add_block(total);
+        m_block = 0u;
+        m_offset = 0u;
+    }
+}
+
+void ScratchArena::reset()
+{
+    this->rewind(Marker{});
+}
+
+std::size_t ScratchArena::used() const
+{
+    if (m_blocks.empty())
+    {
+        return 0u;
+    }
+    return m_blocks[m_block].used_before + m_offset;
+}
+
+std::size_t ScratchArena::capacity() const
+{
+    if (m_blocks.empty())
+    {
+        return 0u;
+    }
+    return m_blocks.back().used_before + m_blocks.back().size;
+}
+
+std::size_t ScratchArena::heap_allocations() const
+{
+    return m_heap_allocations;
+}
+
+/**
+ * @details Appends a block, at least twice the size of the last one, and
+ * makes it current.
+ */
+void ScratchArena::add_block(std::size_t min_bytes)
+{
+    std::size_t size = m_blocks.empty() ? m_initial_capacity : m_blocks.back().size * 2u;
+    if (size < min_bytes)
+    {
+        size = min_bytes;
+    }
+    size = (size + default_alignment - 1u) & ~(default_alignment - 1u);
+    char* data = static_cast<char*>(::operator new(size, std::align_val_t{default_alignment}));
+    m_blocks.push_back(Block{data, size, this->capacity()});
+    m_block = m_blocks.size() - 1u;
+    m_offset = 0u;
+    ++m_heap_allocations;
+}
+
+void ScratchArena::free_blocks()
+{
+    for (const auto& block : m_blocks)
+    {
+        ::operator delete(block.data, std::align_val_t{default_alignment});
+    }
+    m_blocks.clear();
+}
+
+} // namespace tg::core
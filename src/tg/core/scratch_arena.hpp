@@ -0,0 +1,132 @@
+#pragma once
+#include <type_traits>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A bump allocator for the temporary buffers of a running task, such
+ * as the intermediate pass of a separable filter.
+ *
+ * @details
+ * Each thread has its own arena (see TaskContext::scratch()), so allocating
+ * takes no lock and is a pointer increment in the common case. Memory is
+ * never freed individually: the TaskContext marks the arena before the task
+ * runs and rewinds to the mark when the task returns. A nested graph run
+ * inside a task therefore stacks its tasks' scratch on top of the outer
+ * task's, and leaves it intact.
+ *
+ * The arena keeps its memory across tasks. When it is rewound to empty
+ * after having grown by more than one block, the blocks are replaced with
+ * one block of their total size, so that a steady workload runs out of a
+ * single block and allocates nothing from the heap.
+ *
+ * Scratch memory is uninitialized, and no destructors are run on rewind, so
+ * only trivially destructible types may be placed in it.
+ */
+class ScratchArena
+{
+public:
+    /**
+     * @brief Cache-line alignment, the default for allocations.
+     */
+    static constexpr std::size_t default_alignment = 64u;
+
+    /**
+     * @brief A position in the arena, to rewind to.
+     */
+    struct Marker
+    {
+        std::size_t block = 0u;
+        std::size_t offset = 0u;
+    };
+
+    /**
+     * @param initial_capacity Bytes of the first block, allocated on the
+     * first allocation.
+     */
+    explicit ScratchArena(std::size_t initial_capacity = 64u * 1024u);
+    ~ScratchArena();
+
+    /**
+     * @brief The arena of the calling thread.
+     */
+    static ScratchArena& for_this_thread();
+
+    /**
+     * @param alignment A power of two, at most default_alignment.
+     * @return Uninitialized memory, valid until the arena is rewound past
+     * it.
+     * @throws std::invalid_argument on a bad alignment.
+     * @throws std::bad_alloc if a new block cannot be allocated.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = default_alignment);
+
+    /**
+     * @brief Allocates an uninitialized array of @p count elements.
+     */
+    template <typename T>
+    T* allocate_array(std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+            "ScratchArena does not run destructors.");
+        static_assert(alignof(T) <= default_alignment, "Over-aligned type.");
+        return static_cast<T*>(this->allocate(count * sizeof(T), default_alignment));
+    }
+
+    Marker mark() const;
+
+    /**
+     * @brief Releases everything allocated since @p marker was taken.
+     */
+    void rewind(const Marker& marker);
+
+    /**
+     * @brief Releases everything.
+     */
+    void reset();
+
+    /**
+     * @brief Bytes currently allocated, including alignment padding.
+     */
+    std::size_t used() const;
+
+    /**
+     * @brief Bytes held in blocks.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Number of blocks allocated from the heap since construction.
+     * @details Stops increasing once the arena has warmed up to the
+     * workload.
+     */
+    std::size_t heap_allocations() const;
+
+private:
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+    ScratchArena(ScratchArena&&) = delete;
+    ScratchArena& operator=(ScratchArena&&) = delete;
+
+private:
+    struct Block
+    {
+        char* data;
+        std::size_t size;
+        std::size_t used_before;  ///< Sum of the sizes of the earlier blocks.
+    };
+
+    void add_block(std::size_t min_bytes);
+    void free_blocks();
+
+private:
+    std::vector<Block> m_blocks;
+    std::size_t m_block;  ///< Index of the current block, if any.
+    std::size_t m_offset;  ///< Into the current block.
+    std::size_t m_initial_capacity;
+    std::size_t m_heap_allocations;
+};
+
+} // namespace tg::core
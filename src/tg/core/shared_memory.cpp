@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#if defined(LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "tg/core/shared_memory.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+constexpr char segment_magic[8] = {'T', 'G', 'S', 'H', 'M', 'E', 'M', '\0'};
+
+/**
+ * @brief Blocks and their headers are aligned to this, which is also the
+ * largest supported alignment.
+ */
+constexpr std::size_t block_alignment = 64u;
+
+/**
+ * @brief At the start of each segment, in shared memory.
+ */
+struct SegmentHeader
+{
+    char magic[8];
+    std::uint64_t capacity;
+    std::atomic<std::uint64_t> bump;  ///< End of the allocated blocks; written by the owner only.
+    std::atomic<std::uint64_t> live_blocks;
+};
+
+/**
+ * @brief Right before each payload, in shared memory.
+ */
+struct BlockHeader
+{
+    std::atomic<std::uint32_t> refs;
+    std::atomic<std::uint32_t> tag;  ///< block_tag() of the payload offset while live, else 0.
+    std::uint64_t size;
+};
+
+/**
+ * @brief Marks the header of a live block, so that a handle whose offset
+ * points into a payload, or at a dead block, is told apart from a real one.
+ */
+std::uint32_t block_tag(std::uint64_t offset)
+{
+    return static_cast<std::uint32_t>(offset / block_alignment) ^ 0x5447424bu;
+}
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+    std::atomic<std::uint64_t>::is_always_lock_free,
+    "Shared memory reference counts require address-free atomics");
+static_assert(sizeof(SegmentHeader) <= block_alignment && sizeof(BlockHeader) <= block_alignment,
+    "Headers must fit in one alignment unit");
+
+std::size_t round_up(std::size_t value)
+{
+    return (value + block_alignment - 1u) & ~(block_alignment - 1u);
+}
+
+} // namespace
+
+/**
+ * @brief A memfd mapped into this process.
+ */
+class SharedMemoryPool::Segment
+{
+public:
+    Segment(std::uint64_t id, int fd, char* base, std::size_t capacity)
+        : m_id{id}
+        , m_fd{fd}
+        , m_base{base}
+        , m_capacity{capacity}
+    {
+    }
+
+    ~Segment()
+    {
+#if defined(LINUX)
+        ::munmap(m_base, m_capacity);
+        ::close(m_fd);
+#endif
+    }
+
+    std::uint64_t id() const
+    {
+        return m_id;
+    }
+
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    char* base() const
+    {
+        return m_base;
+    }
+
+    std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    SegmentHeader& header() const
+    {
+        return *reinterpret_cast<SegmentHeader*>(m_base);
+    }
+
+    BlockHeader& block_at(std::uint64_t offset) const
+    {
+        return *reinterpret_cast<BlockHeader*>(m_base + offset - block_alignment);
+    }
+
+    bool contains(const void* pointer) const
+    {
+        const char* p = static_cast<const char*>(pointer);
+        return p >= m_base && p < m_base + m_capacity;
+    }
+
+    /**
+     * @brief Whether @p offset may be the payload offset of a block.
+     */
+    bool is_block_offset(std::uint64_t offset) const
+    {
+        return offset >= 2u * block_alignment && offset % block_alignment == 0u &&
+            offset < this->header().bump.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Whether @p offset is the payload offset of a live block, of
+     * @p size bytes if given.
+     */
+    bool is_live_block(std::uint64_t offset, std::optional<std::uint64_t> size = std::nullopt) const
+    {
+        if (!this->is_block_offset(offset))
+        {
+            return false;
+        }
+        const auto& block = this->block_at(offset);
+        return block.tag.load(std::memory_order_acquire) == block_tag(offset) &&
+            block.refs.load(std::memory_order_acquire) > 0u &&
+            (!size || (block.size == *size && *size <= m_capacity - offset));
+    }
+
+    /**
+     * @brief Reserves a block of @p total bytes, header included, and
+     * returns the payload offset, or 0 if the segment is full.
+     * @note Called by the owner only, under the pool's mutex.
+     */
+    std::uint64_t try_reserve(std::size_t total)
+    {
+        auto& header = this->header();
+        std::uint64_t bump = header.bump.load(std::memory_order_relaxed);
+        if (header.live_blocks.load(std::memory_order_acquire) == 0u)
+        {
+            bump = block_alignment;
+        }
+        if (total > m_capacity - bump)
+        {
+            return 0u;
+        }
+        header.live_blocks.fetch_add(1u, std::memory_order_acq_rel);
+        header.bump.store(bump + total, std::memory_order_release);
+        return bump + block_alignment;
+    }
+
+private:
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+    Segment(Segment&&) = delete;
+    Segment& operator=(Segment&&) = delete;
+
+private:
+    std::uint64_t m_id;
+    int m_fd;
+    char* m_base;
+    std::size_t m_capacity;
+};
+
+SharedMemoryPool::SharedMemoryPool(std::size_t segment_size)
+    : m_segment_size{round_up(segment_size)}
+    , m_mutex{}
+    , m_owned{}
+    , m_attached{}
+    , m_next_segment{0u}
+{
+}
+
+SharedMemoryPool::~SharedMemoryPool()
+{
+}
+
+#if defined(LINUX)
+
+std::shared_ptr<void> SharedMemoryPool::allocate(std::size_t size, std::size_t alignment)
+{
+    if (alignment == 0u || (alignment & (alignment - 1u)) != 0u || alignment > block_alignment)
+    {
+        throw std::invalid_argument("SharedMemoryPool::allocate(): unsupported alignment.");
+    }
+    std::size_t total = block_alignment + round_up(size);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    SegmentPtr segment;
+    std::uint64_t offset = 0u;
+    for (const auto& owned : m_owned)
+    {
+        offset = owned->try_reserve(total);
+        if (offset)
+        {
+            segment = owned;
+            break;
+        }
+    }
+    if (!segment)
+    {
+        std::size_t capacity = std::max(m_segment_size, block_alignment + total);
+        std::uint64_t id = (static_cast<std::uint64_t>(::getpid()) << 32u) | m_next_segment++;
+        int fd = ::memfd_create("tg_shared_memory", MFD_CLOEXEC);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw std::runtime_error("SharedMemoryPool::allocate(): cannot create a segment.");
+        }
+        void* addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("SharedMemoryPool::allocate(): cannot map a segment.");
+        }
+        segment = std::make_shared<Segment>(id, fd, static_cast<char*>(addr), capacity);
+        auto* header = new (segment->base()) SegmentHeader{};
+        std::memcpy(header->magic, segment_magic, sizeof(header->magic));
+        header->capacity = capacity;
+        header->bump.store(block_alignment, std::memory_order_relaxed);
+        header->live_blocks.store(0u, std::memory_order_relaxed);
+        m_owned.push_back(segment);
+        offset = segment->try_reserve(total);
+    }
+    lock.unlock();
+
+    auto* block = new (segment->base() + offset - block_alignment) BlockHeader{};
+    block->refs.store(1u, std::memory_order_relaxed);
+    block->size = size;
+    block->tag.store(block_tag(offset), std::memory_order_release);
+    std::memset(segment->base() + offset, 0, size);
+    return adopt(segment, offset);
+}
+
+void SharedMemoryPool::attach(std::uint64_t segment_id, int fd)
+{
+    if (this->find_segment(segment_id))
+    {
+        ::close(fd);
+        return;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < block_alignment)
+    {
+        ::close(fd);
+        throw std::invalid_argument("SharedMemoryPool::attach(): not a segment.");
+    }
+    std::size_t capacity = static_cast<std::size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+        ::close(fd);
+        throw std::runtime_error("SharedMemoryPool::attach(): cannot map the segment.");
+    }
+    auto segment = std::make_shared<Segment>(segment_id, fd, static_cast<char*>(addr), capacity);
+    const auto& header = segment->header();
+    if (std::memcmp(header.magic, segment_magic, sizeof(header.magic)) != 0 ||
+        header.capacity != capacity)
+    {
+        throw std::invalid_argument("SharedMemoryPool::attach(): not a segment.");
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_attached.push_back(std::move(segment));
+}
+
+#else
+
+std::shared_ptr<void> SharedMemoryPool::allocate(std::size_t /* size */, std::size_t /* alignment */)
+{
+    throw not_implemented("SharedMemoryPool::allocate(): not available on this platform.");
+}
+
+void SharedMemoryPool::attach(std::uint64_t /* segment_id */, int /* fd */)
+{
+    throw not_implemented("SharedMemoryPool::attach(): not available on this platform.");
+}
+
+#endif
+
+bool SharedMemoryPool::contains(const void* pointer) const
+{
+    return this->find_segment(pointer) != nullptr;
+}
+
+SharedHandle SharedMemoryPool::export_handle(const std::shared_ptr<void>& value)
+{
+    SegmentPtr segment = this->find_segment(value.get());
+    std::uint64_t offset = segment ?
+        static_cast<std::uint64_t>(static_cast<const char*>(value.get()) - segment->base()) : 0u;
+    if (!segment || !segment->is_live_block(offset))
+    {
+        throw std::invalid_argument("SharedMemoryPool::export_handle(): not a shared memory block.");
+    }
+    auto& block = segment->block_at(offset);
+    block.refs.fetch_add(1u, std::memory_order_relaxed);
+    return SharedHandle{segment->id(), offset, block.size};
+}
+
+std::shared_ptr<void> SharedMemoryPool::import_handle(const SharedHandle& handle)
+{
+    SegmentPtr segment = this->find_segment(handle.segment_id);
+    if (!segment || !segment->is_live_block(handle.offset, handle.size))
+    {
+        throw std::invalid_argument("SharedMemoryPool::import_handle(): unknown block.");
+    }
+    return adopt(segment, handle.offset);
+}
+
+void SharedMemoryPool::discard_handle(const SharedHandle& handle)
+{
+    this->import_handle(handle).reset();
+}
+
+int SharedMemoryPool::segment_fd(std::uint64_t segment_id) const
+{
+    SegmentPtr segment = this->find_segment(segment_id);
+    return segment ? segment->fd() : -1;
+}
+
+void SharedMemoryPool::detach(std::uint64_t segment_id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_attached.erase(std::remove_if(m_attached.begin(), m_attached.end(),
+        [segment_id](const SegmentPtr& segment) { return segment->id() == segment_id; }),
+        m_attached.end());
+}
+
+std::vector<std::uint64_t> SharedMemoryPool::owned_segments() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::vector<std::uint64_t> ids;
+    for (const auto& segment : m_owned)
+    {
+        ids.push_back(segment->id());
+    }
+    return ids;
+}
+
+SharedMemoryPool::SegmentPtr SharedMemoryPool::find_segment(const void* pointer) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (const auto* segments : {&m_owned, &m_attached})
+    {
+        for (const auto& segment : *segments)
+        {
+            if (segment->contains(pointer))
+            {
+                return segment;
+            }
+        }
+    }
+    return nullptr;
+}
+
+SharedMemoryPool::SegmentPtr SharedMemoryPool::find_segment(std::uint64_t segment_id) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (const auto* segments : {&m_owned, &m_attached})
+    {
+        for (const auto& segment : *segments)
+        {
+            if (segment->id() == segment_id)
+            {
+                return segment;
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Wraps one reference to a block. The last reference in any process
+ * makes the block dead; the segment stays mapped while any block refers to
+ * it.
+ */
+std::shared_ptr<void> SharedMemoryPool::adopt(const SegmentPtr& segment, std::uint64_t offset)
+{
+    return std::shared_ptr<void>(segment->base() + offset, [segment, offset](void*)
+        {
+            auto& block = segment->block_at(offset);
+            if (block.refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                block.tag.store(0u, std::memory_order_release);
+                segment->header().live_blocks.fetch_sub(1u, std::memory_order_acq_rel);
+            }
+        });
+}
+
+} // namespace tg::core
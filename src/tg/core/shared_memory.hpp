@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief Refers to a block of shared memory, in a form that can be sent to
+ * another process.
+ * @details The receiving process must have attached the segment, using the
+ * file descriptor of the segment, before importing the handle.
+ */
+struct SharedHandle
+{
+    std::uint64_t segment_id;
+    std::uint64_t offset;  ///< Offset of the payload in the segment.
+    std::uint64_t size;
+};
+
+/**
+ * @brief Allocates values in memfd-backed shared memory, and exchanges them
+ * with other processes as handles, without copying the payload.
+ *
+ * @details
+ * Each process has its own SharedMemoryPool. A pool owns the segments it
+ * creates, and attaches the segments of its peers. Only the owner allocates
+ * in a segment.
+ *
+ * Each block starts with a reference count in the shared memory itself, so
+ * that a block can be referenced from several processes. A block is live
+ * while any process holds a reference; export_handle() adds one reference
+ * for the receiver, which import_handle() adopts. A segment is reused from
+ * the start once none of its blocks are live, which suits pipelines whose
+ * values are released frame by frame.
+ *
+ * Only trivially copyable values and raw buffers can be shared, since their
+ * bytes mean the same in every process, and no destructor has to run.
+ *
+ * @note References held by a peer that crashed are only reclaimed when the
+ * segment is destroyed, that is, when every process has dropped it.
+ *
+ * Peers are trusted. import_handle() accepts only the handle of a live
+ * block, which catches stale and corrupted handles, but every process that
+ * attaches a segment maps it writable, and can overwrite any block and
+ * header in it. Do not share segments with a process that is not trusted
+ * with the data of every block in them.
+ *
+ * This class is thread-safe. Only available on Linux.
+ */
+class SharedMemoryPool
+{
+public:
+    /**
+     * @param segment_size Capacity of each segment created by this pool.
+     * Larger blocks get a segment of their own.
+     */
+    explicit SharedMemoryPool(std::size_t segment_size = std::size_t{64u} << 20u);
+    ~SharedMemoryPool();
+
+    /**
+     * @brief Allocates a zero-filled block in shared memory.
+     * @param alignment A power of two, at most 64.
+     * @throws not_implemented on platforms without memfd.
+     */
+    std::shared_ptr<void> allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Whether a pointer lies in a segment of this pool, owned or
+     * attached.
+     */
+    bool contains(const void* pointer) const;
+
+    /**
+     * @brief Returns a handle to a block allocated by, or imported into,
+     * this pool, to be sent to a peer. Adds one reference to the block on
+     * behalf of the receiver.
+     * @throws std::invalid_argument if the value is not in shared memory.
+     */
+    SharedHandle export_handle(const std::shared_ptr<void>& value);
+
+    /**
+     * @brief Returns the block referred to by a received handle, adopting
+     * the reference added by the sender.
+     * @throws std::invalid_argument if the segment is not attached, or the
+     * handle does not refer to the start of a live block of its size.
+     */
+    std::shared_ptr<void> import_handle(const SharedHandle& handle);
+
+    /**
+     * @brief Drops the reference carried by a received handle, without
+     * importing it.
+     */
+    void discard_handle(const SharedHandle& handle);
+
+    /**
+     * @brief The file descriptor of a segment of this pool, to be passed to
+     * a peer (for example, with SCM_RIGHTS), or -1 if unknown.
+     */
+    int segment_fd(std::uint64_t segment_id) const;
+
+    /**
+     * @brief Maps a segment of a peer. The pool takes ownership of @p fd.
+     * Attaching a segment twice has no effect.
+     */
+    void attach(std::uint64_t segment_id, int fd);
+
+    /**
+     * @brief Unmaps a segment of a peer. Blocks imported from it remain
+     * valid until they are released.
+     */
+    void detach(std::uint64_t segment_id);
+
+    /**
+     * @brief Ids of the segments owned by this pool.
+     */
+    std::vector<std::uint64_t> owned_segments() const;
+
+private:
+    SharedMemoryPool(const SharedMemoryPool&) = delete;
+    SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+    SharedMemoryPool(SharedMemoryPool&&) = delete;
+    SharedMemoryPool& operator=(SharedMemoryPool&&) = delete;
+
+private:
+    class Segment;
+    using SegmentPtr = std::shared_ptr<Segment>;
+
+    SegmentPtr find_segment(const void* pointer) const;
+    SegmentPtr find_segment(std::uint64_t segment_id) const;
+    static std::shared_ptr<void> adopt(const SegmentPtr& segment, std::uint64_t offset);
+
+private:
+    const std::size_t m_segment_size;
+    mutable std::mutex m_mutex;
+    std::vector<SegmentPtr> m_owned;  ///< Guarded by m_mutex.
+    std::vector<SegmentPtr> m_attached;  ///< Guarded by m_mutex.
+    std::uint32_t m_next_segment;  ///< Guarded by m_mutex.
+};
+
+/**
+ * @brief Constructs a value of type T in shared memory.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_shared_in(SharedMemoryPool& pool, Args&&... args)
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+        "Only trivially copyable values can be placed in shared memory");
+    std::shared_ptr<void> block = pool.allocate(sizeof(T), alignof(T));
+    T* value = new (block.get()) T(std::forward<Args>(args)...);
+    return std::shared_ptr<T>(std::move(block), value);
+}
+
+} // namespace tg::core
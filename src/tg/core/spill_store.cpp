@@ -0,0 +1,259 @@
+#include <cstdlib>
+#if defined(LINUX) || defined(MACOS)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "tg/core/spill_store.hpp"
+#include "tg/core/spill_traits.hpp"
+
+namespace tg::core
+{
+
+SpillRegion::SpillRegion(std::shared_ptr<SpillStore> store, std::uint64_t offset,
+    std::size_t size, std::size_t capacity)
+    : m_store{std::move(store)}
+    , m_offset{offset}
+    , m_size{size}
+    , m_capacity{capacity}
+{
+}
+
+SpillRegion::~SpillRegion()
+{
+    m_store->free(m_offset, m_capacity);
+}
+
+SpillStore& SpillRegion::store() const
+{
+    return *m_store;
+}
+
+std::uint64_t SpillRegion::offset() const
+{
+    return m_offset;
+}
+
+std::size_t SpillRegion::size() const
+{
+    return m_size;
+}
+
+std::size_t SpillRegion::capacity() const
+{
+    return m_capacity;
+}
+
+#if defined(LINUX) || defined(MACOS)
+
+namespace
+{
+
+/**
+ * @brief Maps a region of the scratch file.
+ * @details A zero-sized value still maps one page, since empty mappings
+ * are not allowed.
+ */
+void* map_region(int fd, std::uint64_t offset, std::size_t capacity, int protection, int flags)
+{
+    void* addr = ::mmap(nullptr, capacity, protection, flags, fd, static_cast<off_t>(offset));
+    if (addr == MAP_FAILED)
+    {
+        throw std::runtime_error("SpillStore: cannot map the scratch file.");
+    }
+    return addr;
+}
+
+} // namespace
+
+SpillStorePtr SpillStore::create(const std::string& directory)
+{
+    std::string path = directory + "/tg_spill_XXXXXX";
+    int fd = ::mkstemp(path.data());
+    if (fd < 0)
+    {
+        throw std::runtime_error("SpillStore::create(): cannot create a scratch file in " + directory);
+    }
+    ::unlink(path.c_str());
+    return SpillStorePtr{new SpillStore{fd}};
+}
+
+SpillStore::SpillStore(int fd)
+    : m_fd{fd}
+    , m_page_size{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))}
+    , m_mutex{}
+    , m_file_size{0u}
+    , m_spilled_bytes{0u}
+    , m_free{}
+    , m_free_by_offset{}
+{
+}
+
+SpillStore::~SpillStore()
+{
+    ::close(m_fd);
+}
+
+SpillRegionPtr SpillStore::write(const SpillCodec& codec, const void* value)
+{
+    std::size_t size = codec.spill_size(value);
+    std::size_t capacity = std::max<std::size_t>((size + m_page_size - 1u) / m_page_size, 1u) * m_page_size;
+    std::uint64_t offset = this->allocate(capacity);
+    auto region = std::make_shared<SpillRegion>(this->shared_from_this(), offset, size, capacity);
+    void* addr = map_region(m_fd, offset, capacity, PROT_READ | PROT_WRITE, MAP_SHARED);
+    try
+    {
+        codec.spill(value, addr);
+    }
+    catch (...)
+    {
+        ::munmap(addr, capacity);
+        throw;
+    }
+    ::munmap(addr, capacity);
+    return region;
+}
+
+std::shared_ptr<void> SpillStore::read(const SpillCodec& codec, const SpillRegionPtr& region) const
+{
+    std::size_t capacity = region->capacity();
+    void* addr = map_region(m_fd, region->offset(), capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE);
+    std::shared_ptr<void> bytes{addr, [region, capacity](void* p) { ::munmap(p, capacity); }};
+    return codec.restore(std::move(bytes), region->size());
+}
+
+std::uint64_t SpillStore::allocate(std::size_t capacity)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_spilled_bytes += capacity;
+    auto iter = m_free.lower_bound(capacity);
+    if (iter != m_free.end())
+    {
+        std::uint64_t offset = iter->second;
+        std::size_t free_capacity = iter->first;
+        this->remove_free(m_free_by_offset.find(offset));
+        if (free_capacity > capacity)
+        {
+            this->add_free(offset + capacity, free_capacity - capacity);
+        }
+        return offset;
+    }
+    std::uint64_t offset = m_file_size;
+    if (::ftruncate(m_fd, static_cast<off_t>(offset + capacity)) != 0)
+    {
+        m_spilled_bytes -= capacity;
+        throw std::runtime_error("SpillStore: cannot grow the scratch file.");
+    }
+    m_file_size = offset + capacity;
+    return offset;
+}
+
+/**
+ * @details A region at the end of the file is given back to the file
+ * system instead; if truncating fails, it is kept as a free region.
+ */
+void SpillStore::free(std::uint64_t offset, std::size_t capacity)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_spilled_bytes -= capacity;
+    auto next = m_free_by_offset.lower_bound(offset);
+    if (next != m_free_by_offset.end() && offset + capacity == next->first)
+    {
+        capacity += next->second;
+        this->remove_free(next);
+    }
+    auto prev = m_free_by_offset.lower_bound(offset);
+    if (prev != m_free_by_offset.begin() && (--prev)->first + prev->second == offset)
+    {
+        offset = prev->first;
+        capacity += prev->second;
+        this->remove_free(prev);
+    }
+    if (offset + capacity == m_file_size && ::ftruncate(m_fd, static_cast<off_t>(offset)) == 0)
+    {
+        m_file_size = offset;
+        return;
+    }
+    this->add_free(offset, capacity);
+}
+
+#else
+
+SpillStorePtr SpillStore::create(const std::string& /* directory */)
+{
+    throw not_implemented("SpillStore::create(): not available on this platform.");
+}
+
+SpillStore::SpillStore(int fd)
+    : m_fd{fd}
+    , m_page_size{0u}
+    , m_mutex{}
+    , m_file_size{0u}
+    , m_spilled_bytes{0u}
+    , m_free{}
+    , m_free_by_offset{}
+{
+}
+
+SpillStore::~SpillStore()
+{
+}
+
+SpillRegionPtr SpillStore::write(const SpillCodec& /* codec */, const void* /* value */)
+{
+    throw not_implemented("SpillStore::write(): not available on this platform.");
+}
+
+std::shared_ptr<void> SpillStore::read(const SpillCodec& /* codec */,
+    const SpillRegionPtr& /* region */) const
+{
+    throw not_implemented("SpillStore::read(): not available on this platform.");
+}
+
+std::uint64_t SpillStore::allocate(std::size_t /* capacity */)
+{
+    throw not_implemented("SpillStore::allocate(): not available on this platform.");
+}
+
+/**
+ * @note Unreachable, since no region can be allocated; does not throw, as
+ * it is called from ~SpillRegion().
+ */
+void SpillStore::free(std::uint64_t /* offset */, std::size_t /* capacity */)
+{
+}
+
+#endif
+
+void SpillStore::add_free(std::uint64_t offset, std::size_t capacity)
+{
+    m_free.emplace(capacity, offset);
+    m_free_by_offset.emplace(offset, capacity);
+}
+
+void SpillStore::remove_free(std::map<std::uint64_t, std::size_t>::iterator region)
+{
+    auto [begin, end] = m_free.equal_range(region->second);
+    for (auto iter = begin; iter != end; ++iter)
+    {
+        if (iter->second == region->first)
+        {
+            m_free.erase(iter);
+            break;
+        }
+    }
+    m_free_by_offset.erase(region);
+}
+
+std::size_t SpillStore::spilled_bytes() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_spilled_bytes;
+}
+
+std::uint64_t SpillStore::file_size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_file_size;
+}
+
+} // namespace tg::core
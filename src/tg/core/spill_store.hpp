@@ -0,0 +1,130 @@
+#pragma once
+#include <map>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A region of a SpillStore holding one spilled value.
+ * @details The region is returned to the store when the last reference is
+ * dropped: the dataset slot that spilled the value, and every value
+ * restored from it, hold one.
+ */
+class SpillRegion
+{
+public:
+    SpillRegion(std::shared_ptr<SpillStore> store, std::uint64_t offset, std::size_t size,
+        std::size_t capacity);
+    ~SpillRegion();
+
+    SpillStore& store() const;
+
+    std::uint64_t offset() const;
+
+    /**
+     * @brief Size of the spilled value.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Size of the region, a whole number of pages.
+     */
+    std::size_t capacity() const;
+
+private:
+    SpillRegion(const SpillRegion&) = delete;
+    SpillRegion& operator=(const SpillRegion&) = delete;
+    SpillRegion(SpillRegion&&) = delete;
+    SpillRegion& operator=(SpillRegion&&) = delete;
+
+private:
+    std::shared_ptr<SpillStore> m_store;
+    std::uint64_t m_offset;
+    std::size_t m_size;
+    std::size_t m_capacity;
+};
+
+/**
+ * @brief A scratch file that holds values spilled out of a GlobalDataSet
+ * under memory pressure.
+ *
+ * @details
+ * The file is created in the given directory and unlinked right away, so
+ * it disappears with the process. Regions are page-aligned; a value is
+ * written through a shared mapping of its region, and read back through a
+ * private mapping, so that spilling and restoring a trivially copyable
+ * value does not copy it through an intermediate buffer. Restored pages are
+ * clean file-backed pages, which the kernel can drop again under pressure.
+ *
+ * Freed regions are merged with their free neighbours and reused best-fit;
+ * the file grows as needed, and shrinks when its end is freed, so that it
+ * does not fragment across batches of values of varying sizes.
+ *
+ * This class is thread-safe. Only available on Linux and macOS.
+ */
+class SpillStore : public std::enable_shared_from_this<SpillStore>
+{
+public:
+    /**
+     * @throws std::runtime_error if the scratch file cannot be created.
+     * @throws not_implemented on other platforms.
+     */
+    static SpillStorePtr create(const std::string& directory);
+
+    ~SpillStore();
+
+    /**
+     * @brief Writes a value into a new region.
+     */
+    SpillRegionPtr write(const SpillCodec& codec, const void* value);
+
+    /**
+     * @brief Maps a region for reading, and restores the value.
+     * @details The returned value keeps the region alive.
+     */
+    std::shared_ptr<void> read(const SpillCodec& codec, const SpillRegionPtr& region) const;
+
+    /**
+     * @brief Total bytes of the regions in use.
+     */
+    std::size_t spilled_bytes() const;
+
+    std::uint64_t file_size() const;
+
+private:
+    explicit SpillStore(int fd);
+
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+    SpillStore(SpillStore&&) = delete;
+    SpillStore& operator=(SpillStore&&) = delete;
+
+private:
+    friend class SpillRegion;
+
+    std::uint64_t allocate(std::size_t capacity);
+    void free(std::uint64_t offset, std::size_t capacity);
+
+    /**
+     * @brief Adds a region to both free lists; the caller holds m_mutex.
+     */
+    void add_free(std::uint64_t offset, std::size_t capacity);
+
+    /**
+     * @brief Removes a free region from both free lists; the caller holds
+     * m_mutex.
+     */
+    void remove_free(std::map<std::uint64_t, std::size_t>::iterator region);
+
+private:
+    int m_fd;
+    std::size_t m_page_size;
+    mutable std::mutex m_mutex;
+    std::uint64_t m_file_size;  ///< Guarded by m_mutex.
+    std::size_t m_spilled_bytes;  ///< Guarded by m_mutex.
+    std::multimap<std::size_t, std::uint64_t> m_free;  ///< Free regions by capacity; guarded by m_mutex.
+    std::map<std::uint64_t, std::size_t> m_free_by_offset;  ///< The same regions by offset; guarded by m_mutex.
+};
+
+} // namespace tg::core
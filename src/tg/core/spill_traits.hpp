@@ -0,0 +1,99 @@
+#pragma once
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace tg::core
+{
+
+/**
+ * @brief Describes how a value of type T is written to and read back from a
+ * SpillStore.
+ *
+ * @details
+ * Spilling is enabled by default for trivially copyable types: the value is
+ * copied byte for byte into the spill file, and restored without a copy, as
+ * a pointer into the mapped file.
+ *
+ * Types that own a heap buffer, such as images, can specialize this
+ * template to spill their buffer. restore() receives the mapped bytes; the
+ * returned value must keep @p bytes alive for as long as it refers to them.
+ */
+template <typename T>
+struct SpillTraits
+{
+    static constexpr bool enabled = std::is_trivially_copyable_v<T>;
+
+    static std::size_t spill_size(const T& /* value */)
+    {
+        return sizeof(T);
+    }
+
+    static void spill(const T& value, void* dst)
+    {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+
+    static std::shared_ptr<T> restore(std::shared_ptr<void> bytes, std::size_t /* size */)
+    {
+        T* value = static_cast<T*>(bytes.get());
+        return std::shared_ptr<T>(std::move(bytes), value);
+    }
+};
+
+/**
+ * @brief Type-erased SpillTraits<T>, stored alongside a type-erased value.
+ */
+struct SpillCodec
+{
+    std::size_t (*spill_size)(const void* value);
+    void (*spill)(const void* value, void* dst);
+    std::shared_ptr<void> (*restore)(std::shared_ptr<void> bytes, std::size_t size);
+
+    /**
+     * @brief Returns the codec of T, or null if T cannot be spilled.
+     */
+    template <typename T>
+    static const SpillCodec* of();
+};
+
+namespace spill_detail
+{
+
+template <typename T>
+struct CodecOf
+{
+    static std::size_t spill_size(const void* value)
+    {
+        return SpillTraits<T>::spill_size(*static_cast<const T*>(value));
+    }
+
+    static void spill(const void* value, void* dst)
+    {
+        SpillTraits<T>::spill(*static_cast<const T*>(value), dst);
+    }
+
+    static std::shared_ptr<void> restore(std::shared_ptr<void> bytes, std::size_t size)
+    {
+        return std::static_pointer_cast<void>(SpillTraits<T>::restore(std::move(bytes), size));
+    }
+
+    static inline const SpillCodec codec{&CodecOf::spill_size, &CodecOf::spill, &CodecOf::restore};
+};
+
+} // namespace spill_detail
+
+template <typename T>
+const SpillCodec* SpillCodec::of()
+{
+    if constexpr (SpillTraits<T>::enabled)
+    {
+        return &spill_detail::CodecOf<T>::codec;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+} // namespace tg::core
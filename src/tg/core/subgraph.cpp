@@ -1,11 +1,22 @@
 #include "tg/core/subgraph.hpp"
 #include "tg/core/task.hpp"
+#include "tg/core/task_data.hpp"
 #include "tg/core/task_dataset.hpp"
 
 namespace tg::core
 {
 
 Subgraph::Subgraph()
+    : Subgraph{std::string{}}
+{
+}
+
+Subgraph::Subgraph(const std::string& name)
+    : m_name{name}
+    , m_tasks{}
+    , m_task_set{}
+    , m_interface{}
+    , m_produced{}
 {
 }
 
@@ -15,22 +26,80 @@ Subgraph::~Subgraph()
 
 void Subgraph::add_task(TaskPtr task)
 {
+    if (!task)
+    {
+        throw std::invalid_argument("Subgraph::add_task(): task cannot be null.");
+    }
+    if (m_task_set.count(task.get()))
+    {
+        throw std::invalid_argument("Subgraph::add_task(): same Task instance cannot be added twice.");
+    }
     auto dataset = task->get_dataset();
     std::vector<TaskDataPtr> all_data;
     dataset->get_all(all_data);
     for (const auto& data : all_data)
     {
-        //! @todo
+        if (data->name().empty())
+        {
+            throw std::invalid_argument("Subgraph::add_task(): data name cannot be empty.");
+        }
+        if (!(data->flags() & TaskDataFlags::Output))
+        {
+            continue;
+        }
+        if (m_produced.count(data->name_id()))
+        {
+            throw std::invalid_argument("Subgraph::add_task(): data " + data->name() +
+                " already has a producer.");
+        }
     }
+    for (const auto& data : all_data)
+    {
+        if (!!(data->flags() & TaskDataFlags::Output))
+        {
+            m_produced.insert(data->name_id());
+        }
+    }
+    m_task_set.insert(task.get());
     m_tasks.emplace_back(std::move(task));
 }
 
 void Subgraph::add_input(const std::string& name)
 {
+    m_interface.insert(NameTable::intern(name));
 }
 
 void Subgraph::add_output(const std::string& name)
 {
+    m_interface.insert(NameTable::intern(name));
+}
+
+const std::string& Subgraph::name() const
+{
+    return m_name;
+}
+
+std::string Subgraph::qualify(const std::string& local_name) const
+{
+    if (m_name.empty() || m_interface.count(NameTable::intern(local_name)))
+    {
+        return local_name;
+    }
+    return m_name + "/" + local_name;
+}
+
+NameId Subgraph::qualify(NameId local_name) const
+{
+    if (m_name.empty() || m_interface.count(local_name))
+    {
+        return local_name;
+    }
+    return NameTable::intern(m_name + "/" + NameTable::name(local_name));
+}
+
+const std::vector<TaskPtr>& Subgraph::tasks() const
+{
+    return m_tasks;
 }
 
 } // namespace tg::core
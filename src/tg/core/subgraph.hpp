@@ -1,13 +1,32 @@
 #pragma once
+#include <unordered_set>
 #include "tg/core/fwd.hpp"
+#include "tg/core/name_table.hpp"
 
 namespace tg::core
 {
 
+/**
+ * @brief A group of tasks that pass data to each other by name.
+ *
+ * @details
+ * A subgraph is also a namespace. A data name used by a task is local to
+ * the subgraph, and is qualified as "<subgraph name>/<local name>" when the
+ * subgraph is added to a TaskGraph. Names declared with add_input() or
+ * add_output() form the interface of the subgraph; they are not qualified,
+ * so that subgraphs can be connected through them.
+ *
+ * A subgraph without a name does not qualify any names.
+ *
+ * A subgraph is not thread-safe, but distinct subgraphs share nothing, so
+ * that a large graph can be built by several threads, one subgraph each,
+ * and then compiled in parallel; see TaskGraph::compile(WorkerPool&).
+ */
 class Subgraph
 {
 public:
     Subgraph();
+    explicit Subgraph(const std::string& name);
     ~Subgraph();
 
 public:
@@ -15,8 +34,31 @@ public:
     void add_input(const std::string& name);
     void add_output(const std::string& name);
 
+    const std::string& name() const;
+
+    /**
+     * @brief Returns the fully-qualified counterpart of a local data name.
+     */
+    std::string qualify(const std::string& local_name) const;
+
+    /**
+     * @brief Returns the interned, fully-qualified counterpart of an
+     * interned local name.
+     */
+    NameId qualify(NameId local_name) const;
+
+    const std::vector<TaskPtr>& tasks() const;
+
 private:
+    std::string m_name;
     std::vector<TaskPtr> m_tasks;
+    std::unordered_set<const Task*> m_task_set;  ///< To reject duplicates in constant time.
+    std::unordered_set<NameId> m_interface;
+
+    /**
+     * @brief Local data names that already have a producing task.
+     */
+    std::unordered_set<NameId> m_produced;
 };
 
 } // namespace tg::core
@@ -5,7 +5,13 @@ namespace tg::core
 {
 
 Task::Task()
+    : Task{TaskKind::Sync}
+{
+}
+
+Task::Task(TaskKind kind)
     : m_dataset{std::make_shared<TaskDataSet>()}
+    , m_kind{kind}
 {
 }
 
@@ -18,4 +24,20 @@ TaskDataSetPtr Task::get_dataset() const
     return m_dataset;
 }
 
+TaskKind Task::kind() const
+{
+    return m_kind;
+}
+
+bool Task::try_get_parameter_hash(std::uint64_t& hash) const
+{
+    (void)hash;
+    return false;
+}
+
+TypeId Task::task_type() const
+{
+    return TypeId{};
+}
+
 } // namespace tg::core
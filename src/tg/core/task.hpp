@@ -4,6 +4,20 @@
 namespace tg::core
 {
 
+enum class TaskKind
+{
+    /**
+     * @brief on_execute() runs to completion on a worker thread.
+     */
+    Sync = 0,
+
+    /**
+     * @brief The task derives from AsyncTask, and completes through an
+     * AsyncCompletion without holding a worker thread.
+     */
+    Async = 1
+};
+
 /**
  * @brief Base class for tasks in the TaskGraph framework.
  *
@@ -24,6 +38,11 @@ public:
      */
     TaskDataSetPtr get_dataset() const;
 
+    /**
+     * @brief Returns how the Executor must run this task.
+     */
+    TaskKind kind() const;
+
     /**
      * @brief Executes the code.
      * 
@@ -36,8 +55,35 @@ public:
      */
     virtual void on_execute() = 0;
 
+    /**
+     * @brief Opts in to common-subexpression elimination.
+     *
+     * @details
+     * A task that returns true promises that any other task with the same
+     * parameter hash, the same data layout and the same resolved inputs,
+     * produces the same outputs. TaskGraph::compile() then keeps one of
+     * them, whose outputs fan out to the consumers of both.
+     *
+     * The hash should be computed with the tg::data::hashing functions,
+     * over every parameter that affects the outputs. Tasks with side effects
+     * must not opt in. The default implementation returns false.
+     *
+     * A task that opts in must also override task_type(); tasks of
+     * different classes are never merged, whatever their hashes.
+     */
+    virtual bool try_get_parameter_hash(std::uint64_t& hash) const;
+
+    /**
+     * @brief Identifies the class of this task, without RTTI.
+     * @details Overrides return TypeId::of<the final class>(). Used by
+     * common-subexpression elimination, which skips tasks whose type is
+     * none, as returned by the default implementation.
+     */
+    virtual TypeId task_type() const;
+
 protected:
     Task();
+    explicit Task(TaskKind kind);
 
 private:
     Task(const Task&) = delete;
@@ -47,6 +93,7 @@ private:
 
 private:
     const TaskDataSetPtr m_dataset;
+    const TaskKind m_kind;
 };
 
 } // namespace tg::core
@@ -0,0 +1,64 @@
+#include "tg/core/task_context.hpp"
+#include "tg/core/cancellation_token.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+thread_local TaskContext* tl_current_context = nullptr;
+
+} // namespace
+
+TaskContext::TaskContext(Executor& executor, const CancellationToken* token,
+    const std::atomic<bool>& run_aborted, std::atomic<bool>& branch_cancelled)
+    : m_previous{tl_current_context}
+    , m_executor{executor}
+    , m_token{token}
+    , m_run_aborted{run_aborted}
+    , m_branch_cancelled{branch_cancelled}
+    , m_scratch{ScratchArena::for_this_thread()}
+    , m_scratch_mark{m_scratch.mark()}
+{
+    tl_current_context = this;
+}
+
+TaskContext::~TaskContext()
+{
+    m_scratch.rewind(m_scratch_mark);
+    tl_current_context = m_previous;
+}
+
+TaskContext* TaskContext::current()
+{
+    return tl_current_context;
+}
+
+Executor& TaskContext::executor() const
+{
+    return m_executor;
+}
+
+bool TaskContext::is_cancelled() const
+{
+    return m_run_aborted.load(std::memory_order_relaxed) ||
+        (m_token && m_token->is_cancelled());
+}
+
+void TaskContext::cancel_branch()
+{
+    m_branch_cancelled.store(true, std::memory_order_release);
+}
+
+bool TaskContext::is_branch_cancelled() const
+{
+    return m_branch_cancelled.load(std::memory_order_acquire);
+}
+
+ScratchArena& TaskContext::scratch() const
+{
+    return m_scratch;
+}
+
+} // namespace tg::core
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include "tg/core/fwd.hpp"
+#include "tg/core/scratch_arena.hpp"
+
+namespace tg::core
+{
+
+class CancellationToken;
+
+/**
+ * @brief Execution-time services available to the task currently running
+ * on this thread.
+ *
+ * @details
+ * The Executor creates a TaskContext around each call to on_execute() or
+ * on_execute_async(), and makes it current on the calling thread. Outside
+ * of these calls, TaskContext::current() returns null.
+ */
+class TaskContext
+{
+public:
+    /**
+     * @note Created by the Executor. The constructor makes the context
+     * current on the calling thread; the destructor restores the previous
+     * one, so that nested graph runs are handled. Likewise, the destructor
+     * rewinds the scratch arena to where the constructor found it.
+     */
+    TaskContext(Executor& executor, const CancellationToken* token,
+        const std::atomic<bool>& run_aborted, std::atomic<bool>& branch_cancelled);
+    ~TaskContext();
+
+    static TaskContext* current();
+
+    Executor& executor() const;
+
+    /**
+     * @brief Whether the task should abort: the run's token was cancelled
+     * or its deadline was missed, or another task of the run has failed.
+     * @details Cheap enough to poll inside a loop.
+     */
+    bool is_cancelled() const;
+
+    /**
+     * @brief Signals that the outputs of this task are no longer needed by
+     * anyone downstream.
+     * @details All tasks that depend on this task, directly or transitively,
+     * are skipped, and their pending inputs are released. Outputs that this
+     * task has produced are still published. An AsyncTask must call this
+     * before completing its AsyncCompletion.
+     */
+    void cancel_branch();
+
+    bool is_branch_cancelled() const;
+
+    /**
+     * @brief The scratch arena of the worker running the task, for
+     * temporary buffers.
+     * @details Everything allocated from it is released when the task
+     * returns from on_execute() or on_execute_async(); an AsyncTask must
+     * not use it after that. The arena keeps its capacity, so a task that
+     * allocates the same buffers on every run stops reaching the heap
+     * after its first runs.
+     */
+    ScratchArena& scratch() const;
+
+private:
+    TaskContext(const TaskContext&) = delete;
+    TaskContext& operator=(const TaskContext&) = delete;
+    TaskContext(TaskContext&&) = delete;
+    TaskContext& operator=(TaskContext&&) = delete;
+
+private:
+    TaskContext* m_previous;
+    Executor& m_executor;
+    const CancellationToken* m_token;
+    const std::atomic<bool>& m_run_aborted;
+    std::atomic<bool>& m_branch_cancelled;
+    ScratchArena& m_scratch;
+    const ScratchArena::Marker m_scratch_mark;
+};
+
+} // namespace tg::core
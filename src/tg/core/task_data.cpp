@@ -3,12 +3,12 @@
 namespace tg::core
 {
 
-TaskData::TaskData(const std::string& name, TaskDataFlags flags)
-    : m_mutex{}
-    , m_name{name}
+TaskData::TaskData(const std::string& name, TaskDataFlags flags, TypeId expected)
+    : m_mutex{"TaskData:", name}
+    , m_name{NameTable::intern(name)}
     , m_flags{flags}
-    , m_expected{std::nullopt}
-    , m_actual{std::type_index(typeid(void))}
+    , m_expected{expected}
+    , m_actual{}
     , m_value{}
 {
 }
@@ -17,7 +17,37 @@ TaskData::~TaskData()
 {
 }
 
-bool TaskData::try_assign(std::shared_ptr<void> value, std::type_index actual_type)
+const std::string& TaskData::name() const
+{
+    return NameTable::name(m_name);
+}
+
+NameId TaskData::name_id() const
+{
+    return m_name;
+}
+
+TaskDataFlags TaskData::flags() const
+{
+    return m_flags;
+}
+
+TypeId TaskData::expected_type() const
+{
+    return m_expected;
+}
+
+std::size_t TaskData::byte_size_hint() const
+{
+    return 0u;
+}
+
+const SpillCodec* TaskData::spill_codec() const
+{
+    return nullptr;
+}
+
+bool TaskData::try_assign(std::shared_ptr<void> value, TypeId actual_type)
 {
     LockType lock(m_mutex);
     if (m_value)
@@ -28,26 +58,21 @@ bool TaskData::try_assign(std::shared_ptr<void> value, std::type_index actual_ty
     {
         throw std::invalid_argument("TaskData::assign(): value cannot be null.");
     }
-    if (actual_type == std::type_index(typeid(void)))
+    if (actual_type.is_none())
     {
-        throw std::invalid_argument("TaskData::assign(): actual_type cannot be void.");
+        throw std::invalid_argument("TaskData::assign(): actual_type cannot be none.");
     }
-    if (m_expected)
+    if (!m_expected.is_none() && m_expected != actual_type)
     {
-        const auto& expected = m_expected.value();
-        if (expected != actual_type)
-        {
-            std::string s_expected{expected.name()};
-            std::string s_actual{actual_type.name()};
-            throw std::invalid_argument("TaskData::assign(): type mismatch. Expected: " + s_expected + ", got: " + s_actual);
-        }
+        throw std::invalid_argument("TaskData::assign(): type mismatch on " + this->name() +
+            ". Expected: " + to_string(m_expected) + ", got: " + to_string(actual_type));
     }
     m_value = std::move(value);
     m_actual = actual_type;
     return true;
 }
 
-bool TaskData::try_get(std::shared_ptr<void>& out_value, std::type_index& out_type) const
+bool TaskData::try_get(std::shared_ptr<void>& out_value, TypeId& out_type) const
 {
     LockType lock(m_mutex);
     if (!m_value)
@@ -63,7 +88,7 @@ void TaskData::release()
 {
     LockType lock(m_mutex);
     m_value.reset();
-    m_actual = std::type_index(typeid(void));
+    m_actual = TypeId{};
 }
 
 } // namespace tg::core
@@ -1,5 +1,7 @@
 #pragma once
 #include "tg/core/fwd.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/core/name_table.hpp"
 
 namespace tg::core
 {
@@ -31,28 +33,70 @@ namespace tg::core
 class TaskData
 {
 public:
-    using MutexType = std::mutex;
+    using MutexType = SiteMutex;
     using LockType = std::unique_lock<MutexType>;
 
 public:
-    TaskData(const std::string& name, TaskDataFlags flags);
+    /**
+     * @param expected The type that values must have, or none to accept
+     * any type.
+     */
+    TaskData(const std::string& name, TaskDataFlags flags, TypeId expected = TypeId{});
 
     virtual ~TaskData();
 
+    /**
+     * @brief Name of the data item, as used for graph connection.
+     */
+    const std::string& name() const;
+
+    /**
+     * @brief The interned id of name().
+     */
+    NameId name_id() const;
+
+    /**
+     * @brief Flags associated with the data item.
+     */
+    TaskDataFlags flags() const;
+
+    /**
+     * @brief The type that values must have, or none if any type is accepted.
+     * @details TaskInput<T> and TaskOutput<T> expect T.
+     */
+    TypeId expected_type() const;
+
+    /**
+     * @brief Estimated size in bytes of the current value, used by the
+     * Executor as a data locality hint.
+     * @details Returns zero when the size is unknown. TaskOutput<T>
+     * overrides this using DataSizeTraits<T>.
+     */
+    virtual std::size_t byte_size_hint() const;
+
+    /**
+     * @brief How the global dataset may spill values of this item to disk,
+     * or null if it may not.
+     * @details TaskOutput<T> overrides this using SpillTraits<T>.
+     */
+    virtual const SpillCodec* spill_codec() const;
+
     /**
      * @brief Prevents further modifications to the metadata of this TaskData.
      */
     void freeze_metadata();
 
     /**
-     * @brief 
+     * @brief Assigns the value, if none is assigned.
+     * @throws std::invalid_argument if the value is null, or if its type does
+     * not match the expected type.
      */
-    bool try_assign(std::shared_ptr<void> value, std::type_index actual_type);
+    bool try_assign(std::shared_ptr<void> value, TypeId actual_type);
 
     /**
      * @brief Reads out the value of this TaskData.
      */
-    bool try_get(std::shared_ptr<void>& out_value, std::type_index& out_type) const;
+    bool try_get(std::shared_ptr<void>& out_value, TypeId& out_type) const;
 
     /**
      * @brief Release data ownership.
@@ -69,11 +113,11 @@ private:
 
 private:
     mutable MutexType m_mutex;
-    std::string m_name;  ///< Name of the data item.
+    NameId m_name;  ///< Name of the data item, interned in the NameTable.
     TaskDataFlags m_flags;  ///< Flags associated with the data item.
-    std::optional<std::type_index> m_expected;  ///< Expected type of the data item.
+    TypeId m_expected;  ///< Expected type of the data item, or none.
     // ValidatorPtr m_validator;  ///< Optional validator for the data item.
-    std::type_index m_actual; ///< Actual type of the data item, set after the first call to set().
+    TypeId m_actual; ///< Actual type of the data item, set after the first call to set().
     std::shared_ptr<void> m_value;  ///< Actual value of the data item.
 };
 
@@ -4,7 +4,7 @@
 namespace tg::core
 {
 
-enum class TaskDataFlags : uint32_t
+enum class TaskDataFlags : uint8_t
 {
     None = 0u,
 
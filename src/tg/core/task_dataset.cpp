@@ -5,7 +5,7 @@ namespace tg::core
 {
 
 TaskDataSet::TaskDataSet()
-    : m_mutex{}
+    : m_mutex{"TaskDataSet"}
     , m_add_frozen{false}
     , m_check_duplicate{true}
     , m_data{}
@@ -1,5 +1,7 @@
 #pragma once
 #include "tg/core/fwd.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/data/containers/flat_hash_map.hpp"
 
 namespace tg::core
 {
@@ -26,7 +28,7 @@ namespace tg::core
 class TaskDataSet
 {
 public:
-    using MutexType = std::mutex;
+    using MutexType = SiteMutex;
     using LockType = std::unique_lock<MutexType>;
 
 public:
@@ -55,8 +57,9 @@ public:
      * @brief Access all TaskData items.
      * @param out_items A caller-provided empty vector that will be populated
      *                  with all TaskData items.
-     * @details This method is used by the executor to populate all inputs and 
-     * retrieve all outputs before and after task execution.
+     * @details This method is used by TaskGraph::compile() to bind each
+     * item to a slot of the plan. The Executor then accesses the items
+     * through PlanBinding::data, without calling this method.
      */
     void get_all(std::vector<TaskDataPtr>& out_items) const;
 
@@ -93,7 +96,7 @@ private:
      * @brief A mapping of names to the list index. Multiple names
      * can refer to the same index.
      */
-    std::unordered_map<std::string, int> m_names;
+    tg::data::containers::FlatHashMap<std::string, int> m_names;
 };
 
 } // namespace tg::core
@@ -1,6 +1,845 @@
+#include <algorithm>
+#include <limits>
 #include "tg/core/task_graph.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/parallel_for.hpp"
+#include "tg/core/plan_file.hpp"
+#include "tg/core/subgraph.hpp"
+#include "tg/core/task.hpp"
+#include "tg/core/task_data.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/worker_pool.hpp"
+#include "tg/data/hashing/fnv1a_detail.hpp"
 
 namespace tg::core
 {
 
+TaskGraph::TaskGraph()
+    : m_subgraphs{}
+    , m_tasks{}
+    , m_data{}
+    , m_events{}
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+}
+
+void TaskGraph::add_subgraph(SubgraphPtr subgraph)
+{
+    if (!subgraph)
+    {
+        throw std::invalid_argument("TaskGraph::add_subgraph(): subgraph cannot be null.");
+    }
+    for (const auto& existing : m_subgraphs)
+    {
+        if (existing.get() == subgraph.get())
+        {
+            throw std::invalid_argument("TaskGraph::add_subgraph(): same Subgraph instance cannot be added twice.");
+        }
+    }
+    for (const auto& task : subgraph->tasks())
+    {
+        m_tasks.push_back(task);
+    }
+    m_subgraphs.emplace_back(std::move(subgraph));
+}
+
+namespace
+{
+
+/**
+ * @brief Sets the successors, predecessor counts, retained flags and
+ * topological order of a plan from the producers and consumers of its slots.
+ * @throws std::logic_error if the tasks form a cycle.
+ */
+void link_tasks(ExecutionPlan& plan)
+{
+    const int task_count = static_cast<int>(plan.tasks.size());
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        auto& plan_task = plan.tasks[task_id];
+        std::vector<int> producers;
+        for (int slot : plan_task.input_slots)
+        {
+            int producer = plan.slots[slot].producer;
+            if (producer >= 0 &&
+                std::find(producers.begin(), producers.end(), producer) == producers.end())
+            {
+                producers.push_back(producer);
+            }
+        }
+        plan_task.predecessor_count = static_cast<int>(producers.size());
+        for (int producer : producers)
+        {
+            plan.tasks[producer].successors.push_back(task_id);
+        }
+    }
+    for (auto& plan_slot : plan.slots)
+    {
+        plan_slot.retained = (plan_slot.producer < 0 || plan_slot.consumer_count == 0);
+    }
+
+    /**
+     * @note Kahn's algorithm. Tasks left unvisited are part of a cycle.
+     */
+    std::vector<int> pending(task_count);
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        pending[task_id] = plan.tasks[task_id].predecessor_count;
+        if (pending[task_id] == 0)
+        {
+            plan.topological_order.push_back(task_id);
+        }
+    }
+    for (std::size_t k = 0u; k < plan.topological_order.size(); ++k)
+    {
+        for (int successor : plan.tasks[plan.topological_order[k]].successors)
+        {
+            if (--pending[successor] == 0)
+            {
+                plan.topological_order.push_back(successor);
+            }
+        }
+    }
+    if (static_cast<int>(plan.topological_order.size()) != task_count)
+    {
+        throw std::logic_error("TaskGraph::compile(): the task graph contains a cycle.");
+    }
+}
+
+/**
+ * @brief Checks that the links of a plan loaded from a file agree with its
+ * slots, as link_tasks() and ExecutionPlan::fuse_linear_chains() would have set
+ * them.
+ * @details The executor trusts these counts: a predecessor count too high
+ * never lets a task run, and a consumer count too low releases a value
+ * before its last reader. The topological order must already be a
+ * permutation of the tasks.
+ * @throws std::runtime_error if they do not.
+ */
+void check_plan_links(const ExecutionPlan& plan)
+{
+    auto reject = [](const char* what)
+    {
+        throw std::runtime_error(std::string{"TaskGraph::compile(): plan file "} + what);
+    };
+    const int task_count = static_cast<int>(plan.tasks.size());
+    std::vector<int> rank(task_count);
+    for (int k = 0; k < task_count; ++k)
+    {
+        rank[plan.topological_order[k]] = k;
+    }
+    std::vector<int> producer(plan.slots.size(), -1);
+    std::vector<int> consumers(plan.slots.size(), 0);
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        for (int slot : plan.tasks[task_id].output_slots)
+        {
+            if (producer[slot] >= 0 && producer[slot] != task_id)
+            {
+                reject("slot has two producers.");
+            }
+            producer[slot] = task_id;
+        }
+        for (int slot : plan.tasks[task_id].input_slots)
+        {
+            consumers[slot] += 1;
+        }
+    }
+    for (std::size_t slot = 0u; slot < plan.slots.size(); ++slot)
+    {
+        const auto& plan_slot = plan.slots[slot];
+        if (plan_slot.producer != producer[slot] || plan_slot.consumer_count != consumers[slot])
+        {
+            reject("slot producer or consumer count mismatch.");
+        }
+    }
+    std::vector<int> successor_count(task_count, 0);
+    std::vector<int> producers;
+    std::vector<int> successors;
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        const auto& plan_task = plan.tasks[task_id];
+        producers.clear();
+        for (int slot : plan_task.input_slots)
+        {
+            int slot_producer = plan.slots[slot].producer;
+            if (slot_producer >= 0 &&
+                std::find(producers.begin(), producers.end(), slot_producer) == producers.end())
+            {
+                producers.push_back(slot_producer);
+            }
+            if (plan.slots[slot].fused && (slot_producer < 0 || plan.slots[slot].consumer_count != 1 ||
+                plan.tasks[slot_producer].fused_next != task_id))
+            {
+                reject("fused slot is not read by the fused successor.");
+            }
+        }
+        if (plan_task.predecessor_count != static_cast<int>(producers.size()))
+        {
+            reject("predecessor count mismatch.");
+        }
+        for (int slot_producer : producers)
+        {
+            successor_count[slot_producer] += 1;
+            const auto& listed = plan.tasks[slot_producer].successors;
+            if (std::find(listed.begin(), listed.end(), task_id) == listed.end())
+            {
+                reject("successor missing.");
+            }
+        }
+        successors = plan_task.successors;
+        std::sort(successors.begin(), successors.end());
+        if (std::adjacent_find(successors.begin(), successors.end()) != successors.end())
+        {
+            reject("successor listed twice.");
+        }
+        for (int successor : successors)
+        {
+            if (rank[successor] <= rank[task_id])
+            {
+                reject("order is not topological.");
+            }
+        }
+        if ((plan_task.fused_next >= 0 && (plan.tasks[plan_task.fused_next].fused_prev != task_id ||
+                plan.tasks[plan_task.fused_next].predecessor_count != 1 ||
+                plan_task.successors.size() != 1u || plan_task.successors[0] != plan_task.fused_next)) ||
+            (plan_task.fused_prev >= 0 && plan.tasks[plan_task.fused_prev].fused_next != task_id))
+        {
+            reject("fused links mismatch.");
+        }
+    }
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        if (static_cast<int>(plan.tasks[task_id].successors.size()) != successor_count[task_id])
+        {
+            reject("successor count mismatch.");
+        }
+    }
+}
+
+/**
+ * @brief Whether two tasks, with equal parameter hashes, compute the same
+ * outputs: same task class, same data layout and types, and the same
+ * inputs after elimination.
+ */
+bool same_computation(const ExecutionPlan& plan, int first, int second,
+    const std::vector<int>& canonical)
+{
+    const auto& a = plan.tasks[first];
+    const auto& b = plan.tasks[second];
+    TypeId type = a.task->task_type();
+    if (type.is_none() || type != b.task->task_type() || a.bindings.size() != b.bindings.size())
+    {
+        return false;
+    }
+    for (std::size_t k = 0u; k < a.bindings.size(); ++k)
+    {
+        if (a.bindings[k].local_index != b.bindings[k].local_index ||
+            a.bindings[k].flags != b.bindings[k].flags ||
+            plan.slots[a.bindings[k].slot].type != plan.slots[b.bindings[k].slot].type)
+        {
+            return false;
+        }
+        if (!(a.bindings[k].flags & TaskDataFlags::Output) &&
+            canonical[a.bindings[k].slot] != canonical[b.bindings[k].slot])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Common-subexpression elimination.
+ *
+ * @details
+ * Tasks are visited in topological order, so the inputs of a task are
+ * resolved to the slots of the surviving producers before the task itself
+ * is compared. A duplicate task is removed; its output slots are kept, and
+ * produced by the survivor through extra bindings to the same TaskData, so
+ * one value fans out to the consumers of both.
+ *
+ * @return Whether any task was removed. The plan must then be re-linked.
+ */
+bool eliminate_common_tasks(ExecutionPlan& plan)
+{
+    using namespace tg::data::hashing::fnv1a_detail;
+    const int task_count = static_cast<int>(plan.tasks.size());
+    std::vector<int> canonical(plan.slots.size());
+    for (std::size_t k = 0u; k < canonical.size(); ++k)
+    {
+        canonical[k] = static_cast<int>(k);
+    }
+    std::vector<char> had_consumers(plan.slots.size());
+    for (std::size_t k = 0u; k < plan.slots.size(); ++k)
+    {
+        had_consumers[k] = (plan.slots[k].consumer_count > 0) ? 1 : 0;
+    }
+    std::vector<std::uint64_t> parameter_hashes(task_count, 0u);
+    std::vector<char> removed(task_count, 0);
+    std::unordered_map<std::uint64_t, std::vector<int>> candidates;
+    bool any_removed = false;
+    for (int task_id : plan.topological_order)
+    {
+        auto& plan_task = plan.tasks[task_id];
+        std::uint64_t parameter_hash = 0u;
+        if (!plan_task.task->try_get_parameter_hash(parameter_hash))
+        {
+            continue;
+        }
+        parameter_hashes[task_id] = parameter_hash;
+        std::uint64_t key = fnv1a_memory_range(fnv1a_init(), &parameter_hash, sizeof(parameter_hash));
+        for (int slot : plan_task.input_slots)
+        {
+            key = fnv1a_memory_range(key, &canonical[slot], sizeof(int));
+        }
+        auto& bucket = candidates[key];
+        int survivor = -1;
+        for (int other : bucket)
+        {
+            if (parameter_hashes[other] == parameter_hash &&
+                same_computation(plan, other, task_id, canonical))
+            {
+                survivor = other;
+                break;
+            }
+        }
+        if (survivor < 0)
+        {
+            bucket.push_back(task_id);
+            continue;
+        }
+        auto& target = plan.tasks[survivor];
+        for (std::size_t k = 0u; k < plan_task.bindings.size(); ++k)
+        {
+            const auto& binding = plan_task.bindings[k];
+            if (!!(binding.flags & TaskDataFlags::Output))
+            {
+                int target_slot = target.bindings[k].slot;
+                canonical[binding.slot] = canonical[target_slot];
+                target.bindings.push_back(PlanBinding{target.bindings[k].local_index,
+                    binding.slot, binding.flags, target.bindings[k].data});
+                target.output_slots.push_back(binding.slot);
+                plan.slots[binding.slot].producer = survivor;
+            }
+        }
+        for (int slot : plan_task.input_slots)
+        {
+            plan.slots[slot].consumer_count -= 1;
+        }
+        removed[task_id] = 1;
+        any_removed = true;
+    }
+    if (!any_removed)
+    {
+        return false;
+    }
+
+    /**
+     * @note An intermediate whose consumers were all removed is no longer
+     * produced: it would otherwise be retained without being read.
+     */
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        if (removed[task_id])
+        {
+            continue;
+        }
+        auto& plan_task = plan.tasks[task_id];
+        auto orphaned = [&](int slot)
+        {
+            return had_consumers[slot] && plan.slots[slot].consumer_count == 0;
+        };
+        auto& bindings = plan_task.bindings;
+        auto orphaned_output = [&](const PlanBinding& binding)
+        {
+            return !!(binding.flags & TaskDataFlags::Output) && orphaned(binding.slot);
+        };
+        bindings.erase(std::remove_if(bindings.begin(), bindings.end(), orphaned_output),
+            bindings.end());
+        auto& outputs = plan_task.output_slots;
+        for (int slot : outputs)
+        {
+            if (orphaned(slot))
+            {
+                plan.slots[slot].producer = -1;
+            }
+        }
+        outputs.erase(std::remove_if(outputs.begin(), outputs.end(), orphaned), outputs.end());
+    }
+
+    std::vector<int> new_index(task_count, -1);
+    std::vector<PlanTask> kept;
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        if (!removed[task_id])
+        {
+            new_index[task_id] = static_cast<int>(kept.size());
+            kept.emplace_back(std::move(plan.tasks[task_id]));
+            kept.back().successors.clear();
+            kept.back().predecessor_count = 0;
+        }
+    }
+    plan.tasks = std::move(kept);
+    for (auto& plan_slot : plan.slots)
+    {
+        if (plan_slot.producer >= 0)
+        {
+            plan_slot.producer = new_index[plan_slot.producer];
+        }
+    }
+    plan.topological_order.clear();
+    return true;
+}
+
+/**
+ * @brief The steps of compile() that follow name resolution.
+ */
+void finish_plan(ExecutionPlan& plan)
+{
+    link_tasks(plan);
+    if (eliminate_common_tasks(plan))
+    {
+        link_tasks(plan);
+    }
+
+    /**
+     * @note Task fusion. A task whose only successor has no other
+     * predecessor is linked to it, so linear chains are dispatched once.
+     * An output consumed only once is then consumed by the fused successor,
+     * and bypasses the global dataset.
+     */
+    plan.fuse_linear_chains();
+}
+
+} // namespace
+
+ExecutionPlanPtr TaskGraph::compile() const
+{
+    auto plan = std::make_shared<ExecutionPlan>();
+    std::unordered_map<NameId, int> slot_index;
+    auto get_slot = [&](NameId name)
+    {
+        auto [iter, inserted] = slot_index.try_emplace(name, static_cast<int>(plan->slots.size()));
+        if (inserted)
+        {
+            plan->slots.push_back(PlanSlot{NameTable::name(name), -1, 0, false, false, TypeId{}});
+        }
+        return iter->second;
+    };
+
+    for (const auto& subgraph : m_subgraphs)
+    {
+        for (const auto& task : subgraph->tasks())
+        {
+            int task_id = static_cast<int>(plan->tasks.size());
+            PlanTask plan_task{task, {}, {}, {}, {}, 0, -1, -1, task_id};
+            std::vector<TaskDataPtr> all_data;
+            task->get_dataset()->get_all(all_data);
+            for (std::size_t k = 0u; k < all_data.size(); ++k)
+            {
+                const auto& data = all_data[k];
+                int slot = get_slot(subgraph->qualify(data->name_id()));
+                plan_task.bindings.push_back(PlanBinding{static_cast<int>(k), slot, data->flags(),
+                    data.get()});
+                TypeId type = data->expected_type();
+                if (!type.is_none())
+                {
+                    auto& plan_slot = plan->slots[slot];
+                    if (plan_slot.type.is_none())
+                    {
+                        plan_slot.type = type;
+                    }
+                    else if (plan_slot.type != type)
+                    {
+                        throw std::invalid_argument("TaskGraph::compile(): data " + plan_slot.name +
+                            " is bound with different types.");
+                    }
+                }
+                if (!!(data->flags() & TaskDataFlags::Output))
+                {
+                    auto& plan_slot = plan->slots[slot];
+                    if (plan_slot.producer >= 0)
+                    {
+                        throw std::invalid_argument("TaskGraph::compile(): data " + plan_slot.name +
+                            " already has a producer.");
+                    }
+                    plan_slot.producer = task_id;
+                    plan_task.output_slots.push_back(slot);
+                }
+                else if (!!(data->flags() & TaskDataFlags::Input))
+                {
+                    plan->slots[slot].consumer_count += 1;
+                    plan_task.input_slots.push_back(slot);
+                }
+            }
+            plan->tasks.emplace_back(std::move(plan_task));
+        }
+    }
+
+    finish_plan(*plan);
+    return plan;
+}
+
+/**
+ * @details
+ * The tasks are split into chunks, and the data names of each chunk are
+ * qualified in parallel; each name is routed to one of several shards by
+ * its NameId. Each shard then resolves its names in parallel: it
+ * finds the first binding of each name, checks the types and the single
+ * producer, and counts the consumers, visiting the bindings in the same
+ * order as compile(). Slots are numbered by the position of the first
+ * binding of each name, in one sequential pass over plain integers, so the
+ * plan is identical to the one compile() builds. The bindings of each task
+ * are then filled in parallel.
+ */
+ExecutionPlanPtr TaskGraph::compile(WorkerPool& pool) const
+{
+    struct Port
+    {
+        NameId name;  ///< Fully-qualified.
+        TaskData* data;
+        TaskDataFlags flags;
+        TypeId type;
+        int entry;  ///< Index of the name in its shard.
+        bool first;  ///< Whether this is the first binding of the name.
+        int slot;
+    };
+    struct PortRef
+    {
+        int task_id;
+        int local_index;
+    };
+    struct Entry
+    {
+        PortRef first;
+        int producer = -1;
+        int consumer_count = 0;
+        TypeId type;
+        int slot = -1;
+    };
+    struct Shard
+    {
+        std::vector<Entry> entries;
+        std::size_t error_position = std::numeric_limits<std::size_t>::max();
+        std::string error;
+    };
+
+    std::vector<const TaskPtr*> tasks;
+    std::vector<const Subgraph*> owners;
+    for (const auto& subgraph : m_subgraphs)
+    {
+        for (const auto& task : subgraph->tasks())
+        {
+            tasks.push_back(&task);
+            owners.push_back(subgraph.get());
+        }
+    }
+    const std::size_t task_count = tasks.size();
+    const std::size_t lanes = std::max<std::size_t>(pool.size(), 1u) * 4u;
+    const std::size_t chunk_size = std::max<std::size_t>((task_count + lanes - 1u) / lanes, 1u);
+    const std::size_t chunk_count = (task_count + chunk_size - 1u) / chunk_size;
+    const std::size_t shard_count = lanes;
+
+    std::vector<std::vector<Port>> ports(task_count);
+    std::vector<std::vector<PortRef>> routed(chunk_count * shard_count);
+    parallel_for_index(pool, chunk_count, [&](std::size_t chunk)
+    {
+        std::vector<TaskDataPtr> all_data;
+        std::size_t end = std::min(task_count, (chunk + 1u) * chunk_size);
+        for (std::size_t task_id = chunk * chunk_size; task_id < end; ++task_id)
+        {
+            all_data.clear();
+            (*tasks[task_id])->get_dataset()->get_all(all_data);
+            auto& task_ports = ports[task_id];
+            task_ports.reserve(all_data.size());
+            for (std::size_t k = 0u; k < all_data.size(); ++k)
+            {
+                const auto& data = all_data[k];
+                NameId name = owners[task_id]->qualify(data->name_id());
+                task_ports.push_back(Port{name, data.get(), data->flags(), data->expected_type(), -1,
+                    false, -1});
+                routed[chunk * shard_count + name % shard_count].push_back(
+                    PortRef{static_cast<int>(task_id), static_cast<int>(k)});
+            }
+        }
+    });
+
+    /**
+     * @note Errors are ranked by the order in which compile() would meet
+     * them, so the same error is reported.
+     */
+    std::vector<Shard> shards(shard_count);
+    parallel_for_index(pool, shard_count, [&](std::size_t shard_index)
+    {
+        Shard& shard = shards[shard_index];
+        std::unordered_map<NameId, int> index;
+        auto fail = [&](const PortRef& ref, const std::string& message)
+        {
+            std::size_t position = (static_cast<std::size_t>(ref.task_id) << 32u) + ref.local_index;
+            if (position < shard.error_position)
+            {
+                shard.error_position = position;
+                shard.error = message;
+            }
+        };
+        for (std::size_t chunk = 0u; chunk < chunk_count; ++chunk)
+        {
+            for (const PortRef& ref : routed[chunk * shard_count + shard_index])
+            {
+                Port& port = ports[ref.task_id][ref.local_index];
+                auto [iter, inserted] = index.try_emplace(port.name, static_cast<int>(shard.entries.size()));
+                if (inserted)
+                {
+                    shard.entries.push_back(Entry{ref, -1, 0, TypeId{}, -1});
+                    port.first = true;
+                }
+                port.entry = iter->second;
+                Entry& entry = shard.entries[port.entry];
+                if (!port.type.is_none())
+                {
+                    if (entry.type.is_none())
+                    {
+                        entry.type = port.type;
+                    }
+                    else if (entry.type != port.type)
+                    {
+                        fail(ref, "TaskGraph::compile(): data " + NameTable::name(port.name) +
+                            " is bound with different types.");
+                    }
+                }
+                if (!!(port.flags & TaskDataFlags::Output))
+                {
+                    if (entry.producer >= 0)
+                    {
+                        fail(ref, "TaskGraph::compile(): data " + NameTable::name(port.name) +
+                            " already has a producer.");
+                    }
+                    entry.producer = ref.task_id;
+                }
+                else if (!!(port.flags & TaskDataFlags::Input))
+                {
+                    entry.consumer_count += 1;
+                }
+            }
+        }
+    });
+    const Shard* first_error = nullptr;
+    for (const auto& shard : shards)
+    {
+        if (!shard.error.empty() && (!first_error || shard.error_position < first_error->error_position))
+        {
+            first_error = &shard;
+        }
+    }
+    if (first_error)
+    {
+        throw std::invalid_argument(first_error->error);
+    }
+
+    int slot_count = 0;
+    for (auto& task_ports : ports)
+    {
+        for (auto& port : task_ports)
+        {
+            Entry& entry = shards[port.name % shard_count].entries[port.entry];
+            if (port.first)
+            {
+                entry.slot = slot_count++;
+            }
+            port.slot = entry.slot;
+        }
+    }
+
+    auto plan = std::make_shared<ExecutionPlan>();
+    plan->slots.resize(static_cast<std::size_t>(slot_count));
+    plan->tasks.resize(task_count);
+    parallel_for_index(pool, shard_count, [&](std::size_t shard_index)
+    {
+        for (const auto& entry : shards[shard_index].entries)
+        {
+            const Port& port = ports[entry.first.task_id][entry.first.local_index];
+            plan->slots[entry.slot] = PlanSlot{NameTable::name(port.name), entry.producer, entry.consumer_count,
+                false, false, entry.type};
+        }
+    });
+    parallel_for_index(pool, chunk_count, [&](std::size_t chunk)
+    {
+        std::size_t end = std::min(task_count, (chunk + 1u) * chunk_size);
+        for (std::size_t task_id = chunk * chunk_size; task_id < end; ++task_id)
+        {
+            int id = static_cast<int>(task_id);
+            PlanTask plan_task{*tasks[task_id], {}, {}, {}, {}, 0, -1, -1, id};
+            const auto& task_ports = ports[task_id];
+            plan_task.bindings.reserve(task_ports.size());
+            for (std::size_t k = 0u; k < task_ports.size(); ++k)
+            {
+                const Port& port = task_ports[k];
+                plan_task.bindings.push_back(PlanBinding{static_cast<int>(k), port.slot, port.flags,
+                    port.data});
+                if (!!(port.flags & TaskDataFlags::Output))
+                {
+                    plan_task.output_slots.push_back(port.slot);
+                }
+                else if (!!(port.flags & TaskDataFlags::Input))
+                {
+                    plan_task.input_slots.push_back(port.slot);
+                }
+            }
+            plan->tasks[task_id] = std::move(plan_task);
+        }
+    });
+
+    finish_plan(*plan);
+    return plan;
+}
+
+std::uint64_t TaskGraph::structural_hash() const
+{
+    using namespace tg::data::hashing::fnv1a_detail;
+    std::uint64_t state = fnv1a_init();
+    for (const auto& subgraph : m_subgraphs)
+    {
+        for (const auto& task : subgraph->tasks())
+        {
+            auto kind = static_cast<std::uint32_t>(task->kind());
+            state = fnv1a_memory_range(state, &kind, sizeof(kind));
+            std::uint64_t task_type = task->task_type().value();
+            state = fnv1a_memory_range(state, &task_type, sizeof(task_type));
+            std::uint64_t parameter_hash = 0u;
+            if (task->try_get_parameter_hash(parameter_hash))
+            {
+                state = fnv1a_memory_range(state, &parameter_hash, sizeof(parameter_hash));
+            }
+            std::vector<TaskDataPtr> all_data;
+            task->get_dataset()->get_all(all_data);
+            for (const auto& data : all_data)
+            {
+                const std::string& name = NameTable::name(subgraph->qualify(data->name_id()));
+                auto flags = static_cast<std::uint32_t>(data->flags());
+                std::uint64_t type = data->expected_type().value();
+                state = fnv1a_char_range(state, name.data(), name.size());
+                state = fnv1a_uint8(state, 0u);
+                state = fnv1a_memory_range(state, &flags, sizeof(flags));
+                state = fnv1a_memory_range(state, &type, sizeof(type));
+            }
+            state = fnv1a_uint8(state, 0xFFu);
+        }
+    }
+    return state;
+}
+
+ExecutionPlanPtr TaskGraph::compile(const MappedPlanFile& cached) const
+{
+    if (cached.structural_hash() != this->structural_hash())
+    {
+        throw std::invalid_argument("TaskGraph::compile(): plan file does not match this graph.");
+    }
+    const auto& header = cached.header();
+    if (header.task_count > m_tasks.size())
+    {
+        throw std::invalid_argument("TaskGraph::compile(): plan file task count mismatch.");
+    }
+    const int task_count = static_cast<int>(header.task_count);
+    const int slot_count = static_cast<int>(header.slot_count);
+    auto check_range = [](std::int64_t value, std::int64_t begin, std::int64_t end)
+    {
+        if (value < begin || value >= end)
+        {
+            throw std::runtime_error("TaskGraph::compile(): plan file index out of range.");
+        }
+    };
+    auto check_span = [](std::uint64_t begin, std::uint64_t count, std::uint64_t size)
+    {
+        if (begin > size || count > size - begin)
+        {
+            throw std::runtime_error("TaskGraph::compile(): plan file span out of range.");
+        }
+    };
+
+    auto plan = std::make_shared<ExecutionPlan>();
+    plan->slots.reserve(slot_count);
+    for (int slot = 0; slot < slot_count; ++slot)
+    {
+        const auto& file_slot = cached.slots()[slot];
+        check_range(file_slot.producer, -1, task_count);
+        plan->slots.push_back(PlanSlot{std::string{cached.slot_name(slot)},
+            file_slot.producer, file_slot.consumer_count, file_slot.retained != 0u,
+            file_slot.fused != 0u, TypeId{file_slot.type_id}});
+    }
+    plan->tasks.reserve(task_count);
+    std::vector<bool> graph_index_seen(m_tasks.size(), false);
+    for (int task_id = 0; task_id < task_count; ++task_id)
+    {
+        const auto& file_task = cached.tasks()[task_id];
+        check_range(file_task.graph_index, 0, static_cast<std::int64_t>(m_tasks.size()));
+        if (graph_index_seen[file_task.graph_index])
+        {
+            throw std::runtime_error("TaskGraph::compile(): plan file maps two plan tasks to one graph task.");
+        }
+        graph_index_seen[file_task.graph_index] = true;
+        const auto& task = m_tasks[file_task.graph_index];
+        if (file_task.kind != static_cast<std::uint32_t>(task->kind()))
+        {
+            throw std::invalid_argument("TaskGraph::compile(): plan file task kind mismatch.");
+        }
+        check_span(file_task.binding_begin, file_task.binding_count, header.binding_count);
+        check_span(file_task.input_begin, file_task.input_count, header.slot_ref_count);
+        check_span(file_task.output_begin, file_task.output_count, header.slot_ref_count);
+        check_span(file_task.successor_begin, file_task.successor_count, header.successor_count);
+        check_range(file_task.fused_next, -1, task_count);
+        check_range(file_task.fused_prev, -1, task_count);
+        PlanTask plan_task{task, {}, {}, {}, {}, file_task.predecessor_count,
+            file_task.fused_next, file_task.fused_prev, static_cast<int>(file_task.graph_index)};
+        std::vector<TaskDataPtr> all_data;
+        task->get_dataset()->get_all(all_data);
+        for (std::uint32_t k = 0u; k < file_task.binding_count; ++k)
+        {
+            const auto& binding = cached.bindings()[file_task.binding_begin + k];
+            check_range(binding.slot, 0, slot_count);
+            check_range(binding.local_index, 0, static_cast<std::int64_t>(all_data.size()));
+            plan_task.bindings.push_back(PlanBinding{binding.local_index, binding.slot,
+                static_cast<TaskDataFlags>(binding.flags), all_data[binding.local_index].get()});
+        }
+        const std::int32_t* refs = cached.slot_refs();
+        plan_task.input_slots.assign(refs + file_task.input_begin,
+            refs + file_task.input_begin + file_task.input_count);
+        plan_task.output_slots.assign(refs + file_task.output_begin,
+            refs + file_task.output_begin + file_task.output_count);
+        const std::int32_t* successors = cached.successors();
+        plan_task.successors.assign(successors + file_task.successor_begin,
+            successors + file_task.successor_begin + file_task.successor_count);
+        for (int slot : plan_task.input_slots)
+        {
+            check_range(slot, 0, slot_count);
+        }
+        for (int slot : plan_task.output_slots)
+        {
+            check_range(slot, 0, slot_count);
+        }
+        for (int successor : plan_task.successors)
+        {
+            check_range(successor, 0, task_count);
+        }
+        plan->tasks.emplace_back(std::move(plan_task));
+    }
+    const std::int32_t* order = cached.topological_order();
+    std::vector<bool> ordered(task_count, false);
+    for (int k = 0; k < task_count; ++k)
+    {
+        check_range(order[k], 0, task_count);
+        if (ordered[order[k]])
+        {
+            throw std::runtime_error("TaskGraph::compile(): plan file order is not a permutation.");
+        }
+        ordered[order[k]] = true;
+    }
+    plan->topological_order.assign(order, order + task_count);
+    check_plan_links(*plan);
+    return plan;
+}
+
 } // namespace tg::core
@@ -13,6 +13,17 @@ using TaskDataPtr = std::shared_ptr<TaskData>;
 class Event;
 using EventPtr = std::shared_ptr<Event>;
 
+/**
+ * @brief Manages a group of subgraphs for collaborative execution.
+ *
+ * @details
+ * Subgraphs are connected by fully-qualified data names. compile() resolves
+ * these names, checks that each data item has at most one producer and that
+ * the graph is acyclic, and produces the ExecutionPlan used by the Executor.
+ *
+ * A TaskGraph is not thread-safe. To build a large graph in parallel, build
+ * one Subgraph per thread, add them all, and compile with a WorkerPool.
+ */
 class TaskGraph
 {
 public:
@@ -20,6 +31,50 @@ public:
     ~TaskGraph();
 
 public:
+    void add_subgraph(SubgraphPtr subgraph);
+
+    /**
+     * @brief Builds the execution-time form of this graph.
+     * @details Linear chains, where a task's only successor has no other
+     * predecessor, are fused into one scheduling unit; see PlanTask::fused_next.
+     * Before that, duplicate tasks are merged; see
+     * Task::try_get_parameter_hash().
+     * @throws std::invalid_argument if a data item has several producers,
+     * or is bound with different types.
+     * @throws std::logic_error if the graph contains a cycle.
+     */
+    ExecutionPlanPtr compile() const;
+
+    /**
+     * @brief Builds the same plan as compile(), resolving names, checking
+     * types and producers, and building the bindings on the workers of a
+     * pool.
+     * @details Meant for very large graphs, built as many subgraphs, for
+     * example one per thread. Linking, duplicate merging and fusion run on
+     * the calling thread, as in compile().
+     * @throws The same exceptions as compile().
+     */
+    ExecutionPlanPtr compile(WorkerPool& pool) const;
+
+    /**
+     * @brief Builds the execution-time form of this graph from a plan file
+     * written for a graph with the same structure.
+     * @details Name resolution and validation are skipped; the topology and
+     * scheduling metadata come from the file, and the tasks of this graph
+     * are attached to it in order.
+     * @throws std::invalid_argument if the structural hashes differ.
+     */
+    ExecutionPlanPtr compile(const MappedPlanFile& cached) const;
+
+    /**
+     * @brief Hash of everything compile() depends on: for each task, in
+     * order, its kind and the fully-qualified names and flags of its data,
+     * the type of each data item, and for tasks that opt in to
+     * common-subexpression elimination, their parameter hash.
+     * @details Computed with FNV-1a from tg::data::hashing.
+     */
+    std::uint64_t structural_hash() const;
+
 private:
     std::vector<SubgraphPtr> m_subgraphs;
     std::vector<TaskPtr> m_tasks;
@@ -1,6 +1,7 @@
 #pragma once
 #include "tg/core/fwd.hpp"
 #include "tg/core/task_data.hpp"
+#include "tg/core/spill_traits.hpp"
 
 namespace tg::core
 {
@@ -21,6 +22,8 @@ public:
     const T& operator*() const;
     const T* operator->() const;
 
+    const SpillCodec* spill_codec() const final;
+
 private:
     TaskInput(const TaskInput&) = delete;
     TaskInput(TaskInput&&) = delete;
@@ -6,7 +6,7 @@ namespace tg::core
 
 template <typename T>
 TaskInput<T>::TaskInput(const std::string& name)
-    : TaskData{name, TaskDataFlags::Input}
+    : TaskData{name, TaskDataFlags::Input, TypeId::of<T>()}
 {
 }
 
@@ -25,7 +25,7 @@ template <typename T>
 const T* TaskInput<T>::operator->() const
 {
     std::shared_ptr<void> out_value;
-    std::type_index out_type{typeid(void)};
+    TypeId out_type;
     if (!this->try_get(out_value, out_type))
     {
         throw std::runtime_error("TaskInput<T>::operator*() : failed to get value.");
@@ -33,12 +33,11 @@ const T* TaskInput<T>::operator->() const
     /**
      * @invariant out_value is not null, enforced by TaskData::try_get()
      */
-    if (out_type != std::type_index(typeid(T)))
+    if (out_type != TypeId::of<T>())
     {
-        std::string str_expected{typeid(T).name()};
-        std::string str_actual{out_type.name()};
+        std::string str_expected{type_name<T>()};
         throw std::runtime_error("TaskInput<T>::operator*() : type mismatch. Expected: " +
-            str_expected + ", got: " + str_actual);
+            str_expected + ", got: " + to_string(out_type));
     }
     /**
      * @note Equivalent to std::static_pointer_cast<T>(out_value)
@@ -47,4 +46,10 @@ const T* TaskInput<T>::operator->() const
     return static_cast<const T*>(out_value.get());
 }
 
+template <typename T>
+const SpillCodec* TaskInput<T>::spill_codec() const
+{
+    return SpillCodec::of<T>();
+}
+
 } // namespace tg::core
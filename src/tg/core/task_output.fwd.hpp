@@ -1,6 +1,8 @@
 #pragma once
 #include "tg/core/fwd.hpp"
 #include "tg/core/task_data.hpp"
+#include "tg/core/data_size_traits.hpp"
+#include "tg/core/spill_traits.hpp"
 
 namespace tg::core
 {
@@ -22,9 +24,21 @@ public:
     template <typename... Args>
     T& emplace(Args&&... args);
 
+    /**
+     * @brief Like emplace(), but constructs the value in shared memory, so
+     * that it can be handed to another process without a copy.
+     * @details T must be trivially copyable.
+     */
+    template <typename... Args>
+    T& emplace_shared(SharedMemoryPool& pool, Args&&... args);
+
     T& operator*();
     T* operator->();
 
+    std::size_t byte_size_hint() const final;
+
+    const SpillCodec* spill_codec() const final;
+
 private:
     TaskOutput(const TaskOutput&) = delete;
     TaskOutput(TaskOutput&&) = delete;
@@ -1,12 +1,13 @@
 #pragma once
 #include "tg/core/task_output.fwd.hpp"
+#include "tg/core/shared_memory.hpp"
 
 namespace tg::core
 {
 
 template <typename T>
 TaskOutput<T>::TaskOutput(const std::string& name)
-    : TaskData{name, TaskDataFlags::Output}
+    : TaskData{name, TaskDataFlags::Output, TypeId::of<T>()}
 {
 }
 
@@ -25,8 +26,7 @@ T& TaskOutput<T>::emplace(Args&&... args)
 {
     std::shared_ptr<T> sp = std::make_shared<T>(std::forward<Args>(args)...);
     std::shared_ptr<void> vp = std::static_pointer_cast<void>(sp);
-    auto ti = std::type_index(typeid(T));
-    if (!this->try_assign(vp, ti))
+    if (!this->try_assign(vp, TypeId::of<T>()))
     {
         throw std::runtime_error("TaskOutput<T>::emplace() : failed to assign value.");
     }
@@ -34,6 +34,18 @@ T& TaskOutput<T>::emplace(Args&&... args)
     return *rp;
 }
 
+template <typename T>
+template <typename... Args>
+T& TaskOutput<T>::emplace_shared(SharedMemoryPool& pool, Args&&... args)
+{
+    std::shared_ptr<T> sp = make_shared_in<T>(pool, std::forward<Args>(args)...);
+    if (!this->try_assign(std::static_pointer_cast<void>(sp), TypeId::of<T>()))
+    {
+        throw std::runtime_error("TaskOutput<T>::emplace_shared() : failed to assign value.");
+    }
+    return *sp;
+}
+
 template <typename T>
 T& TaskOutput<T>::operator*()
 {
@@ -44,7 +56,7 @@ template <typename T>
 T* TaskOutput<T>::operator->()
 {
     std::shared_ptr<void> out_value;
-    std::type_index out_type;
+    TypeId out_type;
     if (!this->try_get(out_value, out_type))
     {
         throw std::runtime_error("TaskInput<T>::operator*() : failed to get value.");
@@ -52,12 +64,11 @@ T* TaskOutput<T>::operator->()
     /**
      * @invariant out_value is not null, enforced by TaskData::try_get()
      */
-    if (out_type != std::type_index(typeid(T)))
+    if (out_type != TypeId::of<T>())
     {
-        std::string str_expected{typeid(T).name()};
-        std::string str_actual{out_type.name()};
+        std::string str_expected{type_name<T>()};
         throw std::runtime_error("TaskInput<T>::operator*() : type mismatch. Expected: " +
-            str_expected + ", got: " + str_actual);
+            str_expected + ", got: " + to_string(out_type));
     }
     /**
      * @note Equivalent to std::static_pointer_cast<T>(out_value)
@@ -66,4 +77,22 @@ T* TaskOutput<T>::operator->()
     return static_cast<T*>(out_value.get());
 }
 
+template <typename T>
+std::size_t TaskOutput<T>::byte_size_hint() const
+{
+    std::shared_ptr<void> out_value;
+    TypeId out_type;
+    if (!this->try_get(out_value, out_type) || out_type != TypeId::of<T>())
+    {
+        return 0u;
+    }
+    return DataSizeTraits<T>::byte_size(*static_cast<const T*>(out_value.get()));
+}
+
+template <typename T>
+const SpillCodec* TaskOutput<T>::spill_codec() const
+{
+    return SpillCodec::of<T>();
+}
+
 } // namespace tg::core
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include "tg/core/tenant.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+/**
+ * @brief Pass increment of a tenant of weight 1; a tenant of weight w
+ * advances by stride_base / w per dispatched item.
+ */
+constexpr std::uint64_t stride_base = std::uint64_t{1u} << 20u;
+
+} // namespace
+
+Tenant::Tenant(std::shared_ptr<TenantScheduler> scheduler, const TenantOptions& options)
+    : m_scheduler{std::move(scheduler)}
+    , m_options{options}
+    , m_stride{std::max<std::uint64_t>(stride_base / options.weight, 1u)}
+    , m_ready{}
+    , m_in_flight{0u}
+    , m_pass{0u}
+{
+}
+
+Tenant::~Tenant()
+{
+    m_scheduler->unregister(this);
+}
+
+const TenantOptions& Tenant::options() const
+{
+    return m_options;
+}
+
+std::size_t Tenant::in_flight() const
+{
+    std::unique_lock<std::mutex> lock(m_scheduler->m_mutex);
+    return m_in_flight;
+}
+
+std::size_t Tenant::queued() const
+{
+    std::unique_lock<std::mutex> lock(m_scheduler->m_mutex);
+    return m_ready.size();
+}
+
+TenantScheduler::TenantScheduler(WorkerPoolPtr pool)
+    : m_pool{std::move(pool)}
+    , m_window{std::max<std::size_t>(m_pool->size(), 1u)}
+    , m_mutex{}
+    , m_tenants{}
+    , m_in_flight{0u}
+    , m_virtual_time{0u}
+{
+}
+
+TenantScheduler::~TenantScheduler()
+{
+}
+
+TenantPtr TenantScheduler::create_tenant(const TenantOptions& options)
+{
+    if (options.weight == 0u)
+    {
+        throw std::invalid_argument("TenantScheduler::create_tenant(): weight must be positive.");
+    }
+    TenantPtr tenant{new Tenant{this->shared_from_this(), options}};
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_tenants.push_back(tenant.get());
+    return tenant;
+}
+
+bool TenantScheduler::owns(const Tenant& tenant) const
+{
+    return tenant.m_scheduler.get() == this;
+}
+
+void TenantScheduler::submit(Tenant& tenant, const WorkItem& item, int preferred_worker)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (tenant.m_ready.empty() && tenant.m_in_flight == 0u)
+    {
+        tenant.m_pass = std::max(tenant.m_pass, m_virtual_time);
+    }
+    tenant.m_ready.push_back(Tenant::ReadyItem{item, preferred_worker});
+    this->dispatch_locked();
+}
+
+void TenantScheduler::release(Tenant& tenant)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    --tenant.m_in_flight;
+    --m_in_flight;
+    this->dispatch_locked();
+}
+
+void TenantScheduler::unregister(Tenant* tenant)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_tenants.erase(std::remove(m_tenants.begin(), m_tenants.end(), tenant), m_tenants.end());
+}
+
+/**
+ * @note Items are submitted to the pool under m_mutex, so that they reach
+ * the pool in dispatch order.
+ */
+void TenantScheduler::dispatch_locked()
+{
+    while (m_in_flight < m_window)
+    {
+        Tenant* tenant = this->pick_locked();
+        if (!tenant)
+        {
+            return;
+        }
+        Tenant::ReadyItem ready = tenant->m_ready.front();
+        tenant->m_ready.pop_front();
+        ++tenant->m_in_flight;
+        ++m_in_flight;
+        m_virtual_time = tenant->m_pass;
+        tenant->m_pass += tenant->m_stride;
+        m_pool->submit(ready.item, ready.preferred_worker);
+    }
+}
+
+Tenant* TenantScheduler::pick_locked() const
+{
+    Tenant* best = nullptr;
+    for (Tenant* tenant : m_tenants)
+    {
+        const auto& options = tenant->m_options;
+        if (tenant->m_ready.empty() ||
+            (options.max_concurrency != 0u && tenant->m_in_flight >= options.max_concurrency))
+        {
+            continue;
+        }
+        if (!best || options.priority > best->m_options.priority ||
+            (options.priority == best->m_options.priority && tenant->m_pass < best->m_pass))
+        {
+            best = tenant;
+        }
+    }
+    return best;
+}
+
+} // namespace tg::core
@@ -0,0 +1,159 @@
+#pragma once
+#include <deque>
+#include "tg/core/fwd.hpp"
+#include "tg/core/worker_pool.hpp"
+
+namespace tg::core
+{
+
+struct TenantOptions
+{
+    /**
+     * @brief Name of the tenant, for diagnostics.
+     */
+    std::string name;
+
+    /**
+     * @brief QoS lane. Ready work of a higher lane is always dispatched to
+     * the pool before ready work of a lower lane.
+     */
+    int priority = 0;
+
+    /**
+     * @brief Share of the pool relative to the other tenants of the same
+     * lane, which are served weighted-fair. Must be positive.
+     */
+    std::uint32_t weight = 1u;
+
+    /**
+     * @brief Maximum number of work items of this tenant on the pool at
+     * once. Zero means no cap.
+     */
+    std::size_t max_concurrency = 0u;
+};
+
+/**
+ * @brief A client of a shared Executor, such as one graph or one stream of
+ * graph runs, with its own QoS lane and concurrency cap.
+ *
+ * @details
+ * Created by Executor::create_tenant(), and passed to runs through
+ * RunOptions::tenant. Runs of several tenants, typically started from
+ * different threads, then share one WorkerPool without oversubscribing it.
+ *
+ * This class is thread-safe.
+ */
+class Tenant
+{
+public:
+    ~Tenant();
+
+    const TenantOptions& options() const;
+
+    /**
+     * @brief Number of work items of this tenant currently on the pool.
+     */
+    std::size_t in_flight() const;
+
+    /**
+     * @brief Number of ready work items of this tenant waiting to be
+     * dispatched.
+     */
+    std::size_t queued() const;
+
+private:
+    Tenant(std::shared_ptr<TenantScheduler> scheduler, const TenantOptions& options);
+
+    Tenant(const Tenant&) = delete;
+    Tenant& operator=(const Tenant&) = delete;
+    Tenant(Tenant&&) = delete;
+    Tenant& operator=(Tenant&&) = delete;
+
+private:
+    friend class TenantScheduler;
+
+    struct ReadyItem
+    {
+        WorkItem item;
+        int preferred_worker;
+    };
+
+    std::shared_ptr<TenantScheduler> m_scheduler;
+    TenantOptions m_options;
+    std::uint64_t m_stride;
+
+    /**
+     * @note The members below are guarded by the scheduler's mutex.
+     */
+    std::deque<ReadyItem> m_ready;
+    std::size_t m_in_flight;
+    std::uint64_t m_pass;
+};
+
+/**
+ * @brief Dispatches the work of tenants to a shared WorkerPool. Used by the
+ * Executor.
+ *
+ * @details
+ * Ready work items of a tenant are held back in the tenant's queue, and at
+ * most one item per worker is on the pool at any time, so that the pool's
+ * queues stay short and a newly ready item of a high lane does not wait
+ * behind a backlog of low lane work. Whenever a dispatched item completes,
+ * the next item is chosen from the highest lane that has ready work and is
+ * under its cap; within a lane, tenants are served by stride scheduling, in
+ * proportion to their weights. A tenant that was idle does not accumulate
+ * credit.
+ *
+ * Work items submitted without a tenant, such as nested runs and async
+ * completions, bypass the scheduler.
+ *
+ * This class is thread-safe.
+ */
+class TenantScheduler : public std::enable_shared_from_this<TenantScheduler>
+{
+public:
+    explicit TenantScheduler(WorkerPoolPtr pool);
+    ~TenantScheduler();
+
+    /**
+     * @throws std::invalid_argument if the weight is zero.
+     */
+    TenantPtr create_tenant(const TenantOptions& options);
+
+    bool owns(const Tenant& tenant) const;
+
+    /**
+     * @brief Queues a ready work item of a tenant, and dispatches it right
+     * away if the tenant and the pool have room.
+     */
+    void submit(Tenant& tenant, const WorkItem& item, int preferred_worker);
+
+    /**
+     * @brief Called when a dispatched work item of the tenant has completed;
+     * dispatches the next item.
+     */
+    void release(Tenant& tenant);
+
+private:
+    TenantScheduler(const TenantScheduler&) = delete;
+    TenantScheduler& operator=(const TenantScheduler&) = delete;
+    TenantScheduler(TenantScheduler&&) = delete;
+    TenantScheduler& operator=(TenantScheduler&&) = delete;
+
+private:
+    friend class Tenant;
+
+    void unregister(Tenant* tenant);
+    void dispatch_locked();
+    Tenant* pick_locked() const;
+
+private:
+    WorkerPoolPtr m_pool;
+    const std::size_t m_window;
+    mutable std::mutex m_mutex;
+    std::vector<Tenant*> m_tenants;  ///< Guarded by m_mutex.
+    std::size_t m_in_flight;  ///< Guarded by m_mutex.
+    std::uint64_t m_virtual_time;  ///< Pass of the last dispatched item; guarded by m_mutex.
+};
+
+} // namespace tg::core
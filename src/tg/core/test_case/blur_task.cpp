@@ -4,6 +4,7 @@
 #include "tg/core/task_dataset.hpp"
 #include "tg/core/task_input.hpp"
 #include "tg/core/task_output.hpp"
+#include "tg/data/hashing/fnv1a_detail.hpp"
 
 namespace tg::core::test_case
 {
@@ -32,4 +33,20 @@ void BlurTask::on_execute()
     fake_opencv::GaussianBlur(input, output);
 }
 
+/**
+ * @note The blur has no parameters: two blurs of the same input are equal.
+ */
+bool BlurTask::try_get_parameter_hash(std::uint64_t& hash) const
+{
+    using namespace tg::data::hashing::fnv1a_detail;
+    std::uint64_t type = TypeId::of<BlurTask>().value();
+    hash = fnv1a_memory_range(fnv1a_init(), &type, sizeof(type));
+    return true;
+}
+
+TypeId BlurTask::task_type() const
+{
+    return TypeId::of<BlurTask>();
+}
+
 } // namespace tg::core::test_case
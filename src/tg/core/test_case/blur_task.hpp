@@ -13,6 +13,8 @@ public:
     BlurTask(const std::string& input, const std::string& output);
     ~BlurTask();
     void on_execute() final;
+    bool try_get_parameter_hash(std::uint64_t& hash) const final;
+    TypeId task_type() const final;
 
 private:
     std::shared_ptr<TaskInput<fake_opencv::Mat>> m_input;
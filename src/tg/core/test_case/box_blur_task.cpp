@@ -0,0 +1,109 @@
+#include <algorithm>
+#include "tg/core/test_case/box_blur_task.hpp"
+#include "tg/core/parallel_for.hpp"
+#include "tg/core/task_context.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/task_input.hpp"
+#include "tg/core/task_output.hpp"
+#include "tg/data/hashing/fnv1a_detail.hpp"
+
+namespace tg::core::test_case
+{
+
+namespace
+{
+
+constexpr std::size_t rows_per_chunk = 32u;
+
+} // namespace
+
+BoxBlurTask::BoxBlurTask(const std::string& input, const std::string& output, int radius)
+    : Task{}
+    , m_input{std::make_shared<TaskInput<ImageBuffer>>(input)}
+    , m_output{std::make_shared<TaskOutput<ImageBuffer>>(output)}
+    , m_radius{radius}
+{
+    if (radius < 0)
+    {
+        throw std::invalid_argument("BoxBlurTask: radius cannot be negative.");
+    }
+    auto dataset = this->get_dataset();
+    dataset->add(m_input);
+    dataset->add(m_output);
+    dataset->freeze_add();
+}
+
+BoxBlurTask::~BoxBlurTask()
+{
+}
+
+void BoxBlurTask::on_execute()
+{
+    const ImageBuffer& input = **m_input;
+    if (input.pixel_bytes() != 1u)
+    {
+        throw std::invalid_argument("BoxBlurTask: expects one byte per pixel.");
+    }
+    const int width = input.width();
+    const int height = input.height();
+    ImageBuffer& output = m_output->emplace(ImageBuffer::allocate(width, height, 1u));
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+    const int taps = 2 * m_radius + 1;
+    std::uint32_t* sums = TaskContext::current()->scratch().allocate_array<std::uint32_t>(
+        static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    parallel_for(0u, static_cast<std::size_t>(height), rows_per_chunk, [&](std::size_t y_begin, std::size_t y_end)
+    {
+        for (std::size_t y = y_begin; y < y_end; ++y)
+        {
+            const std::uint8_t* src = input.row<std::uint8_t>(static_cast<int>(y));
+            std::uint32_t* dst = sums + y * static_cast<std::size_t>(width);
+            for (int x = 0; x < width; ++x)
+            {
+                std::uint32_t sum = 0u;
+                for (int k = -m_radius; k <= m_radius; ++k)
+                {
+                    sum += src[std::clamp(x + k, 0, width - 1)];
+                }
+                dst[x] = sum;
+            }
+        }
+    });
+    const std::uint32_t area = static_cast<std::uint32_t>(taps * taps);
+    parallel_for(0u, static_cast<std::size_t>(height), rows_per_chunk, [&](std::size_t y_begin, std::size_t y_end)
+    {
+        for (std::size_t y = y_begin; y < y_end; ++y)
+        {
+            std::uint8_t* dst = output.row<std::uint8_t>(static_cast<int>(y));
+            for (int x = 0; x < width; ++x)
+            {
+                std::uint32_t sum = 0u;
+                for (int k = -m_radius; k <= m_radius; ++k)
+                {
+                    int row = std::clamp(static_cast<int>(y) + k, 0, height - 1);
+                    sum += sums[static_cast<std::size_t>(row) * static_cast<std::size_t>(width) + x];
+                }
+                dst[x] = static_cast<std::uint8_t>((sum + area / 2u) / area);
+            }
+        }
+    });
+}
+
+bool BoxBlurTask::try_get_parameter_hash(std::uint64_t& hash) const
+{
+    using namespace tg::data::hashing::fnv1a_detail;
+    std::uint64_t type = TypeId::of<BoxBlurTask>().value();
+    std::int32_t radius = m_radius;
+    hash = fnv1a_memory_range(fnv1a_init(), &type, sizeof(type));
+    hash = fnv1a_memory_range(hash, &radius, sizeof(radius));
+    return true;
+}
+
+TypeId BoxBlurTask::task_type() const
+{
+    return TypeId::of<BoxBlurTask>();
+}
+
+} // namespace tg::core::test_case
@@ -0,0 +1,31 @@
+#pragma once
+#include "tg/core/task.hpp"
+#include "tg/core/task_input.fwd.hpp"
+#include "tg/core/task_output.fwd.hpp"
+#include "tg/core/image_buffer.hpp"
+
+namespace tg::core::test_case
+{
+
+/**
+ * @brief Blurs a single-channel 8-bit image with a separable box filter.
+ * @details The horizontal pass writes column sums into a buffer taken from
+ * the scratch arena of the TaskContext, which the vertical pass reads.
+ * Both passes split the rows with parallel_for(). Edges are clamped.
+ */
+class BoxBlurTask final : public Task
+{
+public:
+    BoxBlurTask(const std::string& input, const std::string& output, int radius);
+    ~BoxBlurTask();
+    void on_execute() final;
+    bool try_get_parameter_hash(std::uint64_t& hash) const final;
+    TypeId task_type() const final;
+
+private:
+    std::shared_ptr<TaskInput<ImageBuffer>> m_input;
+    std::shared_ptr<TaskOutput<ImageBuffer>> m_output;
+    int m_radius;
+};
+
+} // namespace tg::core::test_case
@@ -0,0 +1,50 @@
+#include "tg/core/test_case/crop_task.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/task_input.hpp"
+#include "tg/core/task_output.hpp"
+#include "tg/data/hashing/fnv1a_detail.hpp"
+
+namespace tg::core::test_case
+{
+
+CropTask::CropTask(const std::string& input, const std::string& output, int x, int y, int width, int height)
+    : Task{}
+    , m_input{std::make_shared<TaskInput<ImageBuffer>>(input)}
+    , m_output{std::make_shared<TaskOutput<ImageBuffer>>(output)}
+    , m_x{x}
+    , m_y{y}
+    , m_width{width}
+    , m_height{height}
+{
+    auto dataset = this->get_dataset();
+    dataset->add(m_input);
+    dataset->add(m_output);
+    dataset->freeze_add();
+}
+
+CropTask::~CropTask()
+{
+}
+
+void CropTask::on_execute()
+{
+    const ImageBuffer& input = **m_input;
+    m_output->emplace(input.roi(m_x, m_y, m_width, m_height));
+}
+
+bool CropTask::try_get_parameter_hash(std::uint64_t& hash) const
+{
+    using namespace tg::data::hashing::fnv1a_detail;
+    std::uint64_t type = TypeId::of<CropTask>().value();
+    std::int32_t rect[4] = {m_x, m_y, m_width, m_height};
+    hash = fnv1a_memory_range(fnv1a_init(), &type, sizeof(type));
+    hash = fnv1a_memory_range(hash, rect, sizeof(rect));
+    return true;
+}
+
+TypeId CropTask::task_type() const
+{
+    return TypeId::of<CropTask>();
+}
+
+} // namespace tg::core::test_case
@@ -0,0 +1,31 @@
+#pragma once
+#include "tg/core/task.hpp"
+#include "tg/core/task_input.fwd.hpp"
+#include "tg/core/task_output.fwd.hpp"
+#include "tg/core/image_buffer.hpp"
+
+namespace tg::core::test_case
+{
+
+/**
+ * @brief Outputs a view of a rectangle of its input, without copying.
+ */
+class CropTask final : public Task
+{
+public:
+    CropTask(const std::string& input, const std::string& output, int x, int y, int width, int height);
+    ~CropTask();
+    void on_execute() final;
+    bool try_get_parameter_hash(std::uint64_t& hash) const final;
+    TypeId task_type() const final;
+
+private:
+    std::shared_ptr<TaskInput<ImageBuffer>> m_input;
+    std::shared_ptr<TaskOutput<ImageBuffer>> m_output;
+    int m_x;
+    int m_y;
+    int m_width;
+    int m_height;
+};
+
+} // namespace tg::core::test_case
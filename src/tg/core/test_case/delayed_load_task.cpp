@@ -0,0 +1,42 @@
+#include <chrono>
+#include "tg/core/test_case/delayed_load_task.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/task_output.hpp"
+
+namespace tg::core::test_case
+{
+
+DelayedLoadTask::DelayedLoadTask(const std::string& output)
+    : AsyncTask{}
+    , m_output{std::make_shared<TaskOutput<fake_opencv::Mat>>(output)}
+    , m_io_thread{}
+{
+    auto dataset = this->get_dataset();
+    dataset->add(m_output);
+    dataset->freeze_add();
+}
+
+DelayedLoadTask::~DelayedLoadTask()
+{
+    if (m_io_thread.joinable())
+    {
+        m_io_thread.join();
+    }
+}
+
+void DelayedLoadTask::on_execute_async(AsyncCompletion& completion)
+{
+    if (m_io_thread.joinable())
+    {
+        m_io_thread.join();
+    }
+    m_io_thread = std::thread(
+        [this, completion = std::move(completion)]() mutable
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            m_output->emplace(fake_opencv::Size{640, 480}, 16);
+            completion.complete();
+        });
+}
+
+} // namespace tg::core::test_case
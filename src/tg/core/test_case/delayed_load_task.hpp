@@ -0,0 +1,25 @@
+#pragma once
+#include <thread>
+#include "tg/core/async_task.hpp"
+#include "tg/core/task_output.fwd.hpp"
+#include "tg/core/test_case/fake_opencv.hpp"
+
+namespace tg::core::test_case
+{
+
+/**
+ * @brief Simulates an image load that completes on an I/O thread.
+ */
+class DelayedLoadTask final : public AsyncTask
+{
+public:
+    explicit DelayedLoadTask(const std::string& output);
+    ~DelayedLoadTask();
+    void on_execute_async(AsyncCompletion& completion) final;
+
+private:
+    std::shared_ptr<TaskOutput<fake_opencv::Mat>> m_output;
+    std::thread m_io_thread;
+};
+
+} // namespace tg::core::test_case
@@ -0,0 +1,59 @@
+#include "tg/core/test_case/nested_blur_task.hpp"
+#include "tg/core/test_case/blur_task.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/executor.hpp"
+#include "tg/core/global_dataset.hpp"
+#include "tg/core/subgraph.hpp"
+#include "tg/core/task_dataset.hpp"
+#include "tg/core/task_graph.hpp"
+#include "tg/core/task_input.hpp"
+#include "tg/core/task_output.hpp"
+
+namespace tg::core::test_case
+{
+
+NestedBlurTask::NestedBlurTask(const std::string& input, const std::string& output, int depth)
+    : Task{}
+    , m_input{std::make_shared<TaskInput<fake_opencv::Mat>>(input)}
+    , m_output{std::make_shared<TaskOutput<fake_opencv::Mat>>(output)}
+    , m_plan{}
+{
+    auto dataset = this->get_dataset();
+    dataset->add(m_input);
+    dataset->add(m_output);
+    dataset->freeze_add();
+
+    auto subgraph = std::make_shared<Subgraph>();
+    subgraph->add_task(std::make_shared<BlurTask>("in", "left"));
+    subgraph->add_task(std::make_shared<BlurTask>("in", "right"));
+    if (depth > 1)
+    {
+        subgraph->add_task(std::make_shared<NestedBlurTask>("left", "out", depth - 1));
+    }
+    else
+    {
+        subgraph->add_task(std::make_shared<BlurTask>("left", "out"));
+    }
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    m_plan = graph.compile();
+}
+
+NestedBlurTask::~NestedBlurTask()
+{
+}
+
+void NestedBlurTask::on_execute()
+{
+    Executor* executor = Executor::current();
+    if (!executor)
+    {
+        throw std::logic_error("NestedBlurTask::on_execute(): must be run by an Executor.");
+    }
+    auto data = m_plan->make_dataset();
+    data->set("in", std::make_shared<fake_opencv::Mat>(**m_input));
+    executor->run(*m_plan, *data);
+    m_output->emplace(*data->get<fake_opencv::Mat>("out"));
+}
+
+} // namespace tg::core::test_case
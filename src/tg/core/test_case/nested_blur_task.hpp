@@ -0,0 +1,27 @@
+#pragma once
+#include "tg/core/task.hpp"
+#include "tg/core/task_input.fwd.hpp"
+#include "tg/core/task_output.fwd.hpp"
+#include "tg/core/test_case/fake_opencv.hpp"
+
+namespace tg::core::test_case
+{
+
+/**
+ * @brief A plugin task that runs a nested graph of blur tasks on the
+ * Executor that runs this task.
+ */
+class NestedBlurTask final : public Task
+{
+public:
+    NestedBlurTask(const std::string& input, const std::string& output, int depth);
+    ~NestedBlurTask();
+    void on_execute() final;
+
+private:
+    std::shared_ptr<TaskInput<fake_opencv::Mat>> m_input;
+    std::shared_ptr<TaskOutput<fake_opencv::Mat>> m_output;
+    ExecutionPlanPtr m_plan;
+};
+
+} // namespace tg::core::test_case
@@ -1,8 +1,921 @@
+#include <cstring>
+#include <filesystem>
+#include <future>
 #include <iostream>
+#include <thread>
+#if defined(LINUX)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 #include "tg/core/test_case/test_case_main.hpp"
 #include "tg/core/subgraph.hpp"
 #include "tg/core/test_case/blur_task.hpp"
+#include "tg/core/test_case/box_blur_task.hpp"
+#include "tg/core/test_case/crop_task.hpp"
+#include "tg/core/test_case/delayed_load_task.hpp"
+#include "tg/core/test_case/nested_blur_task.hpp"
 #include "tg/core/task_dataset.hpp"
+#include "tg/core/task_graph.hpp"
+#include "tg/core/execution_plan.hpp"
+#include "tg/core/global_dataset.hpp"
+#include "tg/core/worker_pool.hpp"
+#include "tg/core/executor.hpp"
+#include "tg/core/cancellation_token.hpp"
+#include "tg/core/plan_cache.hpp"
+#include "tg/core/pruned_plan_cache.hpp"
+#include "tg/core/schedule_log.hpp"
+#include "tg/core/spill_store.hpp"
+#include "tg/core/shared_memory.hpp"
+#include "tg/core/tenant.hpp"
+#include "tg/core/graph_partitioner.hpp"
+#include "tg/core/partition_coordinator.hpp"
+#include "tg/core/unix_channel.hpp"
+#include "tg/core/image_buffer.hpp"
+#include "tg/core/lock_profiler.hpp"
+#include "tg/core/scratch_arena.hpp"
+#include "tg/core/reduction.hpp"
+#include "tg/core/parallel_for.hpp"
+#include "tg/facade/dag_check.hpp"
+
+namespace
+{
+
+/**
+ * @brief Runs a chain of blur tasks and an asynchronous load, split into
+ * two subgraphs, on the Executor.
+ */
+void test_case_executor()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto first = std::make_shared<Subgraph>("first");
+    first->add_input("source");
+    first->add_output("middle");
+    first->add_task(std::make_shared<DelayedLoadTask>("loaded"));
+    first->add_task(std::make_shared<BlurTask>("loaded", "blur_0"));
+    first->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    first->add_task(std::make_shared<BlurTask>("blur_1", "middle"));
+
+    auto second = std::make_shared<Subgraph>("second");
+    second->add_input("middle");
+    second->add_output("result");
+    second->add_task(std::make_shared<BlurTask>("middle", "blur_2"));
+    second->add_task(std::make_shared<BlurTask>("blur_2", "result"));
+
+    TaskGraph graph;
+    graph.add_subgraph(first);
+    graph.add_subgraph(second);
+    ExecutionPlanPtr plan = graph.compile();
+
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+
+    WorkerPoolOptions pool_options;
+    pool_options.num_workers = 2u;
+    Executor executor{std::make_shared<WorkerPool>(pool_options)};
+    executor.run(*plan, *data);
+
+    auto result = data->get<fake_opencv::Mat>("result");
+    std::cout << "Executor result pointer: " << result.get() << std::endl;
+    std::cout << "Intermediate released: " << (data->get<fake_opencv::Mat>("first/blur_1") == nullptr) << std::endl;
+    int fused_links = 0;
+    for (const auto& plan_task : plan->tasks)
+    {
+        fused_links += (plan_task.fused_next >= 0) ? 1 : 0;
+    }
+    std::cout << "Fused links: " << fused_links << std::endl;
+}
+
+/**
+ * @brief Runs nested graphs on a single worker, which must help execute
+ * the nested tasks instead of blocking. Inline runs are disabled, so that
+ * the graphs go through the pool.
+ */
+void test_case_nested_executor()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>();
+    subgraph->add_task(std::make_shared<NestedBlurTask>("source", "result", 3));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+
+    WorkerPoolOptions pool_options;
+    pool_options.num_workers = 1u;
+    ExecutorOptions executor_options;
+    executor_options.inline_task_limit = 0u;
+    executor_options.nested_inline_task_limit = 0u;
+    Executor executor{std::make_shared<WorkerPool>(pool_options), executor_options};
+    executor.run(*plan, *data);
+
+    auto result = data->get<fake_opencv::Mat>("result");
+    std::cout << "Nested executor result pointer: " << result.get() << std::endl;
+
+    /**
+     * @note With the default options, the same graphs run inline.
+     */
+    GlobalDataSetPtr inline_data = plan->make_dataset();
+    inline_data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    Executor inline_executor{std::make_shared<WorkerPool>(pool_options)};
+    inline_executor.run(*plan, *inline_data);
+    std::cout << "Inline nested result: " << (inline_data->get<fake_opencv::Mat>("result") != nullptr)
+        << std::endl;
+}
+
+/**
+ * @brief Runs a graph whose deadline has already passed. No task should be
+ * executed, and the graph input should remain available.
+ */
+void test_case_deadline()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>();
+    subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_1", "result"));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+
+    RunOptions options;
+    options.token = std::make_shared<CancellationToken>(CancellationToken::Clock::now());
+    Executor executor{std::make_shared<WorkerPool>()};
+    RunResult result = executor.try_run(*plan, *data, options);
+
+    std::cout << "Deadline exceeded: " << (result.status == RunStatus::DeadlineExceeded)
+        << ", executed: " << result.executed_tasks
+        << ", skipped: " << result.skipped_tasks << std::endl;
+}
+
+/**
+ * @brief Compiles a graph through the plan cache twice; the second plan is
+ * loaded from the memory-mapped plan file, and is then run.
+ */
+void test_case_plan_cache()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto make_graph = [](TaskGraph& graph)
+    {
+        auto subgraph = std::make_shared<Subgraph>("cached");
+        subgraph->add_input("source");
+        subgraph->add_output("result");
+        subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+        subgraph->add_task(std::make_shared<BlurTask>("blur_1", "result"));
+        graph.add_subgraph(subgraph);
+    };
+    PlanCache cache{std::filesystem::temp_directory_path().string()};
+    TaskGraph first_graph;
+    make_graph(first_graph);
+    std::string path = cache.path_for(first_graph.structural_hash());
+    std::filesystem::remove(path);
+    ExecutionPlanPtr compiled = cache.load_or_compile(first_graph);
+
+    TaskGraph second_graph;
+    make_graph(second_graph);
+    ExecutionPlanPtr loaded = cache.load_or_compile(second_graph);
+
+    GlobalDataSetPtr data = loaded->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    Executor executor{std::make_shared<WorkerPool>()};
+    executor.run(*loaded, *data);
+
+    std::cout << "Plan cache slots match: " << (compiled->slots.size() == loaded->slots.size() &&
+        compiled->slots[1].name == loaded->slots[1].name)
+        << ", result: " << (data->get<fake_opencv::Mat>("result") != nullptr) << std::endl;
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Runs one branch of a two-branch graph, by requesting only its
+ * output.
+ */
+void test_case_pruned_plan()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("product");
+    subgraph->add_input("source");
+    subgraph->add_output("preview");
+    subgraph->add_output("full");
+    subgraph->add_task(std::make_shared<BlurTask>("source", "preview"));
+    subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_1", "full"));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+
+    PrunedPlanCache cache{graph.compile()};
+    ExecutionPlanPtr preview_plan = cache.plan_for({"preview"});
+    GlobalDataSetPtr data = cache.full_plan()->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    Executor executor{std::make_shared<WorkerPool>()};
+    RunResult result = executor.try_run(*preview_plan, *data);
+
+    std::cout << "Pruned plan tasks: " << preview_plan->tasks.size()
+        << ", executed: " << result.executed_tasks
+        << ", preview: " << (data->get<fake_opencv::Mat>("preview") != nullptr)
+        << ", full: " << (data->get<fake_opencv::Mat>("full") != nullptr)
+        << ", cached: " << (cache.plan_for({"preview", "preview"}) == preview_plan) << std::endl;
+}
+
+/**
+ * @brief Two instances of the same subgraph on the same source are merged
+ * into one chain, whose outputs fan out to both instances.
+ */
+void test_case_common_subexpression()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    TaskGraph graph;
+    for (const char* name : {"left", "right"})
+    {
+        auto subgraph = std::make_shared<Subgraph>(name);
+        subgraph->add_input("source");
+        subgraph->add_output(std::string{name} + "_result");
+        subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+        subgraph->add_task(std::make_shared<BlurTask>("blur_1", std::string{name} + "_result"));
+        graph.add_subgraph(subgraph);
+    }
+    ExecutionPlanPtr plan = graph.compile();
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    Executor executor{std::make_shared<WorkerPool>()};
+    executor.run(*plan, *data);
+
+    auto left = data->get<fake_opencv::Mat>("left_result");
+    auto right = data->get<fake_opencv::Mat>("right_result");
+    std::cout << "Merged plan tasks: " << plan->tasks.size()
+        << ", shared result: " << (left != nullptr && left == right)
+        << ", intermediates retained: " << (data->get<fake_opencv::Mat>("right/blur_1") != nullptr) << std::endl;
+}
+
+/**
+ * @brief Records the schedule of a run, saves and reloads it, and replays
+ * it on a second run.
+ */
+void test_case_schedule_replay()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("replayed");
+    subgraph->add_input("source");
+    subgraph->add_input("other");
+    subgraph->add_output("left");
+    subgraph->add_output("right");
+    subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_1", "left"));
+    subgraph->add_task(std::make_shared<BlurTask>("other", "right"));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+    Executor executor{std::make_shared<WorkerPool>()};
+
+    ScheduleLog recorded;
+    GlobalDataSetPtr first = plan->make_dataset();
+    first->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    first->set("other", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{320, 240}, 16));
+    RunOptions record_options;
+    record_options.record_schedule = &recorded;
+    executor.try_run(*plan, *first, record_options);
+
+    std::string path = (std::filesystem::temp_directory_path() / "tg_schedule.bin").string();
+    recorded.save(path);
+    ScheduleLog loaded = ScheduleLog::load(path);
+    std::filesystem::remove(path);
+
+    ScheduleLog replayed;
+    GlobalDataSetPtr second = plan->make_dataset();
+    second->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    second->set("other", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{320, 240}, 16));
+    RunOptions replay_options;
+    replay_options.record_schedule = &replayed;
+    replay_options.replay_schedule = &loaded;
+    RunResult result = executor.try_run(*plan, *second, replay_options);
+
+    bool same = replayed.task_count() == loaded.task_count();
+    for (std::size_t k = 0u; same && k < loaded.task_count(); ++k)
+    {
+        const auto& expected = loaded.at(static_cast<int>(k));
+        const auto& actual = replayed.at(static_cast<int>(k));
+        same = expected.worker == actual.worker && expected.sequence == actual.sequence;
+    }
+
+    ScheduleLog reversed;
+    reversed.reset(loaded.task_count());
+    for (std::size_t k = 0u; k < loaded.task_count(); ++k)
+    {
+        ScheduledTask entry = loaded.at(static_cast<int>(k));
+        entry.sequence = static_cast<std::uint32_t>(loaded.task_count() - 1u) - entry.sequence;
+        reversed.set(static_cast<int>(k), entry);
+    }
+    RunOptions reversed_options;
+    reversed_options.replay_schedule = &reversed;
+    bool rejected = false;
+    try
+    {
+        executor.try_run(*plan, *second, reversed_options);
+    }
+    catch (const std::invalid_argument&)
+    {
+        rejected = true;
+    }
+    std::cout << "Replayed tasks: " << result.executed_tasks
+        << ", same schedule: " << same << ", out-of-order log rejected: " << rejected << std::endl;
+}
+
+/**
+ * @brief Runs a latency-critical graph and a capped batch graph
+ * concurrently, as two tenants of one shared Executor.
+ */
+void test_case_tenants()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto make_plan = [](const std::string& name)
+    {
+        auto subgraph = std::make_shared<Subgraph>(name);
+        subgraph->add_input("source");
+        subgraph->add_input("other");
+        subgraph->add_output("result");
+        subgraph->add_output("side");
+        subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+        subgraph->add_task(std::make_shared<BlurTask>("blur_1", "result"));
+        subgraph->add_task(std::make_shared<BlurTask>("other", "side"));
+        TaskGraph graph;
+        graph.add_subgraph(subgraph);
+        return graph.compile();
+    };
+    ExecutorOptions executor_options;
+    executor_options.inline_task_limit = 0u;
+    Executor executor{std::make_shared<WorkerPool>(), executor_options};
+
+    TenantOptions live_options;
+    live_options.name = "live";
+    live_options.priority = 1;
+    TenantOptions batch_options;
+    batch_options.name = "batch";
+    batch_options.max_concurrency = 1u;
+    TenantPtr tenants[2] = {executor.create_tenant(live_options), executor.create_tenant(batch_options)};
+
+    bool results[2] = {false, false};
+    std::vector<std::thread> threads;
+    for (int k = 0; k < 2; ++k)
+    {
+        threads.emplace_back([&, k]()
+        {
+            ExecutionPlanPtr plan = make_plan(tenants[k]->options().name);
+            RunOptions options;
+            options.tenant = tenants[k];
+            for (int frame = 0; frame < 4; ++frame)
+            {
+                GlobalDataSetPtr data = plan->make_dataset();
+                data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+                data->set("other", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{320, 240}, 16));
+                RunResult result = executor.try_run(*plan, *data, options);
+                results[k] = (result.status == RunStatus::Completed &&
+                    data->get<fake_opencv::Mat>("result") != nullptr);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::cout << "Tenant runs: live " << results[0] << ", batch " << results[1]
+        << ", in flight: " << (tenants[0]->in_flight() + tenants[1]->in_flight()) << std::endl;
+}
+
+/**
+ * @brief Runs a graph with a zero memory budget, so that every value is
+ * spilled to a scratch file as soon as it is published, and faulted back
+ * in when read.
+ */
+void test_case_spill()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("spilled");
+    subgraph->add_input("source");
+    subgraph->add_input("other");
+    subgraph->add_output("left");
+    subgraph->add_output("right");
+    subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_1", "left"));
+    subgraph->add_task(std::make_shared<BlurTask>("other", "blur_2"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_2", "right"));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    data->set("other", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{320, 240}, 16));
+
+    RunOptions options;
+    options.spill_store = SpillStore::create(std::filesystem::temp_directory_path().string());
+    options.spill_budget = 0u;
+    Executor executor{std::make_shared<WorkerPool>()};
+    RunResult result = executor.try_run(*plan, *data, options);
+
+    bool spilled = data->is_spilled(data->find("left"));
+    std::cout << "Spilled run executed: " << result.executed_tasks
+        << ", output spilled: " << spilled
+        << ", restored: " << (data->get<fake_opencv::Mat>("left") != nullptr)
+        << ", resident bytes: " << data->resident_bytes() << std::endl;
+}
+
+/**
+ * @brief Hands a frame from one SharedMemoryPool to another, as if to
+ * another process, and checks that both sides see the same bytes.
+ */
+void test_case_shared_memory()
+{
+#if defined(LINUX)
+    using namespace tg::core;
+
+    struct Frame
+    {
+        int width;
+        int height;
+        std::uint8_t pixels[256];
+    };
+    SharedMemoryPool producer{std::size_t{1u} << 20u};
+    SharedMemoryPool consumer{std::size_t{1u} << 20u};
+    std::shared_ptr<Frame> frame = make_shared_in<Frame>(producer);
+    frame->width = 16;
+    frame->height = 16;
+
+    SharedHandle handle = producer.export_handle(frame);
+    consumer.attach(handle.segment_id, ::dup(producer.segment_fd(handle.segment_id)));
+    auto imported = std::static_pointer_cast<Frame>(consumer.import_handle(handle));
+    imported->pixels[0] = 42u;
+
+    /**
+     * @note A handle into the middle of a payload, or with the wrong size,
+     * is not a block.
+     */
+    int rejected = 0;
+    for (SharedHandle forged : {SharedHandle{handle.segment_id, handle.offset + 64u, 64u},
+        SharedHandle{handle.segment_id, handle.offset, handle.size + 1u}})
+    {
+        try
+        {
+            consumer.import_handle(forged);
+        }
+        catch (const std::invalid_argument&)
+        {
+            ++rejected;
+        }
+    }
+
+    std::cout << "Shared memory width: " << imported->width
+        << ", write visible: " << (frame->pixels[0] == 42u)
+        << ", separate mappings: " << (static_cast<void*>(imported.get()) != static_cast<void*>(frame.get()))
+        << ", forged handles rejected: " << rejected << std::endl;
+#endif
+}
+
+/**
+ * @brief Partitions a graph in two, and runs each part in a forked worker
+ * process, connected to this process by a socket pair.
+ */
+void test_case_partitioned()
+{
+#if defined(LINUX)
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("partitioned");
+    subgraph->add_input("source");
+    subgraph->add_input("other");
+    subgraph->add_output("left");
+    subgraph->add_output("right");
+    subgraph->add_task(std::make_shared<BlurTask>("source", "blur_1"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_1", "left"));
+    subgraph->add_task(std::make_shared<BlurTask>("other", "blur_2"));
+    subgraph->add_task(std::make_shared<BlurTask>("blur_2", "right"));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+
+    GraphPartitioner partitioner{*plan};
+    GraphPartition partition = partitioner.partition();
+
+    std::cout.flush();
+    std::vector<UnixChannelPtr> channels;
+    std::vector<pid_t> children;
+    for (std::size_t part = 0u; part < partition.loads.size(); ++part)
+    {
+        auto [parent_end, child_end] = UnixChannel::create_pair();
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            parent_end->close();
+            for (const auto& channel : channels)
+            {
+                channel->close();
+            }
+            int status = 0;
+            try
+            {
+                Executor executor{std::make_shared<WorkerPool>()};
+                PartitionWorker worker{executor, *plan, child_end};
+                worker.serve();
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Partition worker failed: " << e.what() << std::endl;
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        child_end->close();
+        channels.push_back(parent_end);
+        children.push_back(pid);
+    }
+
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    data->set("other", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{320, 240}, 16));
+    RunResult result;
+    {
+        PartitionCoordinator coordinator{*plan, partition, channels};
+        result = coordinator.run(*data);
+    }
+    for (pid_t pid : children)
+    {
+        ::waitpid(pid, nullptr, 0);
+    }
+
+    std::cout << "Partitioned parts: " << partition.loads.size()
+        << ", cut bytes: " << partition.cut_bytes
+        << ", executed: " << result.executed_tasks
+        << ", outputs: " << (data->get<fake_opencv::Mat>("left") != nullptr)
+        << (data->get<fake_opencv::Mat>("right") != nullptr) << std::endl;
+#endif
+}
+
+/**
+ * @brief Crops two tiles of a frame in a graph, and checks that they are
+ * views of the frame rather than copies.
+ */
+void test_case_image_roi()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("tiles");
+    subgraph->add_input("frame");
+    subgraph->add_output("top_left");
+    subgraph->add_output("bottom_right");
+    subgraph->add_task(std::make_shared<CropTask>("frame", "top_left", 0, 0, 320, 240));
+    subgraph->add_task(std::make_shared<CropTask>("frame", "bottom_right", 320, 240, 320, 240));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+    GlobalDataSetPtr data = plan->make_dataset();
+    auto frame = std::make_shared<ImageBuffer>(ImageBuffer::allocate(640, 480, 3u));
+    frame->at<std::uint8_t>(320 * 3, 240) = 7u;
+    data->set("frame", frame);
+
+    Executor executor{std::make_shared<WorkerPool>()};
+    executor.run(*plan, *data);
+
+    auto tile = data->get<ImageBuffer>("bottom_right");
+    ImageBuffer packed = tile->clone();
+    ImageBuffer empty_clone = ImageBuffer{}.clone();
+    ImageBuffer empty_roi_clone = frame->roi(0, 0, 0, 10).clone();
+    std::cout << "Image stride: " << frame->stride()
+        << ", tile shares frame: " << tile->shares_storage_with(*frame)
+        << ", tile pixel: " << static_cast<int>(tile->at<std::uint8_t>(0, 0))
+        << ", clone aligned: " << packed.is_aligned()
+        << ", empty clones: " << empty_clone.empty() << empty_roi_clone.empty()
+        << ", empty roi clone height: " << empty_roi_clone.height() << std::endl;
+}
+
+/**
+ * @brief Reports the data locks taken by a run, when built with
+ * TG_PROFILE_LOCKS.
+ */
+void test_case_lock_report()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("locks");
+    subgraph->add_input("source");
+    subgraph->add_input("frame");
+    subgraph->add_output("left");
+    subgraph->add_output("right");
+    subgraph->add_task(std::make_shared<BlurTask>("source", "left"));
+    subgraph->add_task(std::make_shared<CropTask>("frame", "right", 0, 0, 8, 8));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+    GlobalDataSetPtr data = plan->make_dataset();
+    data->set("source", std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16));
+    data->set("frame", std::make_shared<ImageBuffer>(ImageBuffer::allocate(16, 16, 1u)));
+
+    std::vector<LockSiteStats> report;
+    RunOptions options;
+    options.lock_report = &report;
+    Executor executor{std::make_shared<WorkerPool>()};
+    executor.try_run(*plan, *data, options);
+
+    std::cout << "Lock profiling: " << LockProfiler::enabled() << ", sites: " << report.size();
+    for (const auto& site : report)
+    {
+        std::cout << ", " << site.name << " " << site.acquisitions << "/" << site.contended;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Runs a separable blur repeatedly, and reports the heap blocks
+ * that the scratch arenas of the worker and of the calling thread, which
+ * runs small plans inline, allocated on the first and later runs.
+ */
+void test_case_scratch_arena()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto subgraph = std::make_shared<Subgraph>("blur");
+    subgraph->add_input("frame");
+    subgraph->add_output("softer");
+    subgraph->add_task(std::make_shared<BoxBlurTask>("frame", "soft", 1));
+    subgraph->add_task(std::make_shared<BoxBlurTask>("soft", "softer", 1));
+    TaskGraph graph;
+    graph.add_subgraph(subgraph);
+    ExecutionPlanPtr plan = graph.compile();
+
+    WorkerPoolOptions pool_options;
+    pool_options.num_workers = 1u;
+    auto pool = std::make_shared<WorkerPool>(pool_options);
+    Executor executor{pool};
+    struct Probe
+    {
+        std::promise<std::size_t> allocations;
+    };
+    auto arena_allocations = [&pool]()
+    {
+        Probe probe;
+        auto future = probe.allocations.get_future();
+        pool->submit_pinned(WorkItem{[](void* context, std::size_t)
+            {
+                static_cast<Probe*>(context)->allocations.set_value(
+                    ScratchArena::for_this_thread().heap_allocations());
+            }, &probe, 0u}, 0u);
+        return future.get() + ScratchArena::for_this_thread().heap_allocations();
+    };
+
+    auto frame = std::make_shared<ImageBuffer>(ImageBuffer::allocate(256, 256, 1u));
+    frame->at<std::uint8_t>(10, 10) = 255u;
+    std::size_t first_run = 0u;
+    int pixel = 0;
+    for (int run = 0; run < 4; ++run)
+    {
+        GlobalDataSetPtr data = plan->make_dataset();
+        data->set("frame", frame);
+        executor.run(*plan, *data);
+        pixel = data->get<ImageBuffer>("softer")->at<std::uint8_t>(10, 10);
+        if (run == 0)
+        {
+            first_run = arena_allocations();
+        }
+    }
+    std::cout << "Scratch heap blocks, first run: " << first_run
+        << ", later runs: " << arena_allocations() - first_run
+        << ", blurred pixel: " << pixel << std::endl;
+}
+
+/**
+ * @brief Merges per-tile histograms with a balanced and an arrival-order
+ * reduction, and checks that both give the same total.
+ */
+void test_case_reduction()
+{
+    using namespace tg::core;
+    using Histogram = std::vector<int>;
+
+    constexpr std::size_t tiles = 8u;
+    std::vector<std::string> inputs;
+    for (std::size_t k = 0u; k < tiles; ++k)
+    {
+        inputs.push_back("histogram_" + std::to_string(k));
+    }
+    CombineFunction<Histogram> add = [](const Histogram& lhs, const Histogram& rhs)
+    {
+        Histogram sum = lhs;
+        for (std::size_t bin = 0u; bin < sum.size(); ++bin)
+        {
+            sum[bin] += rhs[bin];
+        }
+        return sum;
+    };
+
+    Executor executor{std::make_shared<WorkerPool>()};
+    std::size_t task_counts[2] = {};
+    int totals[2] = {};
+    ReductionShape shapes[2] = {ReductionShape::Balanced, ReductionShape::ArrivalOrder};
+    for (int k = 0; k < 2; ++k)
+    {
+        auto subgraph = make_reduction<Histogram>("merge", inputs, "total", add, shapes[k]);
+        task_counts[k] = subgraph->tasks().size();
+        TaskGraph graph;
+        graph.add_subgraph(subgraph);
+        ExecutionPlanPtr plan = graph.compile();
+        for (int run = 0; run < 2; ++run)
+        {
+            GlobalDataSetPtr data = plan->make_dataset();
+            for (std::size_t tile = 0u; tile < tiles; ++tile)
+            {
+                data->set(inputs[tile], std::make_shared<Histogram>(Histogram{static_cast<int>(tile), 1, 2}));
+            }
+            executor.run(*plan, *data);
+            const Histogram& total = *data->get<Histogram>("total");
+            totals[k] = total[0] * 100 + total[1] * 10 + total[2];
+        }
+    }
+    std::cout << "Reduction tasks, balanced: " << task_counts[0] << ", arrival order: " << task_counts[1]
+        << ", total: " << totals[0] << ", same: " << (totals[0] == totals[1]) << std::endl;
+}
+
+/**
+ * @brief Runs a blur whose rows are split with parallel_for() on a pool of
+ * four workers, and on a pool of one, where it runs serially, and compares
+ * the results.
+ */
+void test_case_parallel_for()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    auto frame = std::make_shared<ImageBuffer>(ImageBuffer::allocate(512, 512, 1u));
+    for (int y = 0; y < frame->height(); ++y)
+    {
+        for (int x = 0; x < frame->width(); ++x)
+        {
+            frame->at<std::uint8_t>(x, y) = static_cast<std::uint8_t>((x * 7 + y * 13) % 251);
+        }
+    }
+    std::shared_ptr<ImageBuffer> results[2];
+    std::size_t workers[2] = {4u, 1u};
+    for (int k = 0; k < 2; ++k)
+    {
+        auto subgraph = std::make_shared<Subgraph>("blur");
+        subgraph->add_input("frame");
+        subgraph->add_output("soft");
+        subgraph->add_task(std::make_shared<BoxBlurTask>("frame", "soft", 2));
+        TaskGraph graph;
+        graph.add_subgraph(subgraph);
+        ExecutionPlanPtr plan = graph.compile();
+        GlobalDataSetPtr data = plan->make_dataset();
+        data->set("frame", frame);
+        WorkerPoolOptions pool_options;
+        pool_options.num_workers = workers[k];
+        Executor executor{std::make_shared<WorkerPool>(pool_options)};
+        executor.run(*plan, *data);
+        results[k] = data->get<ImageBuffer>("soft");
+    }
+    bool same = true;
+    for (int y = 0; y < frame->height(); ++y)
+    {
+        same = same && std::memcmp(results[0]->row(y), results[1]->row(y), results[0]->row_bytes()) == 0;
+    }
+    std::cout << "Parallel blur matches serial: " << same << std::endl;
+}
+
+/**
+ * @brief Runs DagCheck on a passing graph and on graphs with each kind of
+ * failure, and prints the diagnostics.
+ */
+void test_case_dag_check()
+{
+    using namespace tg::facade;
+
+    auto report = [](const char* label, const Subgraph& subgraph)
+    {
+        DagCheck check{subgraph};
+        std::cout << "DagCheck " << label << ": passed " << check.passed();
+        for (const auto& message : check.diagnostics())
+        {
+            std::cout << "; " << message;
+        }
+        std::cout << std::endl;
+    };
+
+    Subgraph passing{"passing", {TaskInfo{"t1"} << DataName{"a"} >> DataName{"b"},
+        TaskInfo{"t2"} << DataName{"b"} >> DataName{"c"}}};
+    passing.add_global_input(DataName{"a"});
+    passing.add_global_output(DataName{"c"});
+    report("passing", passing);
+
+    Subgraph cycle{"cycle", {TaskInfo{"t1"} << DataName{"x"} >> DataName{"y"},
+        TaskInfo{"t2"} << DataName{"y"} >> DataName{"x"}}};
+    cycle.add_global_output(DataName{"y"});
+    report("cycle", cycle);
+
+    Subgraph producers{"producers", {TaskInfo{"t1"} << DataName{"a"} >> DataName{"d"},
+        TaskInfo{"t2"} << DataName{"a"} >> DataName{"d"}}};
+    producers.add_global_input(DataName{"a"});
+    producers.add_global_output(DataName{"d"});
+    report("producers", producers);
+
+    Subgraph unknown{"unknown", {TaskInfo{"t1"} << DataName{"a"} >> DataName{"b"}}};
+    unknown.add_global_input(DataName{"a"});
+    unknown.add_global_output(DataName{"b"});
+    unknown.add_barrier("B", {"ghost"}, {"t1"});
+    report("unknown", unknown);
+
+    Subgraph inert{"inert", {TaskInfo{"t1"} << DataName{"a"} >> DataName{"b"},
+        TaskInfo{"t2"} << DataName{"b"} >> DataName{"c"}}};
+    inert.add_global_input(DataName{"a"});
+    inert.add_global_output(DataName{"c"});
+    inert.add_barrier("B", {"t1"}, {"t2"});
+    report("inert barrier", inert);
+
+    Subgraph essential{"essential", {TaskInfo{"t1"} << DataName{"a"} >> DataName{"b"},
+        TaskInfo{"t2"} >> DataName{"c"}}};
+    essential.add_global_input(DataName{"a"});
+    essential.add_global_output(DataName{"b"});
+    essential.add_global_output(DataName{"c"});
+    essential.add_barrier("B", {"t1"}, {"t2"});
+    report("essential barrier", essential);
+}
+
+/**
+ * @brief Builds a graph from subgraphs filled by several threads, and
+ * checks that the parallel compile builds the same plan as compile().
+ */
+void test_case_parallel_compile()
+{
+    using namespace tg::core;
+    using namespace tg::core::test_case;
+
+    constexpr int fragment_count = 8;
+    constexpr int chain_length = 500;
+    std::vector<SubgraphPtr> fragments(fragment_count);
+    std::vector<std::thread> builders;
+    for (int f = 0; f < fragment_count; ++f)
+    {
+        builders.emplace_back([&fragments, f]()
+        {
+            auto fragment = std::make_shared<Subgraph>("fragment_" + std::to_string(f));
+            fragment->add_input("source");
+            fragment->add_output("result_" + std::to_string(f));
+            std::string previous = "source";
+            for (int k = 0; k < chain_length; ++k)
+            {
+                std::string next = (k + 1 == chain_length) ? "result_" + std::to_string(f) : "blur_" + std::to_string(k);
+                fragment->add_task(std::make_shared<BlurTask>(previous, next));
+                previous = next;
+            }
+            fragments[f] = fragment;
+        });
+    }
+    for (auto& builder : builders)
+    {
+        builder.join();
+    }
+    TaskGraph graph;
+    for (const auto& fragment : fragments)
+    {
+        graph.add_subgraph(fragment);
+    }
+
+    WorkerPool pool;
+    ExecutionPlanPtr parallel = graph.compile(pool);
+    ExecutionPlanPtr sequential = graph.compile();
+    bool same = parallel->tasks.size() == sequential->tasks.size() &&
+        parallel->slots.size() == sequential->slots.size() &&
+        parallel->topological_order == sequential->topological_order;
+    for (std::size_t k = 0u; same && k < parallel->slots.size(); ++k)
+    {
+        same = parallel->slots[k].name == sequential->slots[k].name &&
+            parallel->slots[k].producer == sequential->slots[k].producer &&
+            parallel->slots[k].fused == sequential->slots[k].fused;
+    }
+    std::cout << "Parallel compile tasks: " << parallel->tasks.size()
+        << ", slots: " << parallel->slots.size() << ", same plan: " << same << std::endl;
+}
+
+} // namespace
 
 void test_case_main()
 {
@@ -19,7 +932,7 @@ void test_case_main()
     auto dataset = blur_task->get_dataset();
     dataset->at(0)->try_assign(
         std::make_shared<fake_opencv::Mat>(fake_opencv::Size{640, 480}, 16), 
-        typeid(fake_opencv::Mat)
+        TypeId::of<fake_opencv::Mat>()
     );
 
     blur_task->on_execute();
@@ -28,18 +941,38 @@ void test_case_main()
      * @note Simulates executor behavior of retrieving outputs after task execution.
      */
     std::shared_ptr<void> fake_output;
-    std::type_index fake_output_type{typeid(void)};
+    TypeId fake_output_type;
     bool success = dataset->at(1)->try_get(fake_output, fake_output_type);
     if (!success)
     {
         std::cerr << "Failed to get output from the dataset." << std::endl;
         return;
     }
-    std::cout << "Output type: " << fake_output_type.name() << std::endl;
+    std::cout << "Output type: " << to_string(fake_output_type)
+        << (fake_output_type == TypeId::of<fake_opencv::Mat>() ? " (fake_opencv::Mat)" : "") << std::endl;
     std::cout << "Output pointer: " << fake_output.get() << std::endl;
 
     /**
      * @note Simulates executor behavior of post-execution cleanup.
      */
     dataset->release();
+
+    test_case_executor();
+    test_case_nested_executor();
+    test_case_deadline();
+    test_case_plan_cache();
+    test_case_pruned_plan();
+    test_case_common_subexpression();
+    test_case_schedule_replay();
+    test_case_tenants();
+    test_case_spill();
+    test_case_shared_memory();
+    test_case_partitioned();
+    test_case_image_roi();
+    test_case_lock_report();
+    test_case_parallel_compile();
+    test_case_scratch_arena();
+    test_case_reduction();
+    test_case_parallel_for();
+    test_case_dag_check();
 }
@@ -0,0 +1,15 @@
+#include <cstdio>
+#include "tg/core/type_id.hpp"
+
+namespace tg::core
+{
+
+std::string to_string(TypeId type)
+{
+    char text[24];
+    std::snprintf(text, sizeof(text), "type#%016llx",
+        static_cast<unsigned long long>(type.value()));
+    return text;
+}
+
+} // namespace tg::core
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "tg/data/hashing/fnv1a_constexpr.hpp"
+
+namespace tg::core
+{
+
+namespace type_id_detail
+{
+
+/**
+ * @brief Returns the compiler's signature of this function, which spells
+ * out T.
+ */
+template <typename T>
+constexpr std::string_view signature()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+/**
+ * @brief Extracts the spelling of T from signature<T>().
+ * @details GCC and Clang write "[with T = name; ...]" or "[T = name]";
+ * MSVC writes "signature<name>(void)".
+ */
+constexpr std::string_view extract_name(std::string_view sig)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    constexpr std::string_view prefix = "signature<";
+    std::size_t begin = sig.find(prefix) + prefix.size();
+    std::size_t end = sig.rfind(">(void)");
+#else
+    /**
+     * @note A type spelling may contain ']', as in "int [3][4]", but never
+     * ';'. GCC ends the name at the ';' before its typedef list, if any;
+     * otherwise the name ends at the last ']'.
+     */
+    constexpr std::string_view prefix = "T = ";
+    std::size_t begin = sig.find(prefix) + prefix.size();
+    std::size_t end = sig.find(';', begin);
+    if (end == std::string_view::npos)
+    {
+        end = sig.rfind(']');
+    }
+#endif
+    return sig.substr(begin, end - begin);
+}
+
+} // namespace type_id_detail
+
+/**
+ * @brief Returns the spelling of T, as written by the compiler.
+ * @details Available without RTTI; used for diagnostics only.
+ */
+template <typename T>
+constexpr std::string_view type_name()
+{
+    return type_id_detail::extract_name(type_id_detail::signature<T>());
+}
+
+/**
+ * @brief A compile-time identifier for a type, used by the type-erased data
+ * path instead of std::type_index.
+ *
+ * @details
+ * The identifier is the FNV-1a hash (see tg::data::hashing) of the type's
+ * spelling, as given by type_name(). It does not require RTTI, compares as
+ * a single integer, and is stable across shared libraries and processes
+ * built with the same compiler. Zero denotes no type.
+ *
+ * @note Different compilers may spell a type differently, so identifiers
+ * must not be exchanged between builds from different toolchains.
+ */
+class TypeId
+{
+public:
+    constexpr TypeId() noexcept
+        : m_value{0u}
+    {
+    }
+
+    constexpr explicit TypeId(std::uint64_t value) noexcept
+        : m_value{value}
+    {
+    }
+
+    template <typename T>
+    static constexpr TypeId of() noexcept
+    {
+        return TypeId{tg::data::hashing::fnv1a_detail::fnv1a_constexpr_chars(type_name<T>())};
+    }
+
+    constexpr std::uint64_t value() const noexcept
+    {
+        return m_value;
+    }
+
+    constexpr bool is_none() const noexcept
+    {
+        return m_value == 0u;
+    }
+
+    constexpr bool operator==(TypeId other) const noexcept
+    {
+        return m_value == other.m_value;
+    }
+
+    constexpr bool operator!=(TypeId other) const noexcept
+    {
+        return m_value != other.m_value;
+    }
+
+private:
+    std::uint64_t m_value;
+};
+
+static_assert(TypeId::of<int[3][4]>() != TypeId::of<int[3][5]>(),
+    "Array types must get distinct ids.");
+static_assert(TypeId::of<int[3]>() != TypeId::of<int[3][4]>(),
+    "Array types must get distinct ids.");
+static_assert(TypeId::of<int[3]>() != TypeId::of<int>(),
+    "Array types must get distinct ids.");
+
+/**
+ * @brief Formats a TypeId for diagnostics, as "type#" and 16 hex digits.
+ */
+std::string to_string(TypeId type);
+
+} // namespace tg::core
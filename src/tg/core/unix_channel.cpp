@@ -0,0 +1,422 @@
+#include <cerrno>
+#include <cstring>
+#if defined(LINUX) || defined(MACOS)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "tg/core/unix_channel.hpp"
+
+namespace tg::core
+{
+
+#if defined(LINUX) || defined(MACOS)
+
+namespace
+{
+
+/**
+ * @brief Precedes each message on the stream.
+ */
+struct FrameHeader
+{
+    std::uint32_t type;
+    std::int32_t arg0;
+    std::int32_t arg1;
+    std::uint32_t flags;
+    std::uint64_t payload_size;
+    std::uint32_t fd_count;
+    std::uint32_t reserved;
+};
+
+constexpr std::size_t max_fds = 16u;
+
+/**
+ * @brief Upper bound on a payload, to reject a corrupted stream before
+ * allocating.
+ */
+constexpr std::uint64_t max_payload = std::uint64_t{1u} << 32u;
+
+#if defined(MSG_NOSIGNAL)
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+FrameHeader frame_header(const ChannelMessage& message)
+{
+    if (message.fds.size() > max_fds)
+    {
+        throw std::invalid_argument("UnixChannel::send(): too many file descriptors.");
+    }
+    return FrameHeader{message.type, message.arg0, message.arg1, message.flags,
+        message.payload.size(), static_cast<std::uint32_t>(message.fds.size()), 0u};
+}
+
+/**
+ * @return False if the peer closed the connection before the first byte.
+ */
+bool receive_all(int fd, char* data, std::size_t size)
+{
+    std::size_t received = 0u;
+    while (received < size)
+    {
+        ssize_t count = ::recv(fd, data + received, size - received, 0);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count == 0 && received == 0u)
+        {
+            return false;
+        }
+        if (count <= 0)
+        {
+            throw std::runtime_error("UnixChannel::receive(): connection lost.");
+        }
+        received += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+} // namespace
+
+std::pair<UnixChannelPtr, UnixChannelPtr> UnixChannel::create_pair()
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        throw std::runtime_error("UnixChannel::create_pair(): socketpair failed.");
+    }
+    return {std::make_shared<UnixChannel>(fds[0]), std::make_shared<UnixChannel>(fds[1])};
+}
+
+UnixChannelPtr UnixChannel::connect(const std::string& path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        throw std::invalid_argument("UnixChannel::connect(): path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1u);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        throw std::runtime_error("UnixChannel::connect(): cannot connect to " + path);
+    }
+    return std::make_shared<UnixChannel>(fd);
+}
+
+UnixChannel::UnixChannel(int fd)
+    : m_fd{fd}
+    , m_send_mutex{}
+    , m_posted{}
+    , m_posted_sent{0u}
+{
+}
+
+UnixChannel::~UnixChannel()
+{
+    this->close();
+}
+
+int UnixChannel::fd() const
+{
+    return m_fd;
+}
+
+void UnixChannel::close()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void UnixChannel::send(const ChannelMessage& message)
+{
+    frame_header(message);
+    std::unique_lock<std::mutex> lock(m_send_mutex);
+    this->flush_posted(true);
+    std::size_t sent = 0u;
+    this->send_frame(message, sent, true);
+}
+
+void UnixChannel::post(ChannelMessage message)
+{
+    frame_header(message);
+    std::unique_lock<std::mutex> lock(m_send_mutex);
+    m_posted.push_back(std::move(message));
+}
+
+bool UnixChannel::flush()
+{
+    std::unique_lock<std::mutex> lock(m_send_mutex);
+    return this->flush_posted(false);
+}
+
+bool UnixChannel::has_posted() const
+{
+    std::unique_lock<std::mutex> lock(m_send_mutex);
+    return !m_posted.empty();
+}
+
+bool UnixChannel::flush_posted(bool block)
+{
+    while (!m_posted.empty())
+    {
+        if (!this->send_frame(m_posted.front(), m_posted_sent, block))
+        {
+            return false;
+        }
+        m_posted.pop_front();
+        m_posted_sent = 0u;
+    }
+    return true;
+}
+
+/**
+ * @note The file descriptors travel with the first bytes of the header.
+ */
+bool UnixChannel::send_frame(const ChannelMessage& message, std::size_t& sent, bool block)
+{
+    FrameHeader header = frame_header(message);
+    const std::size_t total = sizeof(header) + message.payload.size();
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * max_fds)];
+    while (sent < total)
+    {
+        iovec iov[2];
+        int iov_count = 0;
+        if (sent < sizeof(header))
+        {
+            iov[iov_count++] = iovec{reinterpret_cast<char*>(&header) + sent, sizeof(header) - sent};
+        }
+        std::size_t payload_sent = sent > sizeof(header) ? sent - sizeof(header) : 0u;
+        if (payload_sent < message.payload.size())
+        {
+            iov[iov_count++] = iovec{const_cast<char*>(message.payload.data()) + payload_sent,
+                message.payload.size() - payload_sent};
+        }
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iov_count;
+        if (sent == 0u && !message.fds.empty())
+        {
+            std::size_t fd_bytes = sizeof(int) * message.fds.size();
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(fd_bytes);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(fd_bytes);
+            std::memcpy(CMSG_DATA(cmsg), message.fds.data(), fd_bytes);
+        }
+        ssize_t count = ::sendmsg(m_fd, &msg, send_flags | (block ? 0 : MSG_DONTWAIT));
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && !block && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return false;
+        }
+        if (count <= 0)
+        {
+            throw std::runtime_error("UnixChannel::send(): connection lost.");
+        }
+        sent += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool UnixChannel::receive(ChannelMessage& out_message)
+{
+    FrameHeader header{};
+    iovec iov{&header, sizeof(header)};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * max_fds)];
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t received;
+    do
+    {
+        received = ::recvmsg(m_fd, &msg, 0);
+    } while (received < 0 && errno == EINTR);
+    if (received == 0)
+    {
+        return false;
+    }
+    if (received < 0)
+    {
+        throw std::runtime_error("UnixChannel::receive(): connection lost.");
+    }
+    out_message.fds.clear();
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            std::size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int* fds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+            out_message.fds.insert(out_message.fds.end(), fds, fds + count);
+        }
+    }
+    char* rest = reinterpret_cast<char*>(&header) + received;
+    std::size_t rest_size = sizeof(header) - static_cast<std::size_t>(received);
+    if ((rest_size > 0u && !receive_all(m_fd, rest, rest_size)) ||
+        header.payload_size > max_payload || header.fd_count != out_message.fds.size())
+    {
+        throw std::runtime_error("UnixChannel::receive(): malformed message.");
+    }
+    out_message.type = header.type;
+    out_message.arg0 = header.arg0;
+    out_message.arg1 = header.arg1;
+    out_message.flags = header.flags;
+    out_message.payload.resize(static_cast<std::size_t>(header.payload_size));
+    if (!out_message.payload.empty() &&
+        !receive_all(m_fd, out_message.payload.data(), out_message.payload.size()))
+    {
+        throw std::runtime_error("UnixChannel::receive(): truncated message.");
+    }
+    return true;
+}
+
+UnixListener::UnixListener(const std::string& path)
+    : m_path{path}
+    , m_fd{-1}
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        throw std::invalid_argument("UnixListener: path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1u);
+    ::unlink(path.c_str());
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0 ||
+        ::bind(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(m_fd, 16) != 0)
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+        throw std::runtime_error("UnixListener: cannot listen on " + path);
+    }
+}
+
+UnixListener::~UnixListener()
+{
+    ::close(m_fd);
+    ::unlink(m_path.c_str());
+}
+
+UnixChannelPtr UnixListener::accept()
+{
+    int fd;
+    do
+    {
+        fd = ::accept(m_fd, nullptr, nullptr);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+    {
+        throw std::runtime_error("UnixListener::accept(): failed on " + m_path);
+    }
+    return std::make_shared<UnixChannel>(fd);
+}
+
+#else
+
+std::pair<UnixChannelPtr, UnixChannelPtr> UnixChannel::create_pair()
+{
+    throw not_implemented("UnixChannel::create_pair(): not available on this platform.");
+}
+
+UnixChannelPtr UnixChannel::connect(const std::string& /* path */)
+{
+    throw not_implemented("UnixChannel::connect(): not available on this platform.");
+}
+
+UnixChannel::UnixChannel(int fd)
+    : m_fd{fd}
+    , m_send_mutex{}
+    , m_posted{}
+    , m_posted_sent{0u}
+{
+}
+
+UnixChannel::~UnixChannel()
+{
+}
+
+int UnixChannel::fd() const
+{
+    return m_fd;
+}
+
+void UnixChannel::close()
+{
+}
+
+void UnixChannel::send(const ChannelMessage& /* message */)
+{
+    throw not_implemented("UnixChannel::send(): not available on this platform.");
+}
+
+void UnixChannel::post(ChannelMessage /* message */)
+{
+    throw not_implemented("UnixChannel::post(): not available on this platform.");
+}
+
+bool UnixChannel::flush()
+{
+    throw not_implemented("UnixChannel::flush(): not available on this platform.");
+}
+
+bool UnixChannel::has_posted() const
+{
+    return false;
+}
+
+bool UnixChannel::send_frame(const ChannelMessage& /* message */, std::size_t& /* sent */, bool /* block */)
+{
+    throw not_implemented("UnixChannel::send(): not available on this platform.");
+}
+
+bool UnixChannel::flush_posted(bool /* block */)
+{
+    throw not_implemented("UnixChannel::flush(): not available on this platform.");
+}
+
+bool UnixChannel::receive(ChannelMessage& /* out_message */)
+{
+    throw not_implemented("UnixChannel::receive(): not available on this platform.");
+}
+
+UnixListener::UnixListener(const std::string& path)
+    : m_path{path}
+    , m_fd{-1}
+{
+    throw not_implemented("UnixListener: not available on this platform.");
+}
+
+UnixListener::~UnixListener()
+{
+}
+
+UnixChannelPtr UnixListener::accept()
+{
+    throw not_implemented("UnixListener::accept(): not available on this platform.");
+}
+
+#endif
+
+} // namespace tg::core
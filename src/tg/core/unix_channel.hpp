@@ -0,0 +1,156 @@
+#pragma once
+#include <deque>
+#include "tg/core/fwd.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A message sent over a UnixChannel.
+ * @details The meaning of the fields is up to the protocol; see
+ * PartitionCoordinator. File descriptors are passed to the peer with
+ * SCM_RIGHTS, which duplicates them into the receiving process.
+ */
+struct ChannelMessage
+{
+    std::uint32_t type = 0u;
+    std::int32_t arg0 = 0;
+    std::int32_t arg1 = 0;
+    std::uint32_t flags = 0u;
+    std::vector<char> payload;
+    std::vector<int> fds;
+};
+
+/**
+ * @brief A bidirectional, message-framed connection over a Unix domain
+ * stream socket.
+ *
+ * @details
+ * Each message is sent as a fixed header followed by its payload. Sending
+ * is serialized by a mutex, so several threads may send on one channel;
+ * only one thread may receive. The channel owns its socket, and the
+ * received file descriptors are owned by the caller.
+ *
+ * A thread that also has to keep reading, such as one serving several
+ * channels from poll(), posts its messages instead: post() queues them, and
+ * flush() sends what the socket takes without blocking, to be called again
+ * when the socket is writable. send() sends the posted messages first.
+ *
+ * Only available on Linux and macOS.
+ */
+class UnixChannel
+{
+public:
+    /**
+     * @brief Creates two connected channels, for a parent process and the
+     * child it forks.
+     */
+    static std::pair<UnixChannelPtr, UnixChannelPtr> create_pair();
+
+    /**
+     * @brief Connects to a UnixListener.
+     * @throws std::runtime_error on failure.
+     */
+    static UnixChannelPtr connect(const std::string& path);
+
+    /**
+     * @param fd A connected stream socket, which the channel takes over.
+     */
+    explicit UnixChannel(int fd);
+    ~UnixChannel();
+
+    int fd() const;
+
+    /**
+     * @throws std::runtime_error if the peer is gone.
+     */
+    void send(const ChannelMessage& message);
+
+    /**
+     * @brief Queues a message, to be sent by flush() or send().
+     * @details The file descriptors of the message must stay open until it
+     * has been sent.
+     */
+    void post(ChannelMessage message);
+
+    /**
+     * @brief Sends as much of the posted messages as the socket takes
+     * without blocking.
+     * @return True if every posted message has been sent.
+     * @throws std::runtime_error if the peer is gone.
+     */
+    bool flush();
+
+    /**
+     * @brief Whether posted messages are waiting to be sent.
+     */
+    bool has_posted() const;
+
+    /**
+     * @brief Receives the next message, blocking until it arrives.
+     * @return False if the peer has closed the connection.
+     * @throws std::runtime_error on a broken or malformed stream.
+     */
+    bool receive(ChannelMessage& out_message);
+
+    /**
+     * @brief Closes the socket in this process; once no process holds it,
+     * a blocked receive() of the peer returns false.
+     * @note Does not shut the connection down, so that a process can close
+     * the end it handed over to a forked child.
+     */
+    void close();
+
+private:
+    UnixChannel(const UnixChannel&) = delete;
+    UnixChannel& operator=(const UnixChannel&) = delete;
+    UnixChannel(UnixChannel&&) = delete;
+    UnixChannel& operator=(UnixChannel&&) = delete;
+
+private:
+    /**
+     * @brief Sends a message from byte @p sent of its frame.
+     * @return False if the socket would block, which only happens if
+     * @p block is false. @p sent is advanced in either case.
+     */
+    bool send_frame(const ChannelMessage& message, std::size_t& sent, bool block);
+    bool flush_posted(bool block);
+
+private:
+    int m_fd;
+    mutable std::mutex m_send_mutex;
+    std::deque<ChannelMessage> m_posted;  ///< Guarded by m_send_mutex.
+    std::size_t m_posted_sent;  ///< Bytes of the first posted frame already sent; guarded by m_send_mutex.
+};
+
+/**
+ * @brief Accepts UnixChannel connections on a socket path.
+ */
+class UnixListener
+{
+public:
+    /**
+     * @details An existing socket file at @p path is replaced.
+     * @throws std::runtime_error on failure.
+     */
+    explicit UnixListener(const std::string& path);
+
+    /**
+     * @details Removes the socket file.
+     */
+    ~UnixListener();
+
+    UnixChannelPtr accept();
+
+private:
+    UnixListener(const UnixListener&) = delete;
+    UnixListener& operator=(const UnixListener&) = delete;
+    UnixListener(UnixListener&&) = delete;
+    UnixListener& operator=(UnixListener&&) = delete;
+
+private:
+    std::string m_path;
+    int m_fd;
+};
+
+} // namespace tg::core
@@ -0,0 +1,373 @@
+#include <algorithm>
+#if defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "tg/core/worker_pool.hpp"
+
+namespace tg::core
+{
+
+namespace
+{
+
+thread_local const WorkerPool* tl_pool = nullptr;
+thread_local int tl_worker = -1;
+
+/**
+ * @brief Orders CPUs round-robin across NUMA nodes.
+ */
+std::vector<std::pair<int, int>> interleave_cpus(const CpuTopology& topology)
+{
+    std::vector<std::pair<int, int>> result;
+    const auto& nodes = topology.nodes();
+    for (std::size_t k = 0u; result.size() < topology.cpu_count(); ++k)
+    {
+        for (const auto& node : nodes)
+        {
+            if (k < node.cpus.size())
+            {
+                result.emplace_back(node.cpus[k], node.id);
+            }
+        }
+    }
+    return result;
+}
+
+void pin_current_thread(int cpu)
+{
+#if defined(LINUX)
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+struct WorkerPool::Worker
+{
+    std::mutex mutex;
+    std::deque<WorkItem> queue;
+    std::deque<WorkItem> pinned;  ///< Never stolen; run in FIFO order.
+    std::atomic<std::size_t> pinned_count{0u};
+    int cpu = -1;
+    int numa_node = 0;
+
+    /**
+     * @brief Steal order: workers on the same NUMA node first, then the rest.
+     */
+    std::vector<std::size_t> victims;
+
+    std::thread thread;
+};
+
+WorkerPool::WorkerPool(const WorkerPoolOptions& options)
+    : m_topology{options.topology ? *options.topology : CpuTopology::detect()}
+    , m_workers{}
+    , m_queued{0u}
+    , m_sleepers{0u}
+    , m_next_external{0u}
+    , m_submitting{0u}
+    , m_stop{false}
+    , m_sleep_mutex{}
+    , m_sleep_cv{}
+{
+    auto cpus = interleave_cpus(m_topology);
+    std::size_t count = options.num_workers ? options.num_workers : cpus.size();
+    count = std::max<std::size_t>(count, 1u);
+    for (std::size_t k = 0u; k < count; ++k)
+    {
+        auto worker = std::make_unique<Worker>();
+        if (!cpus.empty())
+        {
+            const auto& cpu_node = cpus[k % cpus.size()];
+            worker->cpu = options.pin_threads ? cpu_node.first : -1;
+            worker->numa_node = cpu_node.second;
+        }
+        m_workers.emplace_back(std::move(worker));
+    }
+    for (std::size_t k = 0u; k < count; ++k)
+    {
+        auto& victims = m_workers[k]->victims;
+        for (int remote = 0; remote < 2; ++remote)
+        {
+            for (std::size_t step = 1u; step < count; ++step)
+            {
+                std::size_t other = (k + step) % count;
+                bool same_node = (m_workers[other]->numa_node == m_workers[k]->numa_node);
+                if (same_node != static_cast<bool>(remote))
+                {
+                    victims.push_back(other);
+                }
+            }
+        }
+    }
+    for (std::size_t k = 0u; k < count; ++k)
+    {
+        m_workers[k]->thread = std::thread([this, k]() { this->worker_main(k); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_stop.store(true);
+    }
+    m_sleep_cv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker->thread.join();
+    }
+    /**
+     * @note A thread outside of the pool, such as an I/O thread completing
+     * an AsyncTask, may still be returning from submit() after its item
+     * has already been run.
+     */
+    while (m_submitting.load(std::memory_order_acquire) != 0u)
+    {
+        std::this_thread::yield();
+    }
+}
+
+std::size_t WorkerPool::size() const
+{
+    return m_workers.size();
+}
+
+const CpuTopology& WorkerPool::topology() const
+{
+    return m_topology;
+}
+
+int WorkerPool::numa_node_of(std::size_t worker) const
+{
+    return m_workers.at(worker)->numa_node;
+}
+
+int WorkerPool::cpu_of(std::size_t worker) const
+{
+    return m_workers.at(worker)->cpu;
+}
+
+int WorkerPool::current_worker() const
+{
+    return (tl_pool == this) ? tl_worker : -1;
+}
+
+void WorkerPool::submit(const WorkItem& item, int preferred_worker)
+{
+    if (!item.function)
+    {
+        throw std::invalid_argument("WorkerPool::submit(): work item has no function.");
+    }
+    std::size_t count = m_workers.size();
+    std::size_t target;
+    if (preferred_worker >= 0 && static_cast<std::size_t>(preferred_worker) < count)
+    {
+        target = static_cast<std::size_t>(preferred_worker);
+    }
+    else if (this->current_worker() >= 0)
+    {
+        target = static_cast<std::size_t>(this->current_worker());
+    }
+    else
+    {
+        target = m_next_external.fetch_add(1u, std::memory_order_relaxed) % count;
+    }
+    this->push(target, item, false);
+}
+
+void WorkerPool::submit_pinned(const WorkItem& item, std::size_t worker)
+{
+    if (!item.function)
+    {
+        throw std::invalid_argument("WorkerPool::submit_pinned(): work item has no function.");
+    }
+    if (worker >= m_workers.size())
+    {
+        throw std::out_of_range("WorkerPool::submit_pinned(): invalid worker.");
+    }
+    this->push(worker, item, true);
+}
+
+void WorkerPool::push(std::size_t target, const WorkItem& item, bool pinned)
+{
+    m_submitting.fetch_add(1u, std::memory_order_relaxed);
+    auto& worker = *m_workers[target];
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        (pinned ? worker.pinned : worker.queue).push_back(item);
+    }
+    (pinned ? worker.pinned_count : m_queued).fetch_add(1u);
+    if (m_sleepers.load() > 0u)
+    {
+        /**
+         * @note Acquiring the sleep mutex orders this notification after any
+         * worker that has checked m_queued but has not started waiting yet.
+         * A pinned item must wake its own worker, so all sleepers are woken.
+         */
+        { std::unique_lock<std::mutex> lock(m_sleep_mutex); }
+        if (pinned)
+        {
+            m_sleep_cv.notify_all();
+        }
+        else
+        {
+            m_sleep_cv.notify_one();
+        }
+    }
+    m_submitting.fetch_sub(1u, std::memory_order_release);
+}
+
+bool WorkerPool::try_run_one(const void* context)
+{
+    WorkItem item{};
+    bool found = false;
+    int self = this->current_worker();
+    if (self >= 0)
+    {
+        std::size_t index = static_cast<std::size_t>(self);
+        auto& worker = *m_workers[index];
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if (!worker.pinned.empty() && worker.pinned.front().context == context)
+            {
+                item = worker.pinned.front();
+                worker.pinned.pop_front();
+                lock.unlock();
+                worker.pinned_count.fetch_sub(1u);
+                item.function(item.context, item.index);
+                return true;
+            }
+        }
+        found = this->try_take_matching(index, context, item);
+        for (std::size_t k = 0u; !found && k < m_workers[index]->victims.size(); ++k)
+        {
+            found = this->try_take_matching(m_workers[index]->victims[k], context, item);
+        }
+    }
+    else
+    {
+        for (std::size_t k = 0u; !found && k < m_workers.size(); ++k)
+        {
+            found = this->try_take_matching(k, context, item);
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+    m_queued.fetch_sub(1u);
+    item.function(item.context, item.index);
+    return true;
+}
+
+bool WorkerPool::try_take_matching(std::size_t index, const void* context, WorkItem& out_item)
+{
+    auto& worker = *m_workers[index];
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    for (auto iter = worker.queue.rbegin(); iter != worker.queue.rend(); ++iter)
+    {
+        if (iter->context == context)
+        {
+            out_item = *iter;
+            worker.queue.erase(std::next(iter).base());
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::worker_main(std::size_t index)
+{
+    tl_pool = this;
+    tl_worker = static_cast<int>(index);
+    pin_current_thread(m_workers[index]->cpu);
+    auto& self = *m_workers[index];
+    while (true)
+    {
+        WorkItem item{};
+        if (this->try_pop_pinned(index, item))
+        {
+            item.function(item.context, item.index);
+            continue;
+        }
+        if (this->try_pop(index, item) || this->try_steal(index, item))
+        {
+            m_queued.fetch_sub(1u);
+            item.function(item.context, item.index);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleepers.fetch_add(1u);
+        m_sleep_cv.wait(lock, [this, &self]()
+            { return m_stop.load() || m_queued.load() > 0u || self.pinned_count.load() > 0u; });
+        m_sleepers.fetch_sub(1u);
+        if (m_stop.load() && m_queued.load() == 0u && self.pinned_count.load() == 0u)
+        {
+            break;
+        }
+    }
+    tl_pool = nullptr;
+    tl_worker = -1;
+}
+
+bool WorkerPool::try_pop_pinned(std::size_t index, WorkItem& out_item)
+{
+    auto& worker = *m_workers[index];
+    if (worker.pinned_count.load() == 0u)
+    {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        if (worker.pinned.empty())
+        {
+            return false;
+        }
+        out_item = worker.pinned.front();
+        worker.pinned.pop_front();
+    }
+    worker.pinned_count.fetch_sub(1u);
+    return true;
+}
+
+bool WorkerPool::try_pop(std::size_t index, WorkItem& out_item)
+{
+    auto& worker = *m_workers[index];
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty())
+    {
+        return false;
+    }
+    out_item = worker.queue.back();
+    worker.queue.pop_back();
+    return true;
+}
+
+bool WorkerPool::try_steal(std::size_t index, WorkItem& out_item)
+{
+    for (std::size_t victim : m_workers[index]->victims)
+    {
+        auto& worker = *m_workers[victim];
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        if (!worker.queue.empty())
+        {
+            out_item = worker.queue.front();
+            worker.queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace tg::core
@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include "tg/core/fwd.hpp"
+#include "tg/core/cpu_topology.hpp"
+
+namespace tg::core
+{
+
+/**
+ * @brief A unit of work for the WorkerPool.
+ *
+ * @details
+ * WorkItem is a plain function pointer with a context pointer and an index,
+ * so that submitting work does not allocate. The context is owned by the
+ * submitter, and must outlive the execution of the item. The function must
+ * not throw.
+ */
+struct WorkItem
+{
+    using Function = void (*)(void* context, std::size_t index);
+    Function function;
+    void* context;
+    std::size_t index;
+};
+
+struct WorkerPoolOptions
+{
+    /**
+     * @brief Number of worker threads. Zero means one per available CPU.
+     */
+    std::size_t num_workers = 0u;
+
+    /**
+     * @brief Pins each worker thread to one logical CPU.
+     * @details Pinning is required for NUMA locality to be meaningful: with
+     * Linux's default first-touch policy, a buffer allocated by a pinned
+     * worker is placed on that worker's NUMA node.
+     */
+    bool pin_threads = false;
+
+    /**
+     * @brief CPU topology to use. Detected from the machine if not given.
+     */
+    std::optional<CpuTopology> topology;
+};
+
+/**
+ * @brief A pool of worker threads grouped by NUMA node.
+ *
+ * @details
+ * Each worker owns a queue. Work submitted with a preferred worker is placed
+ * on that worker's queue; the owner pops its most recent item first, to
+ * reuse whatever it has just produced while it is still in cache. Idle
+ * workers steal the oldest items, first from workers on the same NUMA node,
+ * then from remote nodes.
+ *
+ * Workers are assigned to CPUs round-robin across NUMA nodes, so that a
+ * pool smaller than the machine still spans all nodes.
+ */
+class WorkerPool
+{
+public:
+    explicit WorkerPool(const WorkerPoolOptions& options = WorkerPoolOptions{});
+    ~WorkerPool();
+
+    std::size_t size() const;
+
+    const CpuTopology& topology() const;
+
+    /**
+     * @brief NUMA node id of a worker.
+     */
+    int numa_node_of(std::size_t worker) const;
+
+    /**
+     * @brief Logical CPU of a worker, or -1 if the worker is not pinned.
+     */
+    int cpu_of(std::size_t worker) const;
+
+    /**
+     * @brief Index of the calling thread in this pool, or -1 if the calling
+     * thread is not a worker of this pool.
+     */
+    int current_worker() const;
+
+    /**
+     * @brief Submits a work item.
+     * @param preferred_worker The worker whose queue receives the item, or
+     * -1 to let the pool choose. If called from a worker of this pool, the
+     * default is the calling worker.
+     */
+    void submit(const WorkItem& item, int preferred_worker = -1);
+
+    /**
+     * @brief Submits a work item that only @p worker may run.
+     * @details Pinned items are never stolen, and a worker runs its pinned
+     * items in submission order, before its other work. Used to replay a
+     * recorded schedule.
+     */
+    void submit_pinned(const WorkItem& item, std::size_t worker);
+
+    /**
+     * @brief Runs one queued work item whose context is @p context, on the
+     * calling thread.
+     * @details Used by a thread that waits for a group of work items, such
+     * as a nested graph run, to help execute them instead of blocking.
+     * Only items of that group are taken, so the wait is never extended by
+     * unrelated work. The calling worker's own queue is searched first, then
+     * the other queues in steal order.
+     * @return Whether an item was run.
+     */
+    bool try_run_one(const void* context);
+
+private:
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+private:
+    struct Worker;
+
+    void worker_main(std::size_t index);
+    void push(std::size_t target, const WorkItem& item, bool pinned);
+    bool try_pop_pinned(std::size_t index, WorkItem& out_item);
+    bool try_pop(std::size_t index, WorkItem& out_item);
+    bool try_steal(std::size_t index, WorkItem& out_item);
+    bool try_take_matching(std::size_t index, const void* context, WorkItem& out_item);
+
+private:
+    CpuTopology m_topology;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_queued;  ///< Items that any worker may run.
+    std::atomic<std::size_t> m_sleepers;
+    std::atomic<std::size_t> m_next_external;
+    std::atomic<std::size_t> m_submitting;  ///< Threads currently inside submit().
+    std::atomic<bool> m_stop;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cv;
+};
+
+} // namespace tg::core
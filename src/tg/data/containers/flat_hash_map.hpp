@@ -0,0 +1,94 @@
+#pragma once
+#include <stdexcept>
+#include "tg/data/containers/flat_hash_table.hpp"
+
+namespace tg::data::containers
+{
+
+namespace flat_hash_detail
+{
+
+template <typename K, typename V>
+struct MapPolicy
+{
+    using key_type = K;
+    using value_type = std::pair<K, V>;
+
+    static const key_type& key(const value_type& value) { return value.first; }
+};
+
+} // namespace flat_hash_detail
+
+/**
+ * @brief A hash map stored in one flat array; see FlatHashTable.
+ * @details The entries are std::pair<K, V>, in place of the
+ * std::pair<const K, V> of std::unordered_map, so that they can be moved
+ * when the table grows. The key of an entry must not be modified.
+ */
+template <typename K, typename V, typename Hash = hashing::StdHasher, typename Eq = std::equal_to<>>
+class FlatHashMap : public FlatHashTable<flat_hash_detail::MapPolicy<K, V>, Hash, Eq>
+{
+private:
+    using Base = FlatHashTable<flat_hash_detail::MapPolicy<K, V>, Hash, Eq>;
+
+public:
+    using mapped_type = V;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    /**
+     * @brief Inserts an entry for @p key with the value constructed from
+     * @p args, unless @p key is present, in which case nothing is
+     * constructed.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    V& operator[](const K& key)
+    {
+        return this->try_emplace(key).first->second;
+    }
+
+    V& operator[](K&& key)
+    {
+        return this->try_emplace(std::move(key)).first->second;
+    }
+
+    /**
+     * @throws std::out_of_range if @p key is not present.
+     */
+    template <typename Q>
+    V& at(const Q& key)
+    {
+        auto iter = this->find(key);
+        if (iter == this->end())
+        {
+            throw std::out_of_range("FlatHashMap::at(): key not found.");
+        }
+        return iter->second;
+    }
+
+    template <typename Q>
+    const V& at(const Q& key) const
+    {
+        auto iter = this->find(key);
+        if (iter == this->end())
+        {
+            throw std::out_of_range("FlatHashMap::at(): key not found.");
+        }
+        return iter->second;
+    }
+};
+
+} // namespace tg::data::containers
@@ -0,0 +1,59 @@
+#pragma once
+#include <initializer_list>
+#include "tg/data/containers/flat_hash_table.hpp"
+
+namespace tg::data::containers
+{
+
+namespace flat_hash_detail
+{
+
+template <typename K>
+struct SetPolicy
+{
+    using key_type = K;
+    using value_type = K;
+
+    static const key_type& key(const value_type& value) { return value; }
+};
+
+} // namespace flat_hash_detail
+
+/**
+ * @brief A hash set stored in one flat array; see FlatHashTable.
+ * @details Iteration only gives const access, since modifying an element
+ * would change its hash.
+ */
+template <typename K, typename Hash = hashing::StdHasher, typename Eq = std::equal_to<>>
+class FlatHashSet : public FlatHashTable<flat_hash_detail::SetPolicy<K>, Hash, Eq>
+{
+private:
+    using Base = FlatHashTable<flat_hash_detail::SetPolicy<K>, Hash, Eq>;
+
+public:
+    using iterator = typename Base::const_iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    FlatHashSet() = default;
+
+    FlatHashSet(std::initializer_list<K> values)
+        : Base()
+    {
+        this->reserve(values.size());
+        for (const auto& value : values)
+        {
+            this->insert(value);
+        }
+    }
+
+    const_iterator begin() const { return Base::begin(); }
+    const_iterator end() const { return Base::end(); }
+
+    template <typename Q>
+    const_iterator find(const Q& key) const
+    {
+        return Base::find(key);
+    }
+};
+
+} // namespace tg::data::containers
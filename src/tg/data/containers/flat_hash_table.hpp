@@ -0,0 +1,664 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "common/project_macros.hpp"
+#include "tg/data/hashing/hashers.hpp"
+
+namespace tg::data::containers
+{
+
+namespace flat_hash_detail
+{
+
+/**
+ * @brief The control byte of a slot: empty, deleted, or full with the low
+ * 7 bits of the hash of its key (always non-negative).
+ */
+using ctrl_t = int8_t;
+
+constexpr ctrl_t ctrl_empty = -128;
+constexpr ctrl_t ctrl_deleted = -2;
+
+/**
+ * @brief Number of slots probed at once; the capacity is a multiple of it.
+ */
+constexpr std::size_t group_width = 16u;
+
+/**
+ * @brief Sixteen control bytes, compared against a byte in one step.
+ * @details With SSE2 a comparison is a single pcmpeqb and pmovmskb; the
+ * portable fallback loops over the bytes, which compilers usually
+ * vectorize. A match is returned as a bit mask, bit k for slot k.
+ */
+class Group
+{
+public:
+    explicit Group(const ctrl_t* pos)
+    {
+#if defined(__SSE2__)
+        m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+#else
+        std::memcpy(m_ctrl, pos, group_width);
+#endif
+    }
+
+    uint32_t INLINE_ALWAYS match(ctrl_t value) const
+    {
+#if defined(__SSE2__)
+        return static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), m_ctrl)));
+#else
+        uint32_t bits = 0u;
+        for (std::size_t k = 0u; k < group_width; ++k)
+        {
+            bits |= static_cast<uint32_t>(m_ctrl[k] == value) << k;
+        }
+        return bits;
+#endif
+    }
+
+    uint32_t INLINE_ALWAYS match_empty() const
+    {
+        return this->match(ctrl_empty);
+    }
+
+    /**
+     * @details Empty and deleted are the only negative control bytes.
+     */
+    uint32_t INLINE_ALWAYS match_free() const
+    {
+#if defined(__SSE2__)
+        return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+#else
+        uint32_t bits = 0u;
+        for (std::size_t k = 0u; k < group_width; ++k)
+        {
+            bits |= static_cast<uint32_t>(m_ctrl[k] < 0) << k;
+        }
+        return bits;
+#endif
+    }
+
+private:
+#if defined(__SSE2__)
+    __m128i m_ctrl;
+#else
+    ctrl_t m_ctrl[group_width];
+#endif
+};
+
+inline std::size_t INLINE_ALWAYS lowest_bit(uint32_t bits)
+{
+    return static_cast<std::size_t>(__builtin_ctz(bits));
+}
+
+/**
+ * @brief Maximum number of entries plus deleted slots for a capacity: a
+ * load factor of 7/8.
+ */
+constexpr std::size_t max_load(std::size_t capacity)
+{
+    return capacity - capacity / 8u;
+}
+
+} // namespace flat_hash_detail
+
+/**
+ * @brief An open-addressing hash table, the storage of FlatHashMap and
+ * FlatHashSet.
+ *
+ * @details
+ * Entries are stored inline in one array of slots, with a parallel array
+ * of one control byte per slot, in the style of the SwissTable. The hash of
+ * a key is mixed, then split into h1, which selects the group of 16 slots
+ * where probing starts, and h2, its low 7 bits, which is stored in the
+ * control byte. A lookup compares h2 against the 16 control bytes of a
+ * group at once and only compares the keys of the matching slots; it stops
+ * at the first group with an empty slot. Groups are probed in triangular
+ * order, which visits every group since their number is a power of two.
+ *
+ * The load factor is kept under 7/8, counting deleted slots. An erased
+ * slot becomes empty again if its group still has an empty slot, since no
+ * probe can have passed that group; otherwise it is marked deleted until
+ * the next rehash.
+ *
+ * Inserting may rehash, which invalidates iterators and references.
+ * Entries are moved by move construction only, so types without
+ * assignment, such as facade::DataName, can be stored.
+ *
+ * The hasher and the equality may be transparent (see
+ * hashing::StdHasher and std::equal_to<>), so that lookups accept any
+ * type that both of them accept, such as a std::string_view for a
+ * std::string key.
+ *
+ * @tparam Policy Defines key_type, value_type, and key(value), which
+ * extracts the key of an entry.
+ */
+template <typename Policy, typename Hash, typename Eq>
+class FlatHashTable
+{
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+
+private:
+    using ctrl_t = flat_hash_detail::ctrl_t;
+    static constexpr size_type npos = ~size_type{0u};
+
+public:
+    template <bool is_const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatHashTable::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<is_const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+
+        Iterator() : m_ctrl{nullptr}, m_end{nullptr}, m_slot{nullptr} {}
+
+        /**
+         * @brief Converts an iterator to a const_iterator.
+         */
+        template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+        Iterator(const Iterator<other_const>& other)
+            : m_ctrl{other.m_ctrl}
+            , m_end{other.m_end}
+            , m_slot{other.m_slot}
+        {
+        }
+
+        reference operator*() const { return *m_slot; }
+        pointer operator->() const { return m_slot; }
+
+        Iterator& operator++()
+        {
+            ++m_ctrl;
+            ++m_slot;
+            this->skip_free();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator result = *this;
+            ++(*this);
+            return result;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.m_ctrl == rhs.m_ctrl; }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.m_ctrl != rhs.m_ctrl; }
+
+    private:
+        friend class FlatHashTable;
+        friend class Iterator<!is_const>;
+
+        Iterator(const ctrl_t* ctrl, const ctrl_t* end, pointer slot)
+            : m_ctrl{ctrl}
+            , m_end{end}
+            , m_slot{slot}
+        {
+        }
+
+        void skip_free()
+        {
+            while (m_ctrl != m_end && *m_ctrl < 0)
+            {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+        const ctrl_t* m_ctrl;
+        const ctrl_t* m_end;
+        pointer m_slot;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    FlatHashTable()
+        : m_ctrl{nullptr}
+        , m_slots{nullptr}
+        , m_capacity{0u}
+        , m_size{0u}
+        , m_growth_left{0u}
+        , m_hash{}
+        , m_eq{}
+    {
+    }
+
+    FlatHashTable(const FlatHashTable& other)
+        : FlatHashTable()
+    {
+        if (other.m_size == 0u)
+        {
+            return;
+        }
+        this->reserve(other.m_size);
+        for (const auto& value : other)
+        {
+            size_type hash = this->hash_of(Policy::key(value));
+            this->construct_at(this->find_free(hash), hash, value);
+        }
+    }
+
+    FlatHashTable(FlatHashTable&& other) noexcept
+        : FlatHashTable()
+    {
+        this->swap(other);
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            FlatHashTable copy{other};
+            this->swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept
+    {
+        FlatHashTable moved{std::move(other)};
+        this->swap(moved);
+        return *this;
+    }
+
+    ~FlatHashTable()
+    {
+        this->destroy_all();
+        this->deallocate();
+    }
+
+    void swap(FlatHashTable& other) noexcept
+    {
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growth_left, other.m_growth_left);
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_eq, other.m_eq);
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0u; }
+    size_type capacity() const { return m_capacity; }
+
+    iterator begin() { return this->make_iterator<false>(0u); }
+    iterator end() { return this->make_iterator<false>(m_capacity); }
+    const_iterator begin() const { return this->make_iterator<true>(0u); }
+    const_iterator end() const { return this->make_iterator<true>(m_capacity); }
+    const_iterator cbegin() const { return this->begin(); }
+    const_iterator cend() const { return this->end(); }
+
+    /**
+     * @brief Destroys all entries; keeps the capacity.
+     */
+    void clear()
+    {
+        this->destroy_all();
+        if (m_capacity != 0u)
+        {
+            std::memset(m_ctrl, static_cast<unsigned char>(flat_hash_detail::ctrl_empty), m_capacity);
+        }
+        m_size = 0u;
+        m_growth_left = flat_hash_detail::max_load(m_capacity);
+    }
+
+    /**
+     * @brief Makes room for @p count entries without rehashing.
+     */
+    void reserve(size_type count)
+    {
+        size_type capacity = flat_hash_detail::group_width;
+        while (flat_hash_detail::max_load(capacity) < count)
+        {
+            capacity *= 2u;
+        }
+        if (capacity > m_capacity)
+        {
+            this->rehash(capacity);
+        }
+    }
+
+    template <typename Q>
+    iterator find(const Q& key)
+    {
+        return this->make_iterator<false>(this->find_index(key));
+    }
+
+    template <typename Q>
+    const_iterator find(const Q& key) const
+    {
+        return this->make_iterator<true>(this->find_index(key));
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const
+    {
+        return this->find_index(key) != m_capacity;
+    }
+
+    template <typename Q>
+    size_type count(const Q& key) const
+    {
+        return this->contains(key) ? 1u : 0u;
+    }
+
+    /**
+     * @brief Inserts a copy of @p value unless its key is present.
+     * @return The entry with that key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return this->emplace_key(Policy::key(value), value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        const key_type& key = Policy::key(value);
+        return this->emplace_key(key, std::move(value));
+    }
+
+    /**
+     * @brief Inserts an entry constructed from @p args unless its key is
+     * present.
+     * @details The entry is constructed first, to find its key.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        value_type value(std::forward<Args>(args)...);
+        return this->insert(std::move(value));
+    }
+
+    /**
+     * @brief Removes the entry with @p key, if present.
+     * @return The number of entries removed.
+     */
+    template <typename Q>
+    size_type erase(const Q& key)
+    {
+        size_type index = this->find_index(key);
+        if (index == m_capacity)
+        {
+            return 0u;
+        }
+        this->erase_at(index);
+        return 1u;
+    }
+
+    /**
+     * @return The iterator following @p pos.
+     */
+    iterator erase(const_iterator pos)
+    {
+        size_type index = static_cast<size_type>(pos.m_ctrl - m_ctrl);
+        this->erase_at(index);
+        return this->make_iterator<false>(index);
+    }
+
+    iterator erase(iterator pos)
+    {
+        return this->erase(const_iterator{pos});
+    }
+
+protected:
+    /**
+     * @brief Inserts an entry constructed from @p args unless @p key is
+     * present; the entry must have that key.
+     */
+    template <typename Q, typename... Args>
+    std::pair<iterator, bool> emplace_key(const Q& key, Args&&... args)
+    {
+        size_type hash = this->hash_of(key);
+        auto [index, found] = this->find_or_prepare_insert(key, hash);
+        if (!found)
+        {
+            this->construct_at(index, hash, std::forward<Args>(args)...);
+        }
+        return {this->make_iterator<false>(index), !found};
+    }
+
+    template <typename Q>
+    size_type find_index(const Q& key) const
+    {
+        if (m_size == 0u)
+        {
+            return m_capacity;
+        }
+        size_type hash = this->hash_of(key);
+        ctrl_t h2 = this->h2_of(hash);
+        size_type group_mask = m_capacity / flat_hash_detail::group_width - 1u;
+        size_type group = this->h1_of(hash) & group_mask;
+        for (size_type step = 1u; ; ++step)
+        {
+            size_type base = group * flat_hash_detail::group_width;
+            flat_hash_detail::Group ctrl{m_ctrl + base};
+            for (uint32_t bits = ctrl.match(h2); bits != 0u; bits &= bits - 1u)
+            {
+                size_type index = base + flat_hash_detail::lowest_bit(bits);
+                if (m_eq(Policy::key(m_slots[index]), key))
+                {
+                    return index;
+                }
+            }
+            if (ctrl.match_empty() != 0u)
+            {
+                return m_capacity;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+private:
+    template <typename Q>
+    size_type hash_of(const Q& key) const
+    {
+        return static_cast<size_type>(hashing::mix_64(static_cast<uint64_t>(m_hash(key))));
+    }
+
+    static size_type h1_of(size_type hash) { return hash >> 7u; }
+    static ctrl_t h2_of(size_type hash) { return static_cast<ctrl_t>(hash & 0x7fu); }
+
+    template <bool is_const>
+    Iterator<is_const> make_iterator(size_type index) const
+    {
+        Iterator<is_const> iter{m_ctrl + index, m_ctrl + m_capacity, m_slots + index};
+        iter.skip_free();
+        return iter;
+    }
+
+    /**
+     * @return The slot of @p key and true, or else a free slot to insert it
+     * into and false, after growing the table if needed.
+     */
+    template <typename Q>
+    std::pair<size_type, bool> find_or_prepare_insert(const Q& key, size_type hash)
+    {
+        size_type free = npos;
+        if (m_capacity != 0u)
+        {
+            ctrl_t h2 = this->h2_of(hash);
+            size_type group_mask = m_capacity / flat_hash_detail::group_width - 1u;
+            size_type group = this->h1_of(hash) & group_mask;
+            for (size_type step = 1u; ; ++step)
+            {
+                size_type base = group * flat_hash_detail::group_width;
+                flat_hash_detail::Group ctrl{m_ctrl + base};
+                for (uint32_t bits = ctrl.match(h2); bits != 0u; bits &= bits - 1u)
+                {
+                    size_type index = base + flat_hash_detail::lowest_bit(bits);
+                    if (m_eq(Policy::key(m_slots[index]), key))
+                    {
+                        return {index, true};
+                    }
+                }
+                uint32_t free_bits = ctrl.match_free();
+                if (free == npos && free_bits != 0u)
+                {
+                    free = base + flat_hash_detail::lowest_bit(free_bits);
+                }
+                if (ctrl.match_empty() != 0u)
+                {
+                    break;
+                }
+                group = (group + step) & group_mask;
+            }
+        }
+        if (free == npos || (m_growth_left == 0u && m_ctrl[free] == flat_hash_detail::ctrl_empty))
+        {
+            this->grow();
+            free = this->find_free(hash);
+        }
+        return {free, false};
+    }
+
+    /**
+     * @brief Finds the first free slot on the probe sequence of @p hash.
+     */
+    size_type find_free(size_type hash) const
+    {
+        size_type group_mask = m_capacity / flat_hash_detail::group_width - 1u;
+        size_type group = this->h1_of(hash) & group_mask;
+        for (size_type step = 1u; ; ++step)
+        {
+            size_type base = group * flat_hash_detail::group_width;
+            uint32_t free_bits = flat_hash_detail::Group{m_ctrl + base}.match_free();
+            if (free_bits != 0u)
+            {
+                return base + flat_hash_detail::lowest_bit(free_bits);
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    template <typename... Args>
+    void construct_at(size_type index, size_type hash, Args&&... args)
+    {
+        ::new (static_cast<void*>(m_slots + index)) value_type(std::forward<Args>(args)...);
+        if (m_ctrl[index] == flat_hash_detail::ctrl_empty)
+        {
+            --m_growth_left;
+        }
+        m_ctrl[index] = this->h2_of(hash);
+        ++m_size;
+    }
+
+    void erase_at(size_type index)
+    {
+        m_slots[index].~value_type();
+        --m_size;
+        size_type base = index & ~(flat_hash_detail::group_width - 1u);
+        if (flat_hash_detail::Group{m_ctrl + base}.match_empty() != 0u)
+        {
+            m_ctrl[index] = flat_hash_detail::ctrl_empty;
+            ++m_growth_left;
+        }
+        else
+        {
+            m_ctrl[index] = flat_hash_detail::ctrl_deleted;
+        }
+    }
+
+    /**
+     * @details Doubles the capacity, unless deleted slots take up most of
+     * the load, in which case rehashing in place reclaims them.
+     */
+    void grow()
+    {
+        if (m_capacity == 0u)
+        {
+            this->rehash(flat_hash_detail::group_width);
+        }
+        else if (m_size * 2u <= flat_hash_detail::max_load(m_capacity))
+        {
+            this->rehash(m_capacity);
+        }
+        else
+        {
+            this->rehash(m_capacity * 2u);
+        }
+    }
+
+    void rehash(size_type capacity)
+    {
+        ctrl_t* old_ctrl = m_ctrl;
+        value_type* old_slots = m_slots;
+        size_type old_capacity = m_capacity;
+        m_ctrl = new ctrl_t[capacity];
+        m_slots = std::allocator<value_type>{}.allocate(capacity);
+        m_capacity = capacity;
+        std::memset(m_ctrl, static_cast<unsigned char>(flat_hash_detail::ctrl_empty), capacity);
+        m_growth_left = flat_hash_detail::max_load(capacity);
+        m_size = 0u;
+        for (size_type index = 0u; index < old_capacity; ++index)
+        {
+            if (old_ctrl[index] >= 0)
+            {
+                value_type& value = old_slots[index];
+                size_type hash = this->hash_of(Policy::key(value));
+                this->construct_at(this->find_free(hash), hash, std::move(value));
+                value.~value_type();
+            }
+        }
+        if (old_ctrl)
+        {
+            delete[] old_ctrl;
+            std::allocator<value_type>{}.deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void destroy_all()
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+            for (size_type index = 0u; index < m_capacity; ++index)
+            {
+                if (m_ctrl[index] >= 0)
+                {
+                    m_slots[index].~value_type();
+                }
+            }
+        }
+    }
+
+    void deallocate()
+    {
+        if (m_ctrl)
+        {
+            delete[] m_ctrl;
+            std::allocator<value_type>{}.deallocate(m_slots, m_capacity);
+        }
+    }
+
+private:
+    ctrl_t* m_ctrl;  ///< One per slot.
+    value_type* m_slots;  ///< Constructed where the control byte is full.
+    size_type m_capacity;  ///< Zero, or a power of two of at least group_width.
+    size_type m_size;
+    size_type m_growth_left;  ///< Empty slots that can be filled before a rehash.
+    Hash m_hash;
+    Eq m_eq;
+};
+
+} // namespace tg::data::containers
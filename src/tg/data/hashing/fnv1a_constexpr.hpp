@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace tg::data::hashing::fnv1a_detail
+{
+
+constexpr uint64_t FNV1A_INITIAL = UINT64_C(0xCBF29CE484222325);
+constexpr uint64_t FNV1A_PRIME = UINT64_C(0x100000001B3);
+
+/**
+ * @brief Compile-time FNV-1a over a character range. Gives the same result
+ * as fnv1a_char_range(fnv1a_init(), ...).
+ */
+constexpr uint64_t fnv1a_constexpr_chars(std::string_view chars)
+{
+    uint64_t state = FNV1A_INITIAL;
+    for (size_t k = 0u; k < chars.size(); ++k)
+    {
+        state ^= static_cast<uint64_t>(static_cast<uint8_t>(chars[k]));
+        state *= FNV1A_PRIME;
+    }
+    return state;
+}
+
+} // namespace tg::data::hashing::fnv1a_detail
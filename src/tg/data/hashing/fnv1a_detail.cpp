@@ -1,12 +1,10 @@
 #include "common/project_macros.hpp"
 #include "tg/data/hashing/fnv1a_detail.hpp"
+#include "tg/data/hashing/fnv1a_constexpr.hpp"
 
 namespace tg::data::hashing::fnv1a_detail
 {
 
-constexpr uint64_t FNV1A_INITIAL = UINT64_C(0xCBF29CE484222325);
-constexpr uint64_t FNV1A_PRIME = UINT64_C(0x100000001B3);
-
 uint64_t fnv1a_init()
 {
     return FNV1A_INITIAL;
@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "common/project_macros.hpp"
+#include "tg/data/hashing/fnv1a_detail.hpp"
+#include "tg/data/hashing/superfasthash_detail.hpp"
+
+namespace tg::data::hashing
+{
+
+/**
+ * @brief Hashes with the standard library's std::hash, transparently.
+ * @details The default of FlatHashMap and FlatHashSet: on string keys shaped
+ * like data names, std::hash hashes eight bytes per step and beats both
+ * FNV-1a and SuperFastHash on every operation (see --bench-flat-hash). Its
+ * values may differ between standard libraries, so it is only for
+ * in-memory tables; use Fnv1aHasher for hashes that are stored.
+ *
+ * Transparent: a string-keyed container can be searched with a
+ * std::string_view or a C string without constructing a std::string.
+ */
+struct StdHasher
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+
+    std::size_t operator()(const std::string& str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    std::size_t operator()(const char* str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    std::size_t operator()(T value) const
+    {
+        return std::hash<T>{}(value);
+    }
+};
+
+/**
+ * @brief Hashes strings with 64-bit FNV-1a, and integers by their bytes.
+ * @details Stable across platforms and runs. Transparent, like StdHasher.
+ */
+struct Fnv1aHasher
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const
+    {
+        using namespace fnv1a_detail;
+        return static_cast<std::size_t>(fnv1a_char_range(fnv1a_init(), str.data(), str.size()));
+    }
+
+    std::size_t operator()(const std::string& str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    std::size_t operator()(const char* str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    std::size_t operator()(T value) const
+    {
+        using namespace fnv1a_detail;
+        return static_cast<std::size_t>(fnv1a_memory_range(fnv1a_init(), &value, sizeof(value)));
+    }
+};
+
+/**
+ * @brief Hashes strings with 32-bit SuperFastHash, and integers by their
+ * bytes.
+ * @details Reads four bytes per step, faster than FNV-1a on long keys. The
+ * 32-bit result is enough for the FlatHashTable, which mixes it before use.
+ */
+struct SuperFastHasher
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const
+    {
+        using namespace superfasthash_detail;
+        uint32_t state = superfasthash_init(static_cast<uint32_t>(str.size()));
+        state = superfasthash_char_range(state, str.data(), str.size());
+        return static_cast<std::size_t>(superfasthash_close(state));
+    }
+
+    std::size_t operator()(const std::string& str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    std::size_t operator()(const char* str) const
+    {
+        return (*this)(std::string_view{str});
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    std::size_t operator()(T value) const
+    {
+        using namespace superfasthash_detail;
+        uint32_t state = superfasthash_init(static_cast<uint32_t>(sizeof(value)));
+        state = superfasthash_char_range(state, reinterpret_cast<const char*>(&value), sizeof(value));
+        return static_cast<std::size_t>(superfasthash_close(state));
+    }
+};
+
+/**
+ * @brief Finalizes a hash into 64 well-mixed bits (the murmur3 fmix64).
+ * @details Hashers with weak high or low bits, such as an identity hash of
+ * integers, are safe to use once mixed.
+ */
+constexpr uint64_t INLINE_ALWAYS mix_64(uint64_t value)
+{
+    value ^= value >> 33u;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33u;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33u;
+    return value;
+}
+
+} // namespace tg::data::hashing
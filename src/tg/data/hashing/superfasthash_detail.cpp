@@ -57,7 +57,7 @@ superfasthash_char_range(uint32_t state, const char* pchars, size_t sz)
             pchars[ofs + 2u], pchars[ofs + 3u]);
         ofs += 4u;
     }
-    switch ((ofs + 4u - sz) & 3u)
+    switch (sz - ofs)
     {
         case 0u:
             break;
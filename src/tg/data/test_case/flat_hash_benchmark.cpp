@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "tg/data/test_case/flat_hash_benchmark.hpp"
+#include "tg/data/containers/flat_hash_map.hpp"
+#include "tg/data/containers/flat_hash_set.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t key_count = 100000u;
+constexpr int repeats = 5;
+
+struct Timings
+{
+    double insert_ns = 0.0;
+    double hit_ns = 0.0;
+    double miss_ns = 0.0;
+    double erase_ns = 0.0;
+};
+
+double ns_per_op(Clock::time_point start, std::size_t count)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return static_cast<double>(elapsed.count()) / static_cast<double>(count);
+}
+
+/**
+ * @brief Keys shaped like the qualified data names of a large graph.
+ */
+std::vector<std::string> make_keys(const char* prefix, std::size_t count)
+{
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t k = 0u; k < count; ++k)
+    {
+        keys.push_back(std::string{prefix} + "/tile_" + std::to_string(k % 97u) + "/data_" +
+            std::to_string(k));
+    }
+    return keys;
+}
+
+/**
+ * @details Takes the best of several runs. The checksum keeps the lookups
+ * from being optimized away, and must agree between containers.
+ */
+template <typename Set>
+Timings time_set(const std::vector<std::string>& keys, const std::vector<std::string>& misses,
+    std::size_t& out_checksum)
+{
+    Timings best{1e30, 1e30, 1e30, 1e30};
+    for (int run = 0; run < repeats; ++run)
+    {
+        Set set;
+        std::size_t checksum = 0u;
+        auto start = Clock::now();
+        for (const auto& key : keys)
+        {
+            set.insert(key);
+        }
+        best.insert_ns = std::min(best.insert_ns, ns_per_op(start, keys.size()));
+        start = Clock::now();
+        for (const auto& key : keys)
+        {
+            checksum += set.count(key);
+        }
+        best.hit_ns = std::min(best.hit_ns, ns_per_op(start, keys.size()));
+        start = Clock::now();
+        for (const auto& key : misses)
+        {
+            checksum += set.count(key);
+        }
+        best.miss_ns = std::min(best.miss_ns, ns_per_op(start, misses.size()));
+        start = Clock::now();
+        for (const auto& key : keys)
+        {
+            checksum += set.erase(key);
+        }
+        best.erase_ns = std::min(best.erase_ns, ns_per_op(start, keys.size()));
+        out_checksum = checksum + set.size();
+    }
+    return best;
+}
+
+template <typename Map>
+Timings time_map(const std::vector<std::string>& keys, const std::vector<std::string>& misses,
+    std::size_t& out_checksum)
+{
+    Timings best{1e30, 1e30, 1e30, 1e30};
+    for (int run = 0; run < repeats; ++run)
+    {
+        Map map;
+        std::size_t checksum = 0u;
+        auto start = Clock::now();
+        int index = 0;
+        for (const auto& key : keys)
+        {
+            map.try_emplace(key, index++);
+        }
+        best.insert_ns = std::min(best.insert_ns, ns_per_op(start, keys.size()));
+        start = Clock::now();
+        for (const auto& key : keys)
+        {
+            checksum += static_cast<std::size_t>(map.find(key)->second);
+        }
+        best.hit_ns = std::min(best.hit_ns, ns_per_op(start, keys.size()));
+        start = Clock::now();
+        for (const auto& key : misses)
+        {
+            checksum += map.count(key);
+        }
+        best.miss_ns = std::min(best.miss_ns, ns_per_op(start, misses.size()));
+        start = Clock::now();
+        for (const auto& key : keys)
+        {
+            checksum += map.erase(key);
+        }
+        best.erase_ns = std::min(best.erase_ns, ns_per_op(start, keys.size()));
+        out_checksum = checksum + map.size();
+    }
+    return best;
+}
+
+void print_row(const char* name, const Timings& timings, std::size_t checksum)
+{
+    std::printf("%-40s %8.1f %8.1f %8.1f %8.1f  %zu\n", name, timings.insert_ns, timings.hit_ns,
+        timings.miss_ns, timings.erase_ns, checksum);
+}
+
+} // namespace
+
+void flat_hash_benchmark()
+{
+    using namespace tg::data::containers;
+    using namespace tg::data::hashing;
+    auto keys = make_keys("graph", key_count);
+    auto misses = make_keys("other", key_count);
+    std::size_t checksum = 0u;
+
+    std::printf("%zu keys, best of %d runs, ns per operation\n", key_count, repeats);
+    std::printf("%-40s %8s %8s %8s %8s  %s\n", "container", "insert", "hit", "miss", "erase", "checksum");
+    auto timings = time_set<std::unordered_set<std::string>>(keys, misses, checksum);
+    print_row("std::unordered_set<string>", timings, checksum);
+    timings = time_set<std::unordered_set<std::string, Fnv1aHasher>>(keys, misses, checksum);
+    print_row("std::unordered_set<string, Fnv1a>", timings, checksum);
+    timings = time_set<FlatHashSet<std::string, Fnv1aHasher>>(keys, misses, checksum);
+    print_row("FlatHashSet<string, Fnv1a>", timings, checksum);
+    timings = time_set<FlatHashSet<std::string, SuperFastHasher>>(keys, misses, checksum);
+    print_row("FlatHashSet<string, SuperFast>", timings, checksum);
+    timings = time_set<FlatHashSet<std::string, StdHasher>>(keys, misses, checksum);
+    print_row("FlatHashSet<string, StdHasher>", timings, checksum);
+
+    timings = time_map<std::unordered_map<std::string, int>>(keys, misses, checksum);
+    print_row("std::unordered_map<string, int>", timings, checksum);
+    timings = time_map<FlatHashMap<std::string, int, Fnv1aHasher>>(keys, misses, checksum);
+    print_row("FlatHashMap<string, int, Fnv1a>", timings, checksum);
+    timings = time_map<FlatHashMap<std::string, int, SuperFastHasher>>(keys, misses, checksum);
+    print_row("FlatHashMap<string, int, SuperFast>", timings, checksum);
+    timings = time_map<FlatHashMap<std::string, int, StdHasher>>(keys, misses, checksum);
+    print_row("FlatHashMap<string, int, StdHasher>", timings, checksum);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * @brief Times FlatHashSet and FlatHashMap against std::unordered_set and
+ * std::unordered_map, on string keys shaped like data names, and prints a
+ * table of nanoseconds per operation.
+ */
+void flat_hash_benchmark();
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "tg/data/test_case/flat_hash_check.hpp"
+#include "tg/data/containers/flat_hash_map.hpp"
+#include "tg/data/containers/flat_hash_set.hpp"
+
+namespace
+{
+
+using FlatSet = tg::data::containers::FlatHashSet<std::string>;
+using FlatMap = tg::data::containers::FlatHashMap<int, int>;
+using ReferenceSet = std::unordered_set<std::string>;
+using ReferenceMap = std::unordered_map<int, int>;
+
+/**
+ * @return The number of differences: entries missing from either side,
+ * and a size that disagrees with the entries iterated.
+ */
+std::size_t compare(const FlatSet& set, const ReferenceSet& reference)
+{
+    std::size_t mismatches = (set.size() == reference.size()) ? 0u : 1u;
+    std::size_t visited = 0u;
+    for (const auto& key : set)
+    {
+        ++visited;
+        mismatches += reference.count(key) == 1u ? 0u : 1u;
+    }
+    for (const auto& key : reference)
+    {
+        mismatches += set.contains(key) ? 0u : 1u;
+    }
+    return mismatches + (visited == set.size() ? 0u : 1u);
+}
+
+std::size_t compare(const FlatMap& map, const ReferenceMap& reference)
+{
+    std::size_t mismatches = (map.size() == reference.size()) ? 0u : 1u;
+    std::size_t visited = 0u;
+    for (const auto& [key, value] : map)
+    {
+        ++visited;
+        auto found = reference.find(key);
+        mismatches += (found != reference.end() && found->second == value) ? 0u : 1u;
+    }
+    for (const auto& [key, value] : reference)
+    {
+        auto found = map.find(key);
+        mismatches += (found != map.end() && found->second == value) ? 0u : 1u;
+    }
+    return mismatches + (visited == map.size() ? 0u : 1u);
+}
+
+/**
+ * @brief Random inserts and erases over a small key range, so that most
+ * inserts hit a key erased earlier, and deleted slots are reused.
+ */
+std::size_t check_random_churn(std::mt19937& random, std::size_t& operations)
+{
+    constexpr int key_range = 300;
+    constexpr int steps = 200000;
+    FlatSet set;
+    ReferenceSet reference;
+    std::size_t mismatches = 0u;
+    std::uniform_int_distribution<int> pick_key(0, key_range - 1);
+    for (int step = 0; step < steps; ++step)
+    {
+        std::string key = "graph/tile_" + std::to_string(pick_key(random));
+        if (random() % 2u == 0u)
+        {
+            mismatches += (set.insert(key).second == reference.insert(key).second) ? 0u : 1u;
+        }
+        else
+        {
+            mismatches += (set.erase(key) == reference.erase(key)) ? 0u : 1u;
+        }
+        if (step % 1000 == 0)
+        {
+            mismatches += compare(set, reference);
+        }
+    }
+    operations += steps;
+    return mismatches + compare(set, reference);
+}
+
+/**
+ * @brief A sliding window of distinct keys: every step erases the oldest
+ * entry and inserts a new one. The size stays constant while deleted slots
+ * pile up, which the table must reclaim by rehashing in place rather than
+ * by growing.
+ * @param out_capacity The capacity at the end.
+ */
+std::size_t check_sliding_window(std::size_t& operations, std::size_t& out_capacity)
+{
+    constexpr int window = 100;
+    constexpr int steps = 100000;
+    FlatMap map;
+    ReferenceMap reference;
+    std::size_t mismatches = 0u;
+    for (int key = 0; key < steps; ++key)
+    {
+        map.try_emplace(key, key * 3);
+        reference.emplace(key, key * 3);
+        if (key >= window)
+        {
+            mismatches += (map.erase(key - window) == reference.erase(key - window)) ? 0u : 1u;
+        }
+    }
+    operations += 2u * steps;
+    out_capacity = map.capacity();
+    return mismatches + compare(map, reference);
+}
+
+/**
+ * @brief Erases through iterators while iterating, then copies and moves
+ * the table, comparing each result with the reference.
+ */
+std::size_t check_erase_copy_move(std::mt19937& random, std::size_t& operations)
+{
+    FlatMap map;
+    ReferenceMap reference;
+    std::uniform_int_distribution<int> pick_key(0, 1 << 20);
+    for (int k = 0; k < 5000; ++k)
+    {
+        int key = pick_key(random);
+        map.try_emplace(key, k);
+        reference.emplace(key, k);
+    }
+    for (auto iter = map.begin(); iter != map.end();)
+    {
+        iter = (iter->first % 2 != 0) ? map.erase(iter) : std::next(iter);
+    }
+    for (auto iter = reference.begin(); iter != reference.end();)
+    {
+        iter = (iter->first % 2 != 0) ? reference.erase(iter) : std::next(iter);
+    }
+    std::size_t mismatches = compare(map, reference);
+
+    FlatMap copied{map};
+    mismatches += compare(copied, reference);
+    FlatMap assigned;
+    assigned.try_emplace(-1, -1);
+    assigned = copied;
+    mismatches += compare(assigned, reference);
+    FlatMap moved{std::move(copied)};
+    mismatches += compare(moved, reference);
+    FlatMap move_assigned;
+    move_assigned.try_emplace(-1, -1);
+    move_assigned = std::move(moved);
+    mismatches += compare(move_assigned, reference);
+
+    /**
+     * @note A moved-from table is empty, and usable.
+     */
+    mismatches += copied.empty() ? 0u : 1u;
+    copied.try_emplace(7, 7);
+    mismatches += compare(copied, ReferenceMap{{7, 7}});
+    operations += 10000u + reference.size() * 4u;
+    return mismatches;
+}
+
+} // namespace
+
+void flat_hash_check()
+{
+    std::mt19937 random{12345u};
+    std::size_t operations = 0u;
+    std::size_t window_capacity = 0u;
+    std::size_t mismatches = check_random_churn(random, operations);
+    mismatches += check_sliding_window(operations, window_capacity);
+    mismatches += check_erase_copy_move(random, operations);
+    /**
+     * @note 100 live entries fit in 256 slots: more would mean the deleted
+     * slots were not reclaimed.
+     */
+    mismatches += (window_capacity <= 256u) ? 0u : 1u;
+    std::cout << "Flat hash check operations: " << operations
+        << ", mismatches: " << mismatches
+        << ", sliding window capacity: " << window_capacity << std::endl;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * @brief Checks FlatHashSet and FlatHashMap against std::unordered_set and
+ * std::unordered_map under randomized inserts and erases, and prints the
+ * number of mismatches found, which should be zero.
+ */
+void flat_hash_check();
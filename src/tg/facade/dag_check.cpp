@@ -0,0 +1,432 @@
+#include <algorithm>
+#include "tg/data/containers/flat_hash_map.hpp"
+#include "tg/facade/dag_check.hpp"
+
+namespace tg::facade
+{
+
+namespace
+{
+
+using NameIds = tg::data::containers::FlatHashMap<std::string_view, std::uint32_t>;
+
+constexpr std::uint32_t start_node = 0u;
+constexpr std::uint32_t stop_node = 1u;
+
+inline bool test_bit(const std::vector<std::uint64_t>& bits, std::uint32_t k)
+{
+    return (bits[k >> 6] >> (k & 63u)) & 1u;
+}
+
+inline void set_bit(std::vector<std::uint64_t>& bits, std::uint32_t k)
+{
+    bits[k >> 6] |= (std::uint64_t{1u} << (k & 63u));
+}
+
+const char* kind_name(NodeKind kind)
+{
+    switch (kind)
+    {
+        case NodeKind::Start: return "start";
+        case NodeKind::Stop: return "stop";
+        case NodeKind::Data: return "data";
+        case NodeKind::Task: return "task";
+        case NodeKind::Barrier: return "barrier";
+    }
+    return "node";
+}
+
+} // namespace
+
+DagCheck::DagCheck(const Subgraph& subgraph)
+    : m_kinds{}
+    , m_names{}
+    , m_out_begin{}
+    , m_out{}
+    , m_multi_producer{}
+    , m_unknown{}
+    , m_reached{}
+    , m_acyclic{}
+    , m_reached_without_barriers{}
+    , m_passed{false}
+{
+    this->add_node(NodeKind::Start, "global start");
+    this->add_node(NodeKind::Stop, "global stop");
+    m_kinds.reserve(2u + subgraph.data_names().size() + subgraph.task_names().size() +
+        subgraph.barrier_names().size());
+    m_names.reserve(m_kinds.capacity());
+    NameIds data_ids;
+    NameIds task_ids;
+    NameIds barrier_ids;
+    data_ids.reserve(subgraph.data_names().size());
+    task_ids.reserve(subgraph.task_names().size());
+    for (const auto& name : subgraph.data_names())
+    {
+        data_ids.try_emplace(name, this->add_node(NodeKind::Data, name));
+    }
+    for (const auto& name : subgraph.task_names())
+    {
+        task_ids.try_emplace(name, this->add_node(NodeKind::Task, name));
+    }
+    for (const auto& name : subgraph.barrier_names())
+    {
+        barrier_ids.try_emplace(name, this->add_node(NodeKind::Barrier, name));
+    }
+    auto lookup = [this](const NameIds& ids,
+        const std::string& name, const char* kind, std::uint32_t& out_id)
+    {
+        auto iter = ids.find(name);
+        if (iter == ids.end())
+        {
+            m_unknown.push_back(std::string{kind} + " '" + name + "'");
+            return false;
+        }
+        out_id = iter->second;
+        return true;
+    };
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+    edges.reserve(subgraph.edges().size() + subgraph.global_inputs().size() +
+        subgraph.global_outputs().size() + 1u);
+    edges.emplace_back(start_node, stop_node);
+    for (const auto& name : subgraph.global_inputs())
+    {
+        edges.emplace_back(start_node, data_ids.at(name));
+    }
+    for (const auto& name : subgraph.global_outputs())
+    {
+        edges.emplace_back(data_ids.at(name), stop_node);
+    }
+    for (const auto& edge : subgraph.edges())
+    {
+        std::uint32_t from = 0u;
+        std::uint32_t to = 0u;
+        bool known = false;
+        switch (edge.etype)
+        {
+            case EdgeType::DataToTask:
+                known = lookup(data_ids, edge.from_name, "data", from) &&
+                    lookup(task_ids, edge.to_name, "task", to);
+                break;
+            case EdgeType::TaskToData:
+                known = lookup(task_ids, edge.from_name, "task", from) &&
+                    lookup(data_ids, edge.to_name, "data", to);
+                break;
+            case EdgeType::TaskToBarrier:
+                known = lookup(task_ids, edge.from_name, "task", from) &&
+                    lookup(barrier_ids, edge.to_name, "barrier", to);
+                break;
+            case EdgeType::BarrierToTask:
+                known = lookup(barrier_ids, edge.from_name, "barrier", from) &&
+                    lookup(task_ids, edge.to_name, "task", to);
+                break;
+            case EdgeType::None:
+                break;
+        }
+        if (known)
+        {
+            edges.emplace_back(from, to);
+        }
+    }
+    this->build_adjacency(edges);
+
+    /**
+     * @note Data nodes accept a single inflow: from one producing task, or
+     * from the global start node for a global input.
+     */
+    std::vector<std::uint32_t> inflows(m_kinds.size(), 0u);
+    for (const auto& edge : edges)
+    {
+        inflows[edge.second] += 1u;
+    }
+    for (std::uint32_t node = 0u; node < m_kinds.size(); ++node)
+    {
+        if (m_kinds[node] == NodeKind::Data && inflows[node] > 1u)
+        {
+            m_multi_producer.push_back(node);
+        }
+    }
+
+    m_reached = this->visit(true, false);
+    m_acyclic = this->visit(false, false);
+    m_reached_without_barriers = this->visit(true, true);
+
+    const std::size_t word_count = m_reached.size();
+    bool all_reached = true;
+    bool all_acyclic = true;
+    bool barriers_inert = true;
+    for (std::size_t w = 0u; w < word_count; ++w)
+    {
+        std::uint64_t valid = (w + 1u < word_count || (m_kinds.size() & 63u) == 0u)
+            ? ~std::uint64_t{0u}
+            : ((std::uint64_t{1u} << (m_kinds.size() & 63u)) - 1u);
+        all_reached = all_reached && (m_reached[w] == valid);
+        all_acyclic = all_acyclic && (m_acyclic[w] == valid);
+    }
+    for (std::uint32_t node = 0u; node < m_kinds.size() && barriers_inert; ++node)
+    {
+        if (m_kinds[node] != NodeKind::Barrier)
+        {
+            barriers_inert = (test_bit(m_reached, node) == test_bit(m_reached_without_barriers, node));
+        }
+    }
+    m_passed = m_unknown.empty() && m_multi_producer.empty() &&
+        all_reached && all_acyclic && barriers_inert;
+}
+
+std::uint32_t DagCheck::add_node(NodeKind kind, std::string_view name)
+{
+    auto id = static_cast<std::uint32_t>(m_kinds.size());
+    m_kinds.push_back(kind);
+    m_names.push_back(name);
+    return id;
+}
+
+void DagCheck::build_adjacency(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges)
+{
+    const std::size_t node_count = m_kinds.size();
+    m_out_begin.assign(node_count + 1u, 0u);
+    for (const auto& edge : edges)
+    {
+        m_out_begin[edge.first + 1u] += 1u;
+    }
+    for (std::size_t node = 0u; node < node_count; ++node)
+    {
+        m_out_begin[node + 1u] += m_out_begin[node];
+    }
+    m_out.resize(edges.size());
+    std::vector<std::uint32_t> cursor(m_out_begin.begin(), m_out_begin.end() - 1);
+    for (const auto& edge : edges)
+    {
+        m_out[cursor[edge.first]++] = edge.second;
+    }
+}
+
+DagCheck::Bitset DagCheck::visit(bool from_start, bool ignore_barriers) const
+{
+    const auto node_count = static_cast<std::uint32_t>(m_kinds.size());
+    auto skipped = [&](std::uint32_t node)
+    {
+        return ignore_barriers && m_kinds[node] == NodeKind::Barrier;
+    };
+    std::vector<std::uint32_t> pending(node_count, 0u);
+    for (std::uint32_t node = 0u; node < node_count; ++node)
+    {
+        if (skipped(node))
+        {
+            continue;
+        }
+        for (std::uint32_t e = m_out_begin[node]; e < m_out_begin[node + 1u]; ++e)
+        {
+            pending[m_out[e]] += 1u;
+        }
+    }
+    Bitset done((node_count + 63u) / 64u, 0u);
+    std::vector<std::uint32_t> frontier;
+    frontier.reserve(node_count);
+    if (from_start)
+    {
+        frontier.push_back(start_node);
+    }
+    else
+    {
+        for (std::uint32_t node = 0u; node < node_count; ++node)
+        {
+            if (pending[node] == 0u && !skipped(node))
+            {
+                frontier.push_back(node);
+            }
+        }
+    }
+    for (std::size_t k = 0u; k < frontier.size(); ++k)
+    {
+        std::uint32_t node = frontier[k];
+        set_bit(done, node);
+        for (std::uint32_t e = m_out_begin[node]; e < m_out_begin[node + 1u]; ++e)
+        {
+            std::uint32_t next = m_out[e];
+            if (--pending[next] == 0u && !skipped(next))
+            {
+                frontier.push_back(next);
+            }
+        }
+    }
+    return done;
+}
+
+std::string DagCheck::describe(std::uint32_t node) const
+{
+    return std::string{kind_name(m_kinds[node])} + " '" + std::string{m_names[node]} + "'";
+}
+
+std::vector<std::uint32_t> DagCheck::find_cycle() const
+{
+    /**
+     * @note Every node left over by the cycle pass has an inflow from
+     * another left-over node, so walking inflows backwards must revisit a
+     * node; the walk from that node on is a cycle.
+     */
+    const auto node_count = static_cast<std::uint32_t>(m_kinds.size());
+    std::vector<std::uint32_t> in_begin(node_count + 1u, 0u);
+    for (std::uint32_t e = 0u; e < m_out.size(); ++e)
+    {
+        in_begin[m_out[e] + 1u] += 1u;
+    }
+    for (std::uint32_t node = 0u; node < node_count; ++node)
+    {
+        in_begin[node + 1u] += in_begin[node];
+    }
+    std::vector<std::uint32_t> in(m_out.size());
+    std::vector<std::uint32_t> cursor(in_begin.begin(), in_begin.end() - 1);
+    for (std::uint32_t node = 0u; node < node_count; ++node)
+    {
+        for (std::uint32_t e = m_out_begin[node]; e < m_out_begin[node + 1u]; ++e)
+        {
+            in[cursor[m_out[e]]++] = node;
+        }
+    }
+    std::uint32_t node = 0u;
+    while (node < node_count && test_bit(m_acyclic, node))
+    {
+        ++node;
+    }
+    std::vector<std::uint32_t> walk;
+    std::vector<std::uint32_t> position(node_count, node_count);
+    while (node < node_count && position[node] == node_count)
+    {
+        position[node] = static_cast<std::uint32_t>(walk.size());
+        walk.push_back(node);
+        std::uint32_t prev = node_count;
+        for (std::uint32_t e = in_begin[node]; e < in_begin[node + 1u]; ++e)
+        {
+            if (!test_bit(m_acyclic, in[e]))
+            {
+                prev = in[e];
+                break;
+            }
+        }
+        node = prev;
+    }
+    if (node >= node_count)
+    {
+        return {};
+    }
+    std::vector<std::uint32_t> cycle(walk.begin() + position[node], walk.end());
+    std::reverse(cycle.begin(), cycle.end());
+    return cycle;
+}
+
+std::vector<std::string> DagCheck::diagnostics() const
+{
+    std::vector<std::string> result;
+    if (m_passed)
+    {
+        return result;
+    }
+    for (const auto& unknown : m_unknown)
+    {
+        result.push_back("edge refers to unknown " + unknown);
+    }
+    for (std::uint32_t node : m_multi_producer)
+    {
+        std::string message = this->describe(node) + " has more than one producer:";
+        for (std::uint32_t from = 0u; from < m_kinds.size(); ++from)
+        {
+            for (std::uint32_t e = m_out_begin[from]; e < m_out_begin[from + 1u]; ++e)
+            {
+                if (m_out[e] == node)
+                {
+                    message += " " + this->describe(from);
+                }
+            }
+        }
+        result.push_back(message);
+    }
+    auto cycle = this->find_cycle();
+    if (!cycle.empty())
+    {
+        std::string message = "cycle:";
+        for (std::uint32_t node : cycle)
+        {
+            message += " " + this->describe(node) + " ->";
+        }
+        message += " " + this->describe(cycle.front());
+        result.push_back(message);
+    }
+    if (!test_bit(m_reached, stop_node))
+    {
+        std::string message = "global stop is not reached; unreached global outputs:";
+        for (std::uint32_t from = 0u; from < m_kinds.size(); ++from)
+        {
+            for (std::uint32_t e = m_out_begin[from]; e < m_out_begin[from + 1u]; ++e)
+            {
+                if (m_out[e] == stop_node && !test_bit(m_reached, from))
+                {
+                    message += " " + this->describe(from);
+                }
+            }
+        }
+        result.push_back(message);
+    }
+    std::vector<std::uint32_t> unreached_inflows(m_kinds.size(), 0u);
+    for (std::uint32_t from = 0u; from < m_kinds.size(); ++from)
+    {
+        if (test_bit(m_reached, from))
+        {
+            continue;
+        }
+        for (std::uint32_t e = m_out_begin[from]; e < m_out_begin[from + 1u]; ++e)
+        {
+            unreached_inflows[m_out[e]] += 1u;
+        }
+    }
+    for (std::uint32_t node = 0u; node < m_kinds.size(); ++node)
+    {
+        if (test_bit(m_reached, node) || node == stop_node || !test_bit(m_acyclic, node))
+        {
+            continue;
+        }
+        if (unreached_inflows[node] == 0u)
+        {
+            /**
+             * @note Only report the roots of unreached regions; the nodes
+             * downstream of them are unreached as a consequence.
+             */
+            result.push_back(this->describe(node) + " is not reached: it has no inflow" +
+                (m_kinds[node] == NodeKind::Data ? " (neither produced nor a global input)" : ""));
+        }
+    }
+    /**
+     * @note A barrier is essential if ignoring it changes whether any other
+     * node is reached, in either direction: a node reached only through a
+     * barrier, or a node that a barrier keeps from being reached.
+     */
+    std::vector<std::string> feeding_barriers(m_kinds.size());
+    for (std::uint32_t from = 0u; from < m_kinds.size(); ++from)
+    {
+        if (m_kinds[from] != NodeKind::Barrier)
+        {
+            continue;
+        }
+        for (std::uint32_t e = m_out_begin[from]; e < m_out_begin[from + 1u]; ++e)
+        {
+            feeding_barriers[m_out[e]] += " " + this->describe(from);
+        }
+    }
+    for (std::uint32_t node = 0u; node < m_kinds.size(); ++node)
+    {
+        bool reached = test_bit(m_reached, node);
+        if (m_kinds[node] == NodeKind::Barrier || reached == test_bit(m_reached_without_barriers, node))
+        {
+            continue;
+        }
+        std::string message = this->describe(node) + (reached ?
+            " is only reached through barriers; " : " is only reached when barriers are ignored; ");
+        message += feeding_barriers[node].empty() ? std::string{"no barrier feeds it directly"} :
+            "fed by" + feeding_barriers[node];
+        result.push_back(message);
+    }
+    return result;
+}
+
+} // namespace tg::facade
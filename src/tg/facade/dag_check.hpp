@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tg/facade/subgraph.hpp"
+
+namespace tg::facade
+{
+
+enum class NodeKind : std::uint8_t
+{
+    Start = 0,
+    Stop = 1,
+    Data = 2,
+    Task = 3,
+    Barrier = 4
+};
+
+/**
+ * @brief Validates that a subgraph forms a DAG that can run to completion.
+ *
+ * @details
+ * Implements docs/previous_designs/design_dag_check.md. Node names are
+ * interned once into integer ids (global start is 0, global stop is 1), and
+ * the edges are stored as compact adjacency arrays. The checks are:
+ *
+ * - every edge refers to a known node;
+ * - each data node has at most one inflow (single producer);
+ * - reachability from the global start node, where a node is reached once
+ *   all of its inflows are reached (Kahn's algorithm); every node, and the
+ *   global stop node in particular, must be reached;
+ * - cycle detection, by running the same algorithm from every node without
+ *   inflow: the nodes left over are on, or downstream of, a cycle;
+ * - barrier nodes must not be essential: ignoring all barriers must not
+ *   change the set of reached nodes.
+ *
+ * Each pass is linear in the number of nodes and edges, and the sets of
+ * reached nodes are bitsets. Human-readable diagnostics are only computed
+ * when diagnostics() is called on a graph that failed.
+ *
+ * @note Node names are not copied; the subgraph must outlive the DagCheck.
+ */
+class DagCheck
+{
+public:
+    explicit DagCheck(const Subgraph& subgraph);
+
+    bool passed() const { return m_passed; }
+
+    std::size_t node_count() const { return m_kinds.size(); }
+
+    /**
+     * @brief Describes each failure, naming the nodes involved.
+     * @details Empty if the check passed.
+     */
+    std::vector<std::string> diagnostics() const;
+
+private:
+    using Bitset = std::vector<std::uint64_t>;
+
+    std::uint32_t add_node(NodeKind kind, std::string_view name);
+    void build_adjacency(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges);
+
+    /**
+     * @brief Kahn's algorithm. Returns the set of completed nodes.
+     * @param from_start Seed with the global start node only; otherwise,
+     * seed with every node without inflow.
+     * @param ignore_barriers Drop barrier nodes and their edges.
+     */
+    Bitset visit(bool from_start, bool ignore_barriers) const;
+
+    std::string describe(std::uint32_t node) const;
+    std::vector<std::uint32_t> find_cycle() const;
+
+private:
+    std::vector<NodeKind> m_kinds;
+    std::vector<std::string_view> m_names;  ///< Views into the subgraph.
+    std::vector<std::uint32_t> m_out_begin;  ///< Size node_count + 1.
+    std::vector<std::uint32_t> m_out;
+    std::vector<std::uint32_t> m_multi_producer;
+    std::vector<std::string> m_unknown;
+    Bitset m_reached;
+    Bitset m_acyclic;
+    Bitset m_reached_without_barriers;
+    bool m_passed;
+};
+
+} // namespace tg::facade
@@ -1,7 +1,8 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <unordered_set>
+
+#include "tg/data/containers/flat_hash_set.hpp"
 
 namespace tg::facade
 {
@@ -22,7 +23,7 @@ struct DataNameHash
 {
     std::size_t operator()(const DataName& dataName) const
     {
-        return std::hash<std::string>()(dataName.name);
+        return tg::data::hashing::StdHasher{}(dataName.name);
     }
 };
 
@@ -37,7 +38,7 @@ struct DataNameEqual
 class TaskInfo
 {
 public:
-    using DataNameSet = std::unordered_set<DataName, DataNameHash, DataNameEqual>;
+    using DataNameSet = tg::data::containers::FlatHashSet<DataName, DataNameHash, DataNameEqual>;
     const std::string name;
     DataNameSet inputs;
     DataNameSet outputs;
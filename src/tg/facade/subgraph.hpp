@@ -1,7 +1,9 @@
 #pragma once
+#include <iterator>
 #include <string>
 #include <vector>
-#include <unordered_set>
+
+#include "tg/data/containers/flat_hash_set.hpp"
 
 #include "tg/facade/facade_common.hpp"
 
@@ -12,7 +14,9 @@ enum class EdgeType
 {
     None = 0,
     DataToTask = 1,
-    TaskToData = 2
+    TaskToData = 2,
+    TaskToBarrier = 3,
+    BarrierToTask = 4
 };
 
 struct EdgeInfo
@@ -25,6 +29,8 @@ struct EdgeInfo
 class Subgraph
 {
 public:
+    using NameSet = tg::data::containers::FlatHashSet<std::string>;
+
     const std::string name;
     explicit Subgraph(const std::string& name, std::initializer_list<TaskInfo> tasks)
         : name{name}
@@ -50,10 +56,99 @@ public:
         }
     }
 
+    /**
+     * @brief Declares a global input: a data node populated before the
+     * graph starts, fed by the global start node.
+     */
+    void add_global_input(const DataName& data)
+    {
+        m_data_names.insert(data.name);
+        m_global_inputs.push_back(data.name);
+    }
+
+    /**
+     * @brief Declares a global output: a data node that must be populated
+     * when the graph stops, feeding the global stop node.
+     */
+    void add_global_output(const DataName& data)
+    {
+        m_data_names.insert(data.name);
+        m_global_outputs.push_back(data.name);
+    }
+
+    /**
+     * @brief Adds a barrier node that blocks the tasks in @p after until all
+     * tasks in @p before are done.
+     * @details Barriers regulate the width of execution; they must not be
+     * essential to the graph (see DagCheck).
+     */
+    void add_barrier(const std::string& barrier,
+        std::initializer_list<std::string> before,
+        std::initializer_list<std::string> after)
+    {
+        m_barrier_names.insert(barrier);
+        for (const auto& task : before)
+        {
+            m_edges.push_back({EdgeType::TaskToBarrier, task, barrier});
+        }
+        for (const auto& task : after)
+        {
+            m_edges.push_back({EdgeType::BarrierToTask, barrier, task});
+        }
+    }
+
+    /**
+     * @brief Moves the nodes and edges of a fragment into this subgraph.
+     * @details A subgraph is not thread-safe; to build a large one in
+     * parallel, let each thread fill its own fragment, then merge the
+     * fragments, in a fixed order if the edge order matters.
+     */
+    void merge(Subgraph&& fragment)
+    {
+        merge_names(m_data_names, std::move(fragment.m_data_names));
+        merge_names(m_task_names, std::move(fragment.m_task_names));
+        merge_names(m_barrier_names, std::move(fragment.m_barrier_names));
+        m_edges.insert(m_edges.end(), std::make_move_iterator(fragment.m_edges.begin()),
+            std::make_move_iterator(fragment.m_edges.end()));
+        m_global_inputs.insert(m_global_inputs.end(), fragment.m_global_inputs.begin(),
+            fragment.m_global_inputs.end());
+        m_global_outputs.insert(m_global_outputs.end(), fragment.m_global_outputs.begin(),
+            fragment.m_global_outputs.end());
+        fragment.m_edges.clear();
+        fragment.m_global_inputs.clear();
+        fragment.m_global_outputs.clear();
+    }
+
+    const NameSet& data_names() const { return m_data_names; }
+    const NameSet& task_names() const { return m_task_names; }
+    const NameSet& barrier_names() const { return m_barrier_names; }
+    const std::vector<EdgeInfo>& edges() const { return m_edges; }
+    const std::vector<std::string>& global_inputs() const { return m_global_inputs; }
+    const std::vector<std::string>& global_outputs() const { return m_global_outputs; }
+
+private:
+    static void merge_names(NameSet& names, NameSet&& fragment_names)
+    {
+        if (names.empty())
+        {
+            names = std::move(fragment_names);
+            return;
+        }
+        names.reserve(names.size() + fragment_names.size());
+        for (const auto& name : fragment_names)
+        {
+            names.insert(name);
+        }
+        fragment_names.clear();
+    }
+
 private:
-    std::unordered_set<std::string> m_data_names;
-    std::unordered_set<std::string> m_task_names;
+    NameSet m_data_names;
+    NameSet m_task_names;
+    NameSet m_barrier_names;
     std::vector<EdgeInfo> m_edges;
+    std::vector<std::string> m_global_inputs;
+    std::vector<std::string> m_global_outputs;
 };
 
 } // namespace tg::facade